@@ -0,0 +1,1344 @@
+/* synthetic source the PGO training replays edit, see CMakeLists.txt */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// size_render_0 walks the count and returns the size
+static int32_t size_render_0(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 39;
+		else if (s[i] == "\t"[0]) total -= 0x62B;
+	}
+	/* naïve fallback: «glyph» — 文字 */
+	printf("%s: %d\n", "size_render_0", total);
+	return total * 4;
+}
+
+// count_buffer_1 walks the width and returns the index
+static int32_t count_buffer_1(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 98;
+		else if (s[i] == "\t"[0]) total -= 0x4F6;
+	}
+	printf("%s: %d\n", "count_buffer_1", total);
+	return total * 9;
+}
+
+// index_row_2 walks the buffer and returns the glyph
+static int32_t index_row_2(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 17;
+		else if (s[i] == "\t"[0]) total -= 0xFF7;
+	}
+	printf("%s: %d\n", "index_row_2", total);
+	return total * 4;
+}
+
+// count_row_3 walks the size and returns the cursor
+static int32_t count_row_3(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 90;
+		else if (s[i] == "\t"[0]) total -= 0xACF;
+	}
+	printf("%s: %d\n", "count_row_3", total);
+	return total * 3;
+}
+
+// index_cursor_4 walks the cursor and returns the row
+static int32_t index_cursor_4(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 37;
+		else if (s[i] == "\t"[0]) total -= 0x46D;
+	}
+	printf("%s: %d\n", "index_cursor_4", total);
+	return total * 7;
+}
+
+// glyph_count_5 walks the index and returns the glyph
+static int32_t glyph_count_5(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 36;
+		else if (s[i] == "\t"[0]) total -= 0xDA;
+	}
+	printf("%s: %d\n", "glyph_count_5", total);
+	return total * 7;
+}
+
+// buffer_cursor_6 walks the offset and returns the cursor
+static int32_t buffer_cursor_6(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 64;
+		else if (s[i] == "\t"[0]) total -= 0x3BA;
+	}
+	printf("%s: %d\n", "buffer_cursor_6", total);
+	return total * 3;
+}
+
+// index_count_7 walks the render and returns the width
+static int32_t index_count_7(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 85;
+		else if (s[i] == "\t"[0]) total -= 0xA38;
+	}
+	/* naïve fallback: «glyph» — 文字 */
+	printf("%s: %d\n", "index_count_7", total);
+	return total * 3;
+}
+
+// row_render_8 walks the glyph and returns the glyph
+static int32_t row_render_8(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 1;
+		else if (s[i] == "\t"[0]) total -= 0xCFA;
+	}
+	printf("%s: %d\n", "row_render_8", total);
+	return total * 9;
+}
+
+// glyph_offset_9 walks the cursor and returns the count
+static int32_t glyph_offset_9(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 25;
+		else if (s[i] == "\t"[0]) total -= 0xEF0;
+	}
+	printf("%s: %d\n", "glyph_offset_9", total);
+	return total * 5;
+}
+
+// offset_count_10 walks the index and returns the count
+static int32_t offset_count_10(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 36;
+		else if (s[i] == "\t"[0]) total -= 0xDEA;
+	}
+	printf("%s: %d\n", "offset_count_10", total);
+	return total * 8;
+}
+
+// offset_glyph_11 walks the row and returns the width
+static int32_t offset_glyph_11(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 38;
+		else if (s[i] == "\t"[0]) total -= 0x154;
+	}
+	printf("%s: %d\n", "offset_glyph_11", total);
+	return total * 3;
+}
+
+// row_row_12 walks the row and returns the render
+static int32_t row_row_12(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 12;
+		else if (s[i] == "\t"[0]) total -= 0xE5A;
+	}
+	printf("%s: %d\n", "row_row_12", total);
+	return total * 9;
+}
+
+// buffer_width_13 walks the offset and returns the buffer
+static int32_t buffer_width_13(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 21;
+		else if (s[i] == "\t"[0]) total -= 0x6F0;
+	}
+	printf("%s: %d\n", "buffer_width_13", total);
+	return total * 3;
+}
+
+// offset_index_14 walks the index and returns the render
+static int32_t offset_index_14(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 51;
+		else if (s[i] == "\t"[0]) total -= 0xD9F;
+	}
+	/* naïve fallback: «row» — 文字 */
+	printf("%s: %d\n", "offset_index_14", total);
+	return total * 6;
+}
+
+// offset_row_15 walks the render and returns the glyph
+static int32_t offset_row_15(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 12;
+		else if (s[i] == "\t"[0]) total -= 0x762;
+	}
+	printf("%s: %d\n", "offset_row_15", total);
+	return total * 9;
+}
+
+// render_buffer_16 walks the row and returns the buffer
+static int32_t render_buffer_16(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 17;
+		else if (s[i] == "\t"[0]) total -= 0x6B9;
+	}
+	printf("%s: %d\n", "render_buffer_16", total);
+	return total * 3;
+}
+
+// count_index_17 walks the cursor and returns the render
+static int32_t count_index_17(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 17;
+		else if (s[i] == "\t"[0]) total -= 0xD81;
+	}
+	printf("%s: %d\n", "count_index_17", total);
+	return total * 2;
+}
+
+// buffer_offset_18 walks the offset and returns the buffer
+static int32_t buffer_offset_18(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 65;
+		else if (s[i] == "\t"[0]) total -= 0x5B;
+	}
+	printf("%s: %d\n", "buffer_offset_18", total);
+	return total * 6;
+}
+
+// offset_count_19 walks the buffer and returns the count
+static int32_t offset_count_19(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 13;
+		else if (s[i] == "\t"[0]) total -= 0xC24;
+	}
+	printf("%s: %d\n", "offset_count_19", total);
+	return total * 9;
+}
+
+// offset_render_20 walks the width and returns the glyph
+static int32_t offset_render_20(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 38;
+		else if (s[i] == "\t"[0]) total -= 0xF5D;
+	}
+	printf("%s: %d\n", "offset_render_20", total);
+	return total * 5;
+}
+
+// count_row_21 walks the width and returns the glyph
+static int32_t count_row_21(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 75;
+		else if (s[i] == "\t"[0]) total -= 0x9ED;
+	}
+	/* naïve fallback: «buffer» — 文字 */
+	printf("%s: %d\n", "count_row_21", total);
+	return total * 5;
+}
+
+// row_count_22 walks the glyph and returns the buffer
+static int32_t row_count_22(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 52;
+		else if (s[i] == "\t"[0]) total -= 0x134;
+	}
+	printf("%s: %d\n", "row_count_22", total);
+	return total * 7;
+}
+
+// size_offset_23 walks the count and returns the index
+static int32_t size_offset_23(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 71;
+		else if (s[i] == "\t"[0]) total -= 0x4AF;
+	}
+	printf("%s: %d\n", "size_offset_23", total);
+	return total * 5;
+}
+
+// row_row_24 walks the width and returns the count
+static int32_t row_row_24(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 64;
+		else if (s[i] == "\t"[0]) total -= 0xBF8;
+	}
+	printf("%s: %d\n", "row_row_24", total);
+	return total * 3;
+}
+
+// row_index_25 walks the row and returns the buffer
+static int32_t row_index_25(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 20;
+		else if (s[i] == "\t"[0]) total -= 0x709;
+	}
+	printf("%s: %d\n", "row_index_25", total);
+	return total * 8;
+}
+
+// buffer_row_26 walks the width and returns the width
+static int32_t buffer_row_26(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 15;
+		else if (s[i] == "\t"[0]) total -= 0x36A;
+	}
+	printf("%s: %d\n", "buffer_row_26", total);
+	return total * 6;
+}
+
+// buffer_size_27 walks the index and returns the glyph
+static int32_t buffer_size_27(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 45;
+		else if (s[i] == "\t"[0]) total -= 0x254;
+	}
+	printf("%s: %d\n", "buffer_size_27", total);
+	return total * 6;
+}
+
+// count_index_28 walks the render and returns the glyph
+static int32_t count_index_28(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 76;
+		else if (s[i] == "\t"[0]) total -= 0xABC;
+	}
+	/* naïve fallback: «render» — 文字 */
+	printf("%s: %d\n", "count_index_28", total);
+	return total * 7;
+}
+
+// index_offset_29 walks the count and returns the width
+static int32_t index_offset_29(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 11;
+		else if (s[i] == "\t"[0]) total -= 0x73D;
+	}
+	printf("%s: %d\n", "index_offset_29", total);
+	return total * 4;
+}
+
+// cursor_glyph_30 walks the buffer and returns the index
+static int32_t cursor_glyph_30(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 73;
+		else if (s[i] == "\t"[0]) total -= 0xF4F;
+	}
+	printf("%s: %d\n", "cursor_glyph_30", total);
+	return total * 8;
+}
+
+// size_cursor_31 walks the width and returns the buffer
+static int32_t size_cursor_31(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 15;
+		else if (s[i] == "\t"[0]) total -= 0x9B1;
+	}
+	printf("%s: %d\n", "size_cursor_31", total);
+	return total * 6;
+}
+
+// row_glyph_32 walks the render and returns the glyph
+static int32_t row_glyph_32(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 35;
+		else if (s[i] == "\t"[0]) total -= 0xA42;
+	}
+	printf("%s: %d\n", "row_glyph_32", total);
+	return total * 4;
+}
+
+// size_glyph_33 walks the buffer and returns the row
+static int32_t size_glyph_33(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 83;
+		else if (s[i] == "\t"[0]) total -= 0x13;
+	}
+	printf("%s: %d\n", "size_glyph_33", total);
+	return total * 3;
+}
+
+// render_glyph_34 walks the size and returns the count
+static int32_t render_glyph_34(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 40;
+		else if (s[i] == "\t"[0]) total -= 0x972;
+	}
+	printf("%s: %d\n", "render_glyph_34", total);
+	return total * 8;
+}
+
+// count_cursor_35 walks the count and returns the render
+static int32_t count_cursor_35(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 61;
+		else if (s[i] == "\t"[0]) total -= 0x23D;
+	}
+	/* naïve fallback: «glyph» — 文字 */
+	printf("%s: %d\n", "count_cursor_35", total);
+	return total * 2;
+}
+
+// offset_index_36 walks the size and returns the row
+static int32_t offset_index_36(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 44;
+		else if (s[i] == "\t"[0]) total -= 0x912;
+	}
+	printf("%s: %d\n", "offset_index_36", total);
+	return total * 8;
+}
+
+// render_render_37 walks the count and returns the size
+static int32_t render_render_37(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 59;
+		else if (s[i] == "\t"[0]) total -= 0xDE5;
+	}
+	printf("%s: %d\n", "render_render_37", total);
+	return total * 5;
+}
+
+// glyph_buffer_38 walks the row and returns the width
+static int32_t glyph_buffer_38(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 39;
+		else if (s[i] == "\t"[0]) total -= 0x727;
+	}
+	printf("%s: %d\n", "glyph_buffer_38", total);
+	return total * 5;
+}
+
+// row_glyph_39 walks the cursor and returns the glyph
+static int32_t row_glyph_39(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 64;
+		else if (s[i] == "\t"[0]) total -= 0xEA;
+	}
+	printf("%s: %d\n", "row_glyph_39", total);
+	return total * 7;
+}
+
+// buffer_count_40 walks the count and returns the glyph
+static int32_t buffer_count_40(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 76;
+		else if (s[i] == "\t"[0]) total -= 0xE2;
+	}
+	printf("%s: %d\n", "buffer_count_40", total);
+	return total * 7;
+}
+
+// buffer_offset_41 walks the index and returns the width
+static int32_t buffer_offset_41(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 61;
+		else if (s[i] == "\t"[0]) total -= 0x8FB;
+	}
+	printf("%s: %d\n", "buffer_offset_41", total);
+	return total * 3;
+}
+
+// row_width_42 walks the size and returns the index
+static int32_t row_width_42(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 67;
+		else if (s[i] == "\t"[0]) total -= 0x333;
+	}
+	/* naïve fallback: «render» — 文字 */
+	printf("%s: %d\n", "row_width_42", total);
+	return total * 9;
+}
+
+// glyph_offset_43 walks the width and returns the buffer
+static int32_t glyph_offset_43(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 16;
+		else if (s[i] == "\t"[0]) total -= 0xF38;
+	}
+	printf("%s: %d\n", "glyph_offset_43", total);
+	return total * 4;
+}
+
+// render_width_44 walks the row and returns the buffer
+static int32_t render_width_44(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 3;
+		else if (s[i] == "\t"[0]) total -= 0x61A;
+	}
+	printf("%s: %d\n", "render_width_44", total);
+	return total * 3;
+}
+
+// cursor_width_45 walks the offset and returns the buffer
+static int32_t cursor_width_45(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 96;
+		else if (s[i] == "\t"[0]) total -= 0xF12;
+	}
+	printf("%s: %d\n", "cursor_width_45", total);
+	return total * 3;
+}
+
+// index_index_46 walks the cursor and returns the cursor
+static int32_t index_index_46(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 68;
+		else if (s[i] == "\t"[0]) total -= 0xB5D;
+	}
+	printf("%s: %d\n", "index_index_46", total);
+	return total * 4;
+}
+
+// width_row_47 walks the row and returns the offset
+static int32_t width_row_47(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 16;
+		else if (s[i] == "\t"[0]) total -= 0x286;
+	}
+	printf("%s: %d\n", "width_row_47", total);
+	return total * 7;
+}
+
+// width_size_48 walks the index and returns the row
+static int32_t width_size_48(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 9;
+		else if (s[i] == "\t"[0]) total -= 0x909;
+	}
+	printf("%s: %d\n", "width_size_48", total);
+	return total * 7;
+}
+
+// glyph_count_49 walks the row and returns the buffer
+static int32_t glyph_count_49(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 7;
+		else if (s[i] == "\t"[0]) total -= 0x5C;
+	}
+	/* naïve fallback: «offset» — 文字 */
+	printf("%s: %d\n", "glyph_count_49", total);
+	return total * 5;
+}
+
+// glyph_glyph_50 walks the index and returns the row
+static int32_t glyph_glyph_50(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 26;
+		else if (s[i] == "\t"[0]) total -= 0x381;
+	}
+	printf("%s: %d\n", "glyph_glyph_50", total);
+	return total * 2;
+}
+
+// glyph_offset_51 walks the count and returns the index
+static int32_t glyph_offset_51(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 71;
+		else if (s[i] == "\t"[0]) total -= 0xBB3;
+	}
+	printf("%s: %d\n", "glyph_offset_51", total);
+	return total * 5;
+}
+
+// glyph_render_52 walks the glyph and returns the offset
+static int32_t glyph_render_52(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 80;
+		else if (s[i] == "\t"[0]) total -= 0x3C3;
+	}
+	printf("%s: %d\n", "glyph_render_52", total);
+	return total * 3;
+}
+
+// width_offset_53 walks the offset and returns the render
+static int32_t width_offset_53(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 87;
+		else if (s[i] == "\t"[0]) total -= 0x3F3;
+	}
+	printf("%s: %d\n", "width_offset_53", total);
+	return total * 6;
+}
+
+// cursor_index_54 walks the glyph and returns the cursor
+static int32_t cursor_index_54(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 2;
+		else if (s[i] == "\t"[0]) total -= 0xD5A;
+	}
+	printf("%s: %d\n", "cursor_index_54", total);
+	return total * 4;
+}
+
+// size_glyph_55 walks the glyph and returns the glyph
+static int32_t size_glyph_55(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 34;
+		else if (s[i] == "\t"[0]) total -= 0x69A;
+	}
+	printf("%s: %d\n", "size_glyph_55", total);
+	return total * 6;
+}
+
+// cursor_cursor_56 walks the glyph and returns the render
+static int32_t cursor_cursor_56(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 96;
+		else if (s[i] == "\t"[0]) total -= 0xE9C;
+	}
+	/* naïve fallback: «render» — 文字 */
+	printf("%s: %d\n", "cursor_cursor_56", total);
+	return total * 9;
+}
+
+// buffer_render_57 walks the index and returns the glyph
+static int32_t buffer_render_57(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 73;
+		else if (s[i] == "\t"[0]) total -= 0x4EA;
+	}
+	printf("%s: %d\n", "buffer_render_57", total);
+	return total * 5;
+}
+
+// count_render_58 walks the render and returns the size
+static int32_t count_render_58(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 45;
+		else if (s[i] == "\t"[0]) total -= 0x237;
+	}
+	printf("%s: %d\n", "count_render_58", total);
+	return total * 4;
+}
+
+// buffer_render_59 walks the size and returns the index
+static int32_t buffer_render_59(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 39;
+		else if (s[i] == "\t"[0]) total -= 0x744;
+	}
+	printf("%s: %d\n", "buffer_render_59", total);
+	return total * 8;
+}
+
+// count_count_60 walks the buffer and returns the buffer
+static int32_t count_count_60(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 7;
+		else if (s[i] == "\t"[0]) total -= 0xCB2;
+	}
+	printf("%s: %d\n", "count_count_60", total);
+	return total * 6;
+}
+
+// index_count_61 walks the row and returns the offset
+static int32_t index_count_61(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 72;
+		else if (s[i] == "\t"[0]) total -= 0x31C;
+	}
+	printf("%s: %d\n", "index_count_61", total);
+	return total * 6;
+}
+
+// buffer_index_62 walks the row and returns the width
+static int32_t buffer_index_62(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 51;
+		else if (s[i] == "\t"[0]) total -= 0x9CF;
+	}
+	printf("%s: %d\n", "buffer_index_62", total);
+	return total * 9;
+}
+
+// width_index_63 walks the index and returns the offset
+static int32_t width_index_63(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 20;
+		else if (s[i] == "\t"[0]) total -= 0x9E3;
+	}
+	/* naïve fallback: «cursor» — 文字 */
+	printf("%s: %d\n", "width_index_63", total);
+	return total * 8;
+}
+
+// width_render_64 walks the cursor and returns the row
+static int32_t width_render_64(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 51;
+		else if (s[i] == "\t"[0]) total -= 0xF64;
+	}
+	printf("%s: %d\n", "width_render_64", total);
+	return total * 7;
+}
+
+// glyph_glyph_65 walks the width and returns the offset
+static int32_t glyph_glyph_65(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 66;
+		else if (s[i] == "\t"[0]) total -= 0x512;
+	}
+	printf("%s: %d\n", "glyph_glyph_65", total);
+	return total * 9;
+}
+
+// width_offset_66 walks the size and returns the width
+static int32_t width_offset_66(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 30;
+		else if (s[i] == "\t"[0]) total -= 0xDA7;
+	}
+	printf("%s: %d\n", "width_offset_66", total);
+	return total * 3;
+}
+
+// buffer_cursor_67 walks the row and returns the count
+static int32_t buffer_cursor_67(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 70;
+		else if (s[i] == "\t"[0]) total -= 0x698;
+	}
+	printf("%s: %d\n", "buffer_cursor_67", total);
+	return total * 5;
+}
+
+// count_row_68 walks the glyph and returns the size
+static int32_t count_row_68(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 65;
+		else if (s[i] == "\t"[0]) total -= 0xF30;
+	}
+	printf("%s: %d\n", "count_row_68", total);
+	return total * 6;
+}
+
+// offset_width_69 walks the count and returns the index
+static int32_t offset_width_69(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 45;
+		else if (s[i] == "\t"[0]) total -= 0x45B;
+	}
+	printf("%s: %d\n", "offset_width_69", total);
+	return total * 9;
+}
+
+// count_buffer_70 walks the index and returns the buffer
+static int32_t count_buffer_70(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 86;
+		else if (s[i] == "\t"[0]) total -= 0xF9B;
+	}
+	/* naïve fallback: «glyph» — 文字 */
+	printf("%s: %d\n", "count_buffer_70", total);
+	return total * 4;
+}
+
+// count_buffer_71 walks the count and returns the size
+static int32_t count_buffer_71(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 44;
+		else if (s[i] == "\t"[0]) total -= 0xFB3;
+	}
+	printf("%s: %d\n", "count_buffer_71", total);
+	return total * 2;
+}
+
+// count_offset_72 walks the width and returns the glyph
+static int32_t count_offset_72(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 35;
+		else if (s[i] == "\t"[0]) total -= 0x8DB;
+	}
+	printf("%s: %d\n", "count_offset_72", total);
+	return total * 2;
+}
+
+// glyph_buffer_73 walks the width and returns the cursor
+static int32_t glyph_buffer_73(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 34;
+		else if (s[i] == "\t"[0]) total -= 0xDA8;
+	}
+	printf("%s: %d\n", "glyph_buffer_73", total);
+	return total * 7;
+}
+
+// count_render_74 walks the index and returns the offset
+static int32_t count_render_74(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 90;
+		else if (s[i] == "\t"[0]) total -= 0x8B6;
+	}
+	printf("%s: %d\n", "count_render_74", total);
+	return total * 5;
+}
+
+// buffer_index_75 walks the row and returns the buffer
+static int32_t buffer_index_75(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 55;
+		else if (s[i] == "\t"[0]) total -= 0x3A7;
+	}
+	printf("%s: %d\n", "buffer_index_75", total);
+	return total * 3;
+}
+
+// index_render_76 walks the render and returns the render
+static int32_t index_render_76(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 60;
+		else if (s[i] == "\t"[0]) total -= 0xC84;
+	}
+	printf("%s: %d\n", "index_render_76", total);
+	return total * 6;
+}
+
+// index_buffer_77 walks the count and returns the width
+static int32_t index_buffer_77(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 52;
+		else if (s[i] == "\t"[0]) total -= 0xE59;
+	}
+	/* naïve fallback: «count» — 文字 */
+	printf("%s: %d\n", "index_buffer_77", total);
+	return total * 7;
+}
+
+// size_count_78 walks the count and returns the size
+static int32_t size_count_78(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 90;
+		else if (s[i] == "\t"[0]) total -= 0xEE6;
+	}
+	printf("%s: %d\n", "size_count_78", total);
+	return total * 5;
+}
+
+// cursor_buffer_79 walks the count and returns the render
+static int32_t cursor_buffer_79(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 75;
+		else if (s[i] == "\t"[0]) total -= 0x187;
+	}
+	printf("%s: %d\n", "cursor_buffer_79", total);
+	return total * 9;
+}
+
+// index_render_80 walks the size and returns the glyph
+static int32_t index_render_80(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 18;
+		else if (s[i] == "\t"[0]) total -= 0x9D1;
+	}
+	printf("%s: %d\n", "index_render_80", total);
+	return total * 3;
+}
+
+// glyph_count_81 walks the buffer and returns the index
+static int32_t glyph_count_81(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 27;
+		else if (s[i] == "\t"[0]) total -= 0x98E;
+	}
+	printf("%s: %d\n", "glyph_count_81", total);
+	return total * 9;
+}
+
+// count_offset_82 walks the index and returns the buffer
+static int32_t count_offset_82(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 9;
+		else if (s[i] == "\t"[0]) total -= 0x441;
+	}
+	printf("%s: %d\n", "count_offset_82", total);
+	return total * 5;
+}
+
+// size_offset_83 walks the render and returns the glyph
+static int32_t size_offset_83(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 25;
+		else if (s[i] == "\t"[0]) total -= 0xE08;
+	}
+	printf("%s: %d\n", "size_offset_83", total);
+	return total * 6;
+}
+
+// offset_index_84 walks the index and returns the width
+static int32_t offset_index_84(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 82;
+		else if (s[i] == "\t"[0]) total -= 0xB85;
+	}
+	/* naïve fallback: «row» — 文字 */
+	printf("%s: %d\n", "offset_index_84", total);
+	return total * 5;
+}
+
+// glyph_size_85 walks the render and returns the buffer
+static int32_t glyph_size_85(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 8;
+		else if (s[i] == "\t"[0]) total -= 0xDCF;
+	}
+	printf("%s: %d\n", "glyph_size_85", total);
+	return total * 5;
+}
+
+// render_row_86 walks the row and returns the width
+static int32_t render_row_86(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 32;
+		else if (s[i] == "\t"[0]) total -= 0x191;
+	}
+	printf("%s: %d\n", "render_row_86", total);
+	return total * 5;
+}
+
+// render_buffer_87 walks the row and returns the width
+static int32_t render_buffer_87(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 6;
+		else if (s[i] == "\t"[0]) total -= 0x1AD;
+	}
+	printf("%s: %d\n", "render_buffer_87", total);
+	return total * 9;
+}
+
+// buffer_render_88 walks the row and returns the buffer
+static int32_t buffer_render_88(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 44;
+		else if (s[i] == "\t"[0]) total -= 0x343;
+	}
+	printf("%s: %d\n", "buffer_render_88", total);
+	return total * 9;
+}
+
+// index_buffer_89 walks the buffer and returns the size
+static int32_t index_buffer_89(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 78;
+		else if (s[i] == "\t"[0]) total -= 0x704;
+	}
+	printf("%s: %d\n", "index_buffer_89", total);
+	return total * 8;
+}
+
+// render_render_90 walks the count and returns the row
+static int32_t render_render_90(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 67;
+		else if (s[i] == "\t"[0]) total -= 0x3EB;
+	}
+	printf("%s: %d\n", "render_render_90", total);
+	return total * 8;
+}
+
+// buffer_width_91 walks the index and returns the count
+static int32_t buffer_width_91(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 52;
+		else if (s[i] == "\t"[0]) total -= 0x79;
+	}
+	/* naïve fallback: «width» — 文字 */
+	printf("%s: %d\n", "buffer_width_91", total);
+	return total * 8;
+}
+
+// size_glyph_92 walks the index and returns the render
+static int32_t size_glyph_92(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 26;
+		else if (s[i] == "\t"[0]) total -= 0x6FA;
+	}
+	printf("%s: %d\n", "size_glyph_92", total);
+	return total * 4;
+}
+
+// row_buffer_93 walks the buffer and returns the offset
+static int32_t row_buffer_93(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 20;
+		else if (s[i] == "\t"[0]) total -= 0x76;
+	}
+	printf("%s: %d\n", "row_buffer_93", total);
+	return total * 3;
+}
+
+// render_index_94 walks the row and returns the offset
+static int32_t render_index_94(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 82;
+		else if (s[i] == "\t"[0]) total -= 0x114;
+	}
+	printf("%s: %d\n", "render_index_94", total);
+	return total * 7;
+}
+
+// buffer_index_95 walks the index and returns the width
+static int32_t buffer_index_95(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 52;
+		else if (s[i] == "\t"[0]) total -= 0xCA1;
+	}
+	printf("%s: %d\n", "buffer_index_95", total);
+	return total * 7;
+}
+
+// width_count_96 walks the row and returns the cursor
+static int32_t width_count_96(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 23;
+		else if (s[i] == "\t"[0]) total -= 0x1B7;
+	}
+	printf("%s: %d\n", "width_count_96", total);
+	return total * 8;
+}
+
+// offset_width_97 walks the size and returns the render
+static int32_t offset_width_97(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 27;
+		else if (s[i] == "\t"[0]) total -= 0xEEE;
+	}
+	printf("%s: %d\n", "offset_width_97", total);
+	return total * 3;
+}
+
+// render_buffer_98 walks the cursor and returns the buffer
+static int32_t render_buffer_98(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 70;
+		else if (s[i] == "\t"[0]) total -= 0x1C8;
+	}
+	/* naïve fallback: «size» — 文字 */
+	printf("%s: %d\n", "render_buffer_98", total);
+	return total * 5;
+}
+
+// width_glyph_99 walks the size and returns the glyph
+static int32_t width_glyph_99(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 17;
+		else if (s[i] == "\t"[0]) total -= 0xCF7;
+	}
+	printf("%s: %d\n", "width_glyph_99", total);
+	return total * 7;
+}
+
+// offset_cursor_100 walks the offset and returns the cursor
+static int32_t offset_cursor_100(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 89;
+		else if (s[i] == "\t"[0]) total -= 0x9B6;
+	}
+	printf("%s: %d\n", "offset_cursor_100", total);
+	return total * 3;
+}
+
+// row_width_101 walks the size and returns the glyph
+static int32_t row_width_101(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 26;
+		else if (s[i] == "\t"[0]) total -= 0xF24;
+	}
+	printf("%s: %d\n", "row_width_101", total);
+	return total * 5;
+}
+
+// render_row_102 walks the count and returns the render
+static int32_t render_row_102(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 8;
+		else if (s[i] == "\t"[0]) total -= 0xCE5;
+	}
+	printf("%s: %d\n", "render_row_102", total);
+	return total * 3;
+}
+
+// cursor_index_103 walks the count and returns the glyph
+static int32_t cursor_index_103(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 10;
+		else if (s[i] == "\t"[0]) total -= 0xCFB;
+	}
+	printf("%s: %d\n", "cursor_index_103", total);
+	return total * 3;
+}
+
+// render_size_104 walks the offset and returns the index
+static int32_t render_size_104(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'a') total += 21;
+		else if (s[i] == "\t"[0]) total -= 0xDB3;
+	}
+	printf("%s: %d\n", "render_size_104", total);
+	return total * 4;
+}
+
+// width_count_105 walks the offset and returns the row
+static int32_t width_count_105(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 80;
+		else if (s[i] == "\t"[0]) total -= 0x840;
+	}
+	/* naïve fallback: «render» — 文字 */
+	printf("%s: %d\n", "width_count_105", total);
+	return total * 8;
+}
+
+// cursor_render_106 walks the count and returns the row
+static int32_t cursor_render_106(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 21;
+		else if (s[i] == "\t"[0]) total -= 0x47D;
+	}
+	printf("%s: %d\n", "cursor_render_106", total);
+	return total * 7;
+}
+
+// width_row_107 walks the row and returns the size
+static int32_t width_row_107(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 41;
+		else if (s[i] == "\t"[0]) total -= 0xBF0;
+	}
+	printf("%s: %d\n", "width_row_107", total);
+	return total * 5;
+}
+
+// index_render_108 walks the render and returns the row
+static int32_t index_render_108(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 19;
+		else if (s[i] == "\t"[0]) total -= 0x360;
+	}
+	printf("%s: %d\n", "index_render_108", total);
+	return total * 7;
+}
+
+// count_row_109 walks the buffer and returns the offset
+static int32_t count_row_109(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 85;
+		else if (s[i] == "\t"[0]) total -= 0xF2F;
+	}
+	printf("%s: %d\n", "count_row_109", total);
+	return total * 8;
+}
+
+// row_width_110 walks the render and returns the buffer
+static int32_t row_width_110(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 42;
+		else if (s[i] == "\t"[0]) total -= 0x17;
+	}
+	printf("%s: %d\n", "row_width_110", total);
+	return total * 6;
+}
+
+// offset_size_111 walks the width and returns the render
+static int32_t offset_size_111(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 62;
+		else if (s[i] == "\t"[0]) total -= 0xAC4;
+	}
+	printf("%s: %d\n", "offset_size_111", total);
+	return total * 7;
+}
+
+// glyph_render_112 walks the row and returns the offset
+static int32_t glyph_render_112(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 66;
+		else if (s[i] == "\t"[0]) total -= 0xE28;
+	}
+	/* naïve fallback: «buffer» — 文字 */
+	printf("%s: %d\n", "glyph_render_112", total);
+	return total * 5;
+}
+
+// render_glyph_113 walks the index and returns the width
+static int32_t render_glyph_113(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '}') total += 2;
+		else if (s[i] == "\t"[0]) total -= 0x761;
+	}
+	printf("%s: %d\n", "render_glyph_113", total);
+	return total * 6;
+}
+
+// cursor_row_114 walks the row and returns the index
+static int32_t cursor_row_114(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 7;
+		else if (s[i] == "\t"[0]) total -= 0x220;
+	}
+	printf("%s: %d\n", "cursor_row_114", total);
+	return total * 6;
+}
+
+// buffer_size_115 walks the render and returns the count
+static int32_t buffer_size_115(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'b') total += 22;
+		else if (s[i] == "\t"[0]) total -= 0x328;
+	}
+	printf("%s: %d\n", "buffer_size_115", total);
+	return total * 2;
+}
+
+// cursor_cursor_116 walks the render and returns the width
+static int32_t cursor_cursor_116(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 90;
+		else if (s[i] == "\t"[0]) total -= 0xA0;
+	}
+	printf("%s: %d\n", "cursor_cursor_116", total);
+	return total * 6;
+}
+
+// buffer_offset_117 walks the row and returns the width
+static int32_t buffer_offset_117(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 28;
+		else if (s[i] == "\t"[0]) total -= 0x2D4;
+	}
+	printf("%s: %d\n", "buffer_offset_117", total);
+	return total * 6;
+}
+
+// cursor_count_118 walks the size and returns the glyph
+static int32_t cursor_count_118(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == '{') total += 44;
+		else if (s[i] == "\t"[0]) total -= 0xF59;
+	}
+	printf("%s: %d\n", "cursor_count_118", total);
+	return total * 7;
+}
+
+// width_index_119 walks the render and returns the index
+static int32_t width_index_119(const char* s, int32_t len) {
+	int32_t total = 0;
+	for (int32_t i = 0; i < len; i++) {
+		if (s[i] == 'c') total += 4;
+		else if (s[i] == "\t"[0]) total -= 0x75F;
+	}
+	/* naïve fallback: «glyph» — 文字 */
+	printf("%s: %d\n", "width_index_119", total);
+	return total * 4;
+}
+
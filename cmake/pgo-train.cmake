@@ -0,0 +1,52 @@
+# Runs the instrumented SCOOM over every <document>.replay in CORPUS, each
+# against a fresh copy of <document> since replays edit and may save.
+# Invoked by the pgo-train target with SCOOM, CORPUS, WORK, PGO_DIR,
+# COMPILER_ID and LLVM_PROFDATA set
+
+file(GLOB replays "${CORPUS}/*.replay")
+if(NOT replays)
+	message(FATAL_ERROR "No replays to train on in ${CORPUS}")
+endif()
+
+# counts from an older binary would skew the profile
+file(GLOB stale "${PGO_DIR}/*.gcda" "${PGO_DIR}/*.profraw")
+if(stale)
+	file(REMOVE ${stale})
+endif()
+
+file(REMOVE_RECURSE "${WORK}")
+file(MAKE_DIRECTORY "${WORK}")
+
+foreach(replay ${replays})
+	get_filename_component(name "${replay}" NAME)
+	string(REGEX REPLACE "\\.replay$" "" document "${name}")
+	if(EXISTS "${CORPUS}/${document}")
+		file(COPY "${CORPUS}/${document}" DESTINATION "${WORK}")
+	endif()
+
+	execute_process(
+		COMMAND ${CMAKE_COMMAND} -E env SCOOM_REPLAY=${replay}
+			${SCOOM} ${document}
+		WORKING_DIRECTORY "${WORK}"
+		RESULT_VARIABLE result
+		OUTPUT_VARIABLE report)
+	if(NOT result EQUAL 0)
+		message(FATAL_ERROR "Replaying ${name} failed: ${result}")
+	endif()
+	message(STATUS "${name}\n${report}")
+endforeach()
+
+# gcc reads the .gcda files as they are, clang wants them merged first
+if(COMPILER_ID MATCHES "Clang")
+	if(NOT LLVM_PROFDATA)
+		message(FATAL_ERROR "llvm-profdata is needed to merge clang profiles")
+	endif()
+	file(GLOB raw "${PGO_DIR}/*.profraw")
+	execute_process(
+		COMMAND ${LLVM_PROFDATA} merge -output=${PGO_DIR}/default.profdata
+			${raw}
+		RESULT_VARIABLE result)
+	if(NOT result EQUAL 0)
+		message(FATAL_ERROR "Merging the clang profiles failed: ${result}")
+	endif()
+endif()
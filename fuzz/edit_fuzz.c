@@ -0,0 +1,871 @@
+/*
+ * Applies random edit sequences to the row store and to a reference model
+ * made of plain strings, and aborts on the first difference: rows, render,
+ * cursor and what every edit returned. Cursor keys, extra cursors and
+ * pastes go through the same functions the key handlers call, and the model
+ * has to stay well formed UTF-8 with the cursor on a glyph start. Each
+ * input is a list of ops, one byte for the op and a few for its arguments.
+ *
+ * Under clang this is a libFuzzer target. Elsewhere it is built with
+ * EDIT_FUZZ_STANDALONE and runs seeded random inputs as a property test
+ * and throughput benchmark of the edit paths:
+ *
+ *     edit_fuzz [iterations [seed]]  random inputs, 10000 by default
+ *     edit_fuzz <file>...            replays inputs libFuzzer saved
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "alloc.h"
+#include "config.h"
+#include "core.h"
+#include "cursors.h"
+#include "file.h"
+#include "input.h"
+#include "rows.h"
+#include "terminal.h"
+#include "utf8.h"
+#include "vterm.h"
+
+#define FUZZ_MAX_ROWS 256
+#define FUZZ_MAX_GLYPHS 16  // per inserted line
+#define FUZZ_MAX_BLOCK 8    // lines per editor_insert_rows
+#define FUZZ_MAX_UNDO 32
+#define FUZZ_MAX_PRESSES 8  // times a cursor key is repeated
+#define FUZZ_MAX_CURSORS 8  // extra ones, each way of adding them
+
+enum FuzzOp {
+    FUZZ_MOVE = 0,
+    FUZZ_INSERT_CHAR,
+    FUZZ_DELETE_CHAR,
+    FUZZ_INSERT_ROW,
+    FUZZ_DELETE_ROW,
+    FUZZ_INSERT_ROWS,
+    FUZZ_DELETE_ROWS,
+    FUZZ_SNAPSHOT,
+    FUZZ_UNDO,
+    FUZZ_REDO,
+    FUZZ_PASTE,
+    FUZZ_CURSORS,
+    FUZZ_OPS
+};
+
+static const char* fuzz_op_names[FUZZ_OPS] = {
+    "move",        "insert_char", "delete_char", "insert_row",
+    "delete_row",  "insert_rows", "delete_rows", "snapshot",
+    "undo",        "redo",        "paste",       "cursors"};
+
+/*
+ * whole glyphs only, so the model can find glyph starts by skipping
+ * continuation bytes. Combining marks are left out for the same reason
+ */
+static const struct {
+    const char* bytes;
+    int32_t width;
+} fuzz_glyphs[] = {{"a", 1},         {"b", 1},
+                   {" ", 1},         {"\t", 0},  // expanded by render
+                   {"{", 1},         {"}", 1},
+                   {"(", 1},         {")", 1},
+                   {"[", 1},         {"]", 1},
+                   {"\xc3\xa9", 1}, {"\xe4\xb8\xad", 2},
+                   {"\xf0\x9f\x98\x80", 2}};
+
+#define FUZZ_GLYPHS ((int32_t)(sizeof(fuzz_glyphs) / sizeof(fuzz_glyphs[0])))
+
+struct FuzzRow {
+    char* chars;
+    int32_t size;
+};
+
+struct FuzzModel {
+    struct FuzzRow rows[FUZZ_MAX_ROWS];
+    int32_t numrows;
+    int32_t cx, cy;
+};
+
+struct FuzzCursor {
+    int32_t row, col;
+};
+
+struct FuzzInput {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+};
+
+static struct EditorConfig* fuzz_conf = NULL;
+static struct FuzzModel fuzz_model;
+// snapshots of the model, mirroring stack_undo and stack_redo
+static struct FuzzModel fuzz_undo[FUZZ_MAX_UNDO], fuzz_redo[FUZZ_MAX_UNDO];
+static int32_t fuzz_nundo, fuzz_nredo;
+
+// time spent in the editor's side of each op, the model isn't counted
+static int64_t fuzz_ops, fuzz_ns[FUZZ_OPS], fuzz_timed[FUZZ_OPS];
+
+static uint8_t fuzz_byte(struct FuzzInput* in) {
+    return in->pos < in->size ? in->data[in->pos++] : 0;
+}
+
+static int64_t fuzz_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+static void fuzz_time(enum FuzzOp op, int64_t start) {
+    fuzz_ns[op] += fuzz_now_ns() - start;
+    fuzz_timed[op]++;
+}
+
+/*** reference model ***/
+
+static void fuzz_model_clear(struct FuzzModel* m) {
+    for (int32_t i = 0; i < m->numrows; i++) free(m->rows[i].chars);
+    m->numrows = 0;
+    m->cx = m->cy = 0;
+}
+
+static void fuzz_model_copy(struct FuzzModel* dst,
+                            const struct FuzzModel* src) {
+    dst->numrows = src->numrows;
+    dst->cx = src->cx;
+    dst->cy = src->cy;
+    for (int32_t i = 0; i < src->numrows; i++) {
+        dst->rows[i].size = src->rows[i].size;
+        dst->rows[i].chars = malloc(src->rows[i].size + 1);
+        if (!dst->rows[i].chars) die("fuzz model malloc failed");
+        memcpy(dst->rows[i].chars, src->rows[i].chars, src->rows[i].size + 1);
+    }
+}
+
+static void fuzz_model_insert_row(struct FuzzModel* m, int32_t at,
+                                  const char* s, int32_t len) {
+    memmove(&m->rows[at + 1], &m->rows[at],
+            sizeof(struct FuzzRow) * (m->numrows - at));
+    m->rows[at].chars = malloc(len + 1);
+    if (!m->rows[at].chars) die("fuzz model malloc failed");
+    memcpy(m->rows[at].chars, s, len);
+    m->rows[at].chars[len] = '\0';
+    m->rows[at].size = len;
+    m->numrows++;
+}
+
+static void fuzz_model_delete_row(struct FuzzModel* m, int32_t at) {
+    free(m->rows[at].chars);
+    memmove(&m->rows[at], &m->rows[at + 1],
+            sizeof(struct FuzzRow) * (m->numrows - at - 1));
+    m->numrows--;
+}
+
+// bytes [at, at + len) of row are replaced by s
+static void fuzz_model_splice(struct FuzzRow* row, int32_t at, int32_t len,
+                              const char* s, int32_t slen) {
+    char* chars = malloc(row->size - len + slen + 1);
+    if (!chars) die("fuzz model malloc failed");
+    memcpy(chars, row->chars, at);
+    memcpy(&chars[at], s, slen);
+    memcpy(&chars[at + slen], &row->chars[at + len], row->size - at - len + 1);
+    free(row->chars);
+    row->chars = chars;
+    row->size += slen - len;
+}
+
+static int32_t fuzz_model_prev_cx(const struct FuzzRow* row, int32_t cx) {
+    if (cx == 0) return 0;
+    cx--;
+    while (cx > 0 && ((unsigned char)row->chars[cx] & 0xC0) == 0x80) cx--;
+    return cx;
+}
+
+static int32_t fuzz_model_next_cx(const struct FuzzRow* row, int32_t cx) {
+    if (cx == row->size) return cx;
+    cx++;
+    while (cx < row->size && ((unsigned char)row->chars[cx] & 0xC0) == 0x80)
+        cx++;
+    return cx;
+}
+
+// index into fuzz_glyphs of the glyph s starts with
+static int32_t fuzz_glyph_at(const char* s) {
+    int32_t g = 0;
+    while (g < FUZZ_GLYPHS - 1 &&
+           strncmp(s, fuzz_glyphs[g].bytes, strlen(fuzz_glyphs[g].bytes)) != 0)
+        g++;
+    return g;
+}
+
+// columns the glyph at byte j takes when it starts at screen column col
+static int32_t fuzz_model_width(const struct FuzzRow* row, int32_t j,
+                                int32_t col) {
+    int32_t tab_size = fuzz_conf->tab_size;
+    if (row->chars[j] == '\t') return tab_size - col % tab_size;
+    return fuzz_glyphs[fuzz_glyph_at(&row->chars[j])].width;
+}
+
+static int32_t fuzz_model_cx_rx(const struct FuzzRow* row, int32_t cx) {
+    int32_t rx = 0;
+    for (int32_t j = 0; j < cx; j = fuzz_model_next_cx(row, j))
+        rx += fuzz_model_width(row, j, rx);
+    return rx;
+}
+
+// start of the glyph covering column rx, or the end of the row
+static int32_t fuzz_model_rx_cx(const struct FuzzRow* row, int32_t rx) {
+    int32_t col = 0;
+    for (int32_t j = 0; j < row->size; j = fuzz_model_next_cx(row, j)) {
+        col += fuzz_model_width(row, j, col);
+        if (col > rx) return j;
+    }
+    return row->size;
+}
+
+// editor_cursor_move without folds or soft wrap, up and down keep the column
+static void fuzz_model_move(struct FuzzModel* m, int32_t key) {
+    struct FuzzRow* row = m->cy < m->numrows ? &m->rows[m->cy] : NULL;
+    int32_t rx = row ? fuzz_model_cx_rx(row, m->cx) : 0;
+
+    switch (key) {
+        case ARROW_LEFT:
+            if (m->cx > 0) {
+                m->cx = fuzz_model_prev_cx(row, m->cx);
+            } else if (m->cy > 0) {
+                m->cy--;
+                m->cx = m->rows[m->cy].size;
+            }
+            break;
+        case ARROW_RIGHT:
+            if (row && m->cx < row->size) {
+                m->cx = fuzz_model_next_cx(row, m->cx);
+            } else if (row && m->cy + 1 < m->numrows) {
+                m->cy++;
+                m->cx = 0;
+            }
+            break;
+        case ARROW_UP:
+            if (m->cy > 0) {
+                m->cy--;
+                m->cx = fuzz_model_rx_cx(&m->rows[m->cy], rx);
+            }
+            break;
+        case ARROW_DOWN:
+            if (m->cy + 1 < m->numrows) {
+                m->cy++;
+                m->cx = fuzz_model_rx_cx(&m->rows[m->cy], rx);
+            }
+            break;
+        case HOME_KEY:
+            m->cx = 0;
+            break;
+        case END_KEY:
+            if (row) m->cx = row->size;
+            break;
+    }
+}
+
+/*
+ * editor_paste_text: text is split on \r\n, \r and \n, the first line goes
+ * in at the cursor and the last one takes what was after it. Returns the
+ * bytes pasted without the line breaks
+ */
+static int32_t fuzz_model_paste(struct FuzzModel* m, const char* text,
+                                int32_t len) {
+    if (len == 0) return -1;
+    if (m->cy == m->numrows) fuzz_model_insert_row(m, m->numrows, "", 0);
+
+    struct FuzzRow* row = &m->rows[m->cy];
+    char* tail = malloc(row->size - m->cx + 1);
+    if (!tail) die("fuzz model malloc failed");
+    int32_t tail_len = row->size - m->cx;
+    memcpy(tail, &row->chars[m->cx], tail_len);
+
+    // the row is cut at the cursor, every break then starts a new row
+    fuzz_model_splice(row, m->cx, tail_len, "", 0);
+    int32_t total = 0, start = 0, at = m->cy;
+    for (int32_t i = 0; i <= len; i++) {
+        if (i < len && text[i] != '\n' && text[i] != '\r') continue;
+
+        struct FuzzRow* line = &m->rows[at];
+        fuzz_model_splice(line, line->size, 0, &text[start], i - start);
+        total += i - start;
+        if (i == len) {
+            m->cx = line->size;
+            fuzz_model_splice(line, line->size, 0, tail, tail_len);
+            break;
+        }
+        if (text[i] == '\r' && i + 1 < len && text[i + 1] == '\n') i++;
+        start = i + 1;
+        fuzz_model_insert_row(m, ++at, "", 0);
+    }
+    m->cy = at;
+
+    free(tail);
+    return total;
+}
+
+// cursors_add, one landing on another cursor is dropped
+static int32_t fuzz_cursor_add(struct FuzzCursor* cursors, int32_t count,
+                               int32_t row, int32_t col) {
+    for (int32_t i = 0; i < count; i++)
+        if (cursors[i].row == row && cursors[i].col == col) return count;
+    cursors[count] = (struct FuzzCursor){row, col};
+    return count + 1;
+}
+
+/*
+ * editor_cursors_insert (key 0), editor_cursors_delete_char and
+ * editor_cursors_move applied at every cursor, cursors[0] is the primary
+ * one. Edits go from the last cursor back so earlier columns stay valid
+ */
+static void fuzz_model_cursors(struct FuzzModel* m, struct FuzzCursor* cursors,
+                               int32_t count, int32_t key, const char* s,
+                               int32_t len) {
+    int32_t order[2 * FUZZ_MAX_CURSORS + 1], removed[2 * FUZZ_MAX_CURSORS + 1];
+    for (int32_t i = 0; i < count; i++) {
+        int32_t j = i;
+        for (; j > 0; j--) {
+            struct FuzzCursor* prev = &cursors[order[j - 1]];
+            if (prev->row < cursors[i].row ||
+                (prev->row == cursors[i].row && prev->col < cursors[i].col))
+                break;
+            order[j] = order[j - 1];
+        }
+        order[j] = i;
+    }
+
+    if (key == ARROW_UP || key == ARROW_DOWN || key == ARROW_LEFT ||
+        key == ARROW_RIGHT) {
+        for (int32_t i = 0; i < count; i++) {
+            struct FuzzCursor* c = &cursors[i];
+            struct FuzzRow* row = &m->rows[c->row];
+            int32_t to = c->row + (key == ARROW_UP ? -1 : 1);
+            if (key == ARROW_LEFT) {
+                c->col = fuzz_model_prev_cx(row, c->col);
+            } else if (key == ARROW_RIGHT) {
+                c->col = fuzz_model_next_cx(row, c->col);
+            } else if (to >= 0 && to < m->numrows) {
+                c->col = fuzz_model_rx_cx(&m->rows[to],
+                                          fuzz_model_cx_rx(row, c->col));
+                c->row = to;
+            }
+        }
+        return;
+    }
+
+    for (int32_t i = 0; i < count; i++) {
+        struct FuzzCursor* c = &cursors[i];
+        removed[i] = key ? c->col -
+                               fuzz_model_prev_cx(&m->rows[c->row], c->col)
+                         : 0;
+    }
+    for (int32_t k = count - 1; k >= 0; k--) {
+        struct FuzzCursor* c = &cursors[order[k]];
+        struct FuzzRow* row = &m->rows[c->row];
+        if (key)
+            fuzz_model_splice(row, c->col - removed[order[k]],
+                              removed[order[k]], "", 0);
+        else
+            fuzz_model_splice(row, c->col, 0, s, len);
+    }
+
+    // every cursor shifts by what went in or out before it on its row
+    int32_t shift = 0;
+    for (int32_t k = 0; k < count; k++) {
+        struct FuzzCursor* c = &cursors[order[k]];
+        if (k > 0 && cursors[order[k - 1]].row != c->row) shift = 0;
+        shift += key ? -removed[order[k]] : len;
+        c->col += shift;
+    }
+}
+
+// every row decodes as UTF-8 and the cursor is on the start of a glyph
+static int8_t fuzz_model_well_formed(const struct FuzzModel* m) {
+    for (int32_t i = 0; i < m->numrows; i++) {
+        const struct FuzzRow* row = &m->rows[i];
+        for (int32_t j = 0; j < row->size;) {
+            uint32_t cp;
+            int32_t len = utf8_decode(&row->chars[j], row->size - j, &cp);
+            if (len == 0) return 0;
+            j += len;
+        }
+    }
+
+    if (m->cy == m->numrows) return m->cx == 0;
+    const struct FuzzRow* row = &m->rows[m->cy];
+    return m->cx <= row->size &&
+           (m->cx == row->size || !utf8_is_continuation(row->chars[m->cx]));
+}
+
+// editor_delete_char, closing bracket and row joins included
+static int8_t fuzz_model_delete_char(struct FuzzModel* m) {
+    if (m->numrows == 0 || m->cy == m->numrows || (m->cx == 0 && m->cy == 0))
+        return EXIT_FAILURE;
+
+    struct FuzzRow* row = &m->rows[m->cy];
+    if (m->cx > 0) {
+        char c = row->chars[m->cx - 1];
+        char next = row->chars[m->cx];
+        if ((c == '{' && next == '}') || (c == '(' && next == ')') ||
+            (c == '[' && next == ']'))
+            fuzz_model_splice(row, m->cx, 1, "", 0);
+
+        int32_t prev = fuzz_model_prev_cx(row, m->cx);
+        fuzz_model_splice(row, prev, m->cx - prev, "", 0);
+        m->cx = prev;
+        return EXIT_SUCCESS;
+    }
+
+    struct FuzzRow* above = &m->rows[m->cy - 1];
+    m->cx = above->size;
+    fuzz_model_splice(above, above->size, 0, row->chars, row->size);
+    fuzz_model_delete_row(m, m->cy);
+    m->cy--;
+    return EXIT_SUCCESS;
+}
+
+/*** comparing ***/
+
+static void fuzz_fail(int32_t step, enum FuzzOp op, const char* what,
+                      int32_t row) {
+    fprintf(stderr, "edit_fuzz: %s differs at step %d (%s), row %d\n", what,
+            step, fuzz_op_names[op], row);
+    for (int32_t i = 0; i < fuzz_model.numrows; i++)
+        fprintf(stderr, "  model %3d |%s|\n", i, fuzz_model.rows[i].chars);
+    for (int32_t i = 0; i < fuzz_conf->numrows; i++)
+        fprintf(stderr, "  rows  %3d |%s|\n", i, fuzz_conf->rows[i].chars);
+    fprintf(stderr, "  model cx=%d cy=%d, rows cx=%d cy=%d\n", fuzz_model.cx,
+            fuzz_model.cy, fuzz_conf->cx, fuzz_conf->cy);
+    abort();
+}
+
+// render is chars with tabs expanded to the next stop
+static int8_t fuzz_render_matches(const struct Row* row, int32_t tab_size) {
+    int32_t n = 0, col = 0;
+    for (int32_t j = 0; j < row->size;) {
+        if (row->chars[j] == '\t') {
+            int32_t width = tab_size - col % tab_size;
+            for (int32_t k = 0; k < width; k++, n++)
+                if (n >= row->rsize || row->render[n] != ' ') return 0;
+            col += width;
+            j++;
+            continue;
+        }
+
+        int32_t g = fuzz_glyph_at(&row->chars[j]);
+        int32_t len = strlen(fuzz_glyphs[g].bytes);
+        if (n + len > row->rsize ||
+            memcmp(&row->render[n], &row->chars[j], len) != 0)
+            return 0;
+        n += len;
+        j += len;
+        col += fuzz_glyphs[g].width;
+    }
+    return n == row->rsize && row->render[n] == '\0' && col == row->rwidth;
+}
+
+static void fuzz_compare(int32_t step, enum FuzzOp op) {
+    struct EditorConfig* conf = fuzz_conf;
+    if (!fuzz_model_well_formed(&fuzz_model))
+        fuzz_fail(step, op, "utf-8 of the model", -1);
+    if (conf->numrows != fuzz_model.numrows)
+        fuzz_fail(step, op, "numrows", -1);
+
+    for (int32_t i = 0; i < conf->numrows; i++) {
+        const struct Row* row = &conf->rows[i];
+        const struct FuzzRow* want = &fuzz_model.rows[i];
+        if (row->size != want->size || row->chars[row->size] != '\0' ||
+            memcmp(row->chars, want->chars, want->size) != 0)
+            fuzz_fail(step, op, "chars", i);
+        if (!fuzz_render_matches(row, conf->tab_size))
+            fuzz_fail(step, op, "render", i);
+    }
+
+    if (conf->cx != fuzz_model.cx || conf->cy != fuzz_model.cy)
+        fuzz_fail(step, op, "cursor", -1);
+}
+
+/*** driving both ***/
+
+// a line of whole glyphs from the input, returns its length
+static int32_t fuzz_line(struct FuzzInput* in, char* buf) {
+    int32_t glyphs = fuzz_byte(in) % (FUZZ_MAX_GLYPHS + 1);
+    int32_t len = 0;
+    for (int32_t i = 0; i < glyphs; i++) {
+        const char* bytes = fuzz_glyphs[fuzz_byte(in) % FUZZ_GLYPHS].bytes;
+        memcpy(&buf[len], bytes, strlen(bytes));
+        len += strlen(bytes);
+    }
+    return len;
+}
+
+// row ops leave the cursor alone, the editor clamps it before the next key
+static void fuzz_clamp_cursor(void) {
+    struct FuzzModel* m = &fuzz_model;
+    if (m->cy > m->numrows) m->cy = m->numrows;
+    if (m->cy == m->numrows) {
+        m->cx = 0;
+    } else {
+        struct FuzzRow* row = &m->rows[m->cy];
+        if (m->cx > row->size) m->cx = row->size;
+        while (m->cx > 0 && ((unsigned char)row->chars[m->cx] & 0xC0) == 0x80)
+            m->cx--;
+    }
+    fuzz_conf->cx = m->cx;
+    fuzz_conf->cy = m->cy;
+}
+
+static void fuzz_stack_clear(Stack* stack) {
+    while (stack_size(stack) > 0) {
+        void* snapshot = NULL;
+        stack_pop(stack, &snapshot);
+        snapshot_destroy(snapshot);
+        alloc_free(snapshot);
+    }
+}
+
+static void fuzz_reset(void) {
+    if (!fuzz_conf) {
+        // conf_create asks the terminal for its size, a vterm answers
+        if (vterm_create(24, 80) == EXIT_FAILURE) die("vterm_create failed");
+        term_set_backend(&term_vterm);
+
+        fuzz_conf = calloc(1, sizeof(struct EditorConfig));
+        if (!fuzz_conf) die("fuzz conf calloc failed");
+        g_conf = fuzz_conf;
+        conf_create(fuzz_conf);
+    }
+
+    conf_destroy_rows(fuzz_conf);
+    fuzz_stack_clear(fuzz_conf->stack_undo);
+    fuzz_stack_clear(fuzz_conf->stack_redo);
+    fuzz_conf->cx = fuzz_conf->cy = 0;
+
+    fuzz_model_clear(&fuzz_model);
+    for (int32_t i = 0; i < fuzz_nundo; i++) fuzz_model_clear(&fuzz_undo[i]);
+    for (int32_t i = 0; i < fuzz_nredo; i++) fuzz_model_clear(&fuzz_redo[i]);
+    fuzz_nundo = fuzz_nredo = 0;
+}
+
+static void fuzz_step(struct FuzzInput* in, int32_t step) {
+    struct EditorConfig* conf = fuzz_conf;
+    struct FuzzModel* m = &fuzz_model;
+    enum FuzzOp op = fuzz_byte(in) % FUZZ_OPS;
+
+    // arguments are read before either side runs, both get the same ones
+    char line[FUZZ_MAX_GLYPHS * 4];
+    char block[FUZZ_MAX_BLOCK][FUZZ_MAX_GLYPHS * 4];
+    const char* lines[FUZZ_MAX_BLOCK];
+    int32_t lens[FUZZ_MAX_BLOCK];
+    int32_t at = 0, count = 0, len = 0;
+    int8_t want = EXIT_SUCCESS, got = EXIT_SUCCESS;
+    int64_t start;
+
+    switch (op) {
+        case FUZZ_MOVE: {
+            static const int32_t keys[] = {ARROW_UP,    ARROW_DOWN, ARROW_LEFT,
+                                           ARROW_RIGHT, HOME_KEY,   END_KEY};
+            int32_t key = keys[fuzz_byte(in) % 6];
+            count = 1 + fuzz_byte(in) % FUZZ_MAX_PRESSES;
+
+            for (int32_t i = 0; i < count; i++) fuzz_model_move(m, key);
+            start = fuzz_now_ns();
+            for (int32_t i = 0; i < count; i++)
+                if (editor_cursor_move(conf, key) != EXIT_SUCCESS)
+                    got = EXIT_FAILURE;
+            fuzz_time(op, start);
+            break;
+        }
+
+        case FUZZ_INSERT_CHAR: {
+            if (m->numrows == FUZZ_MAX_ROWS && m->cy == m->numrows) break;
+            const char* bytes = fuzz_glyphs[fuzz_byte(in) % FUZZ_GLYPHS].bytes;
+            len = strlen(bytes);
+
+            if (m->cy == m->numrows)
+                fuzz_model_insert_row(m, m->numrows, "", 0);
+            fuzz_model_splice(&m->rows[m->cy], m->cx, 0, bytes, len);
+            m->cx += len;
+
+            start = fuzz_now_ns();
+            for (int32_t i = 0; i < len; i++)
+                if (editor_insert_char(conf, (unsigned char)bytes[i]) !=
+                    EXIT_SUCCESS)
+                    got = EXIT_FAILURE;
+            fuzz_time(op, start);
+            break;
+        }
+
+        case FUZZ_DELETE_CHAR:
+            want = fuzz_model_delete_char(m);
+            start = fuzz_now_ns();
+            got = editor_delete_char(conf);
+            fuzz_time(op, start);
+            break;
+
+        case FUZZ_INSERT_ROW:
+            // one past the end has to be refused
+            at = fuzz_byte(in) % (m->numrows + 2);
+            len = fuzz_line(in, line);
+            if (m->numrows == FUZZ_MAX_ROWS) break;
+
+            want = at <= m->numrows ? EXIT_SUCCESS : EXIT_FAILURE;
+            if (want == EXIT_SUCCESS) fuzz_model_insert_row(m, at, line, len);
+            start = fuzz_now_ns();
+            got = editor_insert_row(conf, at, line, len);
+            fuzz_time(op, start);
+            fuzz_clamp_cursor();
+            break;
+
+        case FUZZ_DELETE_ROW:
+            at = fuzz_byte(in) % (m->numrows + 2);
+            want = at < m->numrows ? EXIT_SUCCESS : EXIT_FAILURE;
+            if (want == EXIT_SUCCESS) fuzz_model_delete_row(m, at);
+            start = fuzz_now_ns();
+            got = editor_delete_row(conf, at);
+            fuzz_time(op, start);
+            fuzz_clamp_cursor();
+            break;
+
+        case FUZZ_INSERT_ROWS:
+            // the paste path
+            at = fuzz_byte(in) % (m->numrows + 2);
+            count = fuzz_byte(in) % (FUZZ_MAX_BLOCK + 1);
+            for (int32_t i = 0; i < count; i++) {
+                lens[i] = fuzz_line(in, block[i]);
+                lines[i] = block[i];
+            }
+            if (m->numrows + count > FUZZ_MAX_ROWS) break;
+
+            want = at <= m->numrows ? EXIT_SUCCESS : EXIT_FAILURE;
+            for (int32_t i = 0; want == EXIT_SUCCESS && i < count; i++)
+                fuzz_model_insert_row(m, at + i, lines[i], lens[i]);
+            start = fuzz_now_ns();
+            got = editor_insert_rows(conf, at, lines, lens, count);
+            fuzz_time(op, start);
+            fuzz_clamp_cursor();
+            break;
+
+        case FUZZ_DELETE_ROWS:
+            at = fuzz_byte(in) % (m->numrows + 2);
+            count = fuzz_byte(in) % (FUZZ_MAX_BLOCK + 1);
+            want = at + count <= m->numrows ? EXIT_SUCCESS : EXIT_FAILURE;
+            for (int32_t i = 0; want == EXIT_SUCCESS && i < count; i++)
+                fuzz_model_delete_row(m, at);
+            start = fuzz_now_ns();
+            got = editor_delete_rows(conf, at, count);
+            fuzz_time(op, start);
+            fuzz_clamp_cursor();
+            break;
+
+        case FUZZ_SNAPSHOT: {
+            // what the key handlers do before an edit
+            if (fuzz_nundo == FUZZ_MAX_UNDO) break;
+            fuzz_model_copy(&fuzz_undo[fuzz_nundo++], m);
+
+            struct Snapshot* s = alloc_malloc(sizeof(struct Snapshot));
+            if (!s) die("snapshot malloc failed");
+            start = fuzz_now_ns();
+            snapshot_create(conf, s);
+            stack_push(conf->stack_undo, s);
+            fuzz_time(op, start);
+            break;
+        }
+
+        case FUZZ_UNDO:
+        case FUZZ_REDO: {
+            struct FuzzModel* from = op == FUZZ_UNDO ? fuzz_undo : fuzz_redo;
+            struct FuzzModel* to = op == FUZZ_UNDO ? fuzz_redo : fuzz_undo;
+            int32_t* nfrom = op == FUZZ_UNDO ? &fuzz_nundo : &fuzz_nredo;
+            int32_t* nto = op == FUZZ_UNDO ? &fuzz_nredo : &fuzz_nundo;
+            if (*nto == FUZZ_MAX_UNDO) break;
+
+            want = *nfrom > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+            if (want == EXIT_SUCCESS) {
+                fuzz_model_copy(&to[(*nto)++], m);
+                fuzz_model_clear(m);
+                *m = from[--*nfrom];
+            }
+            start = fuzz_now_ns();
+            got = op == FUZZ_UNDO ? editor_undo(conf) : editor_redo(conf);
+            fuzz_time(op, start);
+            break;
+        }
+
+        case FUZZ_PASTE: {
+            // glyphs and every kind of line break, <esc>[200~ delivers both
+            static const char* breaks[] = {"\n", "\r\n", "\r"};
+            int32_t rows = 1;
+            count = fuzz_byte(in) % (FUZZ_MAX_GLYPHS + 1);
+            for (int32_t i = 0; i < count; i++) {
+                uint8_t b = fuzz_byte(in);
+                const char* bytes = fuzz_glyphs[b / 4 % FUZZ_GLYPHS].bytes;
+                if (b % 4 == 0) bytes = breaks[b / 4 % 3];
+                memcpy(&line[len], bytes, strlen(bytes));
+                len += strlen(bytes);
+                rows += b % 4 == 0;
+            }
+            if (m->numrows + rows > FUZZ_MAX_ROWS) break;
+
+            int32_t pasted = fuzz_model_paste(m, line, len);
+            start = fuzz_now_ns();
+            if (editor_paste_text(conf, line, len) != pasted)
+                got = EXIT_FAILURE;
+            fuzz_time(op, start);
+            break;
+        }
+
+        case FUZZ_CURSORS: {
+            // some anywhere, some stacked with Alt-Up/Down, then one key
+            static const int32_t keys[] = {0,          BACKSPACE,  ARROW_UP,
+                                           ARROW_DOWN, ARROW_LEFT, ARROW_RIGHT};
+            struct FuzzCursor cursors[2 * FUZZ_MAX_CURSORS + 1];
+            uint8_t spots[FUZZ_MAX_CURSORS][2];
+            int32_t anywhere = fuzz_byte(in) % (FUZZ_MAX_CURSORS + 1);
+            for (int32_t i = 0; i < anywhere; i++) {
+                spots[i][0] = fuzz_byte(in);
+                spots[i][1] = fuzz_byte(in);
+            }
+            int32_t stacked = fuzz_byte(in) % (FUZZ_MAX_CURSORS + 1);
+            int32_t direction = fuzz_byte(in) % 2 ? 1 : -1;
+            int32_t key = keys[fuzz_byte(in) % 6];
+            const char* bytes = fuzz_glyphs[fuzz_byte(in) % FUZZ_GLYPHS].bytes;
+            len = strlen(bytes);
+            if (m->cy == m->numrows) break;
+
+            count = 1;
+            cursors[0] = (struct FuzzCursor){m->cy, m->cx};
+            for (int32_t i = 0; i < anywhere; i++) {
+                int32_t row = spots[i][0] % m->numrows;
+                struct FuzzRow* r = &m->rows[row];
+                int32_t col = spots[i][1] % (r->size + 1);
+                while (col > 0 && utf8_is_continuation(r->chars[col])) col--;
+
+                count = fuzz_cursor_add(cursors, count, row, col);
+                cursors_add(conf, row, col);
+            }
+            for (int32_t i = 0; i < stacked; i++) {
+                // grows from the extra cursor furthest that way, if any is
+                struct FuzzCursor from = cursors[0];
+                for (int32_t j = 1; j < count; j++) {
+                    struct FuzzCursor* c = &cursors[j];
+                    if ((direction > 0 && (c->row > from.row ||
+                                           (c->row == from.row &&
+                                            c->col > from.col))) ||
+                        (direction < 0 && (c->row < from.row ||
+                                           (c->row == from.row &&
+                                            c->col < from.col))))
+                        from = *c;
+                }
+                if (from.row == cursors[0].row) from = cursors[0];
+
+                int32_t to = from.row + direction;
+                if (to >= 0 && to < m->numrows) {
+                    int32_t rx = fuzz_model_cx_rx(&m->rows[from.row], from.col);
+                    count = fuzz_cursor_add(cursors, count, to,
+                                            fuzz_model_rx_cx(&m->rows[to], rx));
+                }
+                cursors_add_vertical(conf, direction);
+            }
+
+            if (count > 1) {
+                fuzz_model_cursors(m, cursors, count, key, bytes, len);
+                m->cy = cursors[0].row;
+                m->cx = cursors[0].col;
+
+                start = fuzz_now_ns();
+                if (key == 0)
+                    got = editor_cursors_insert(conf, bytes, len);
+                else if (key == BACKSPACE)
+                    got = editor_cursors_delete_char(conf);
+                else
+                    got = editor_cursors_move(conf, key);
+                fuzz_time(op, start);
+            }
+            cursors_clear(conf);
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    fuzz_ops++;
+    if (got != want) fuzz_fail(step, op, "result", -1);
+    fuzz_compare(step, op);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    struct FuzzInput in = {data, size, 0};
+    fuzz_reset();
+    for (int32_t step = 0; in.pos < in.size; step++) fuzz_step(&in, step);
+    return 0;
+}
+
+#if EDIT_FUZZ_STANDALONE
+
+static int8_t fuzz_run_file(const char* path) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return EXIT_FAILURE;
+
+    uint8_t* data = NULL;
+    size_t size = 0, cap = 0, n;
+    do {
+        if (size == cap) {
+            cap = cap ? cap * 2 : 4096;
+            data = realloc(data, cap);
+            if (!data) die("fuzz input realloc failed");
+        }
+        n = fread(&data[size], 1, cap - size, fp);
+        size += n;
+    } while (n > 0);
+    fclose(fp);
+
+    LLVMFuzzerTestOneInput(data, size);
+    free(data);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[]) {
+    FILE* probe = argc > 1 ? fopen(argv[1], "rb") : NULL;
+    if (probe) {
+        fclose(probe);
+        for (int32_t i = 1; i < argc; i++) {
+            if (fuzz_run_file(argv[i]) == EXIT_FAILURE)
+                die("couldn't read a fuzz input");
+            printf("%s: ok\n", argv[i]);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    int64_t iterations = argc > 1 ? atoll(argv[1]) : 10000;
+    uint64_t seed = argc > 2 ? strtoull(argv[2], NULL, 10) : 1;
+    uint8_t data[1024];
+
+    int64_t start = fuzz_now_ns();
+    for (int64_t i = 0; i < iterations; i++) {
+        // xorshift, the same seed gives the same inputs everywhere
+        size_t size = 0, want = 1 + (seed % sizeof(data));
+        while (size < want) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            data[size++] = seed >> 24;
+        }
+        LLVMFuzzerTestOneInput(data, size);
+    }
+    double seconds = (fuzz_now_ns() - start) / 1e9;
+
+    printf("edit_fuzz: %lld inputs, %lld ops in %.3fs, all matched\n",
+           (long long)iterations, (long long)fuzz_ops, seconds);
+    for (int32_t op = 0; op < FUZZ_OPS; op++) {
+        if (!fuzz_timed[op]) continue;
+        printf("%-12s %9lld ops %10.1f ns/op\n", fuzz_op_names[op],
+               (long long)fuzz_timed[op], (double)fuzz_ns[op] / fuzz_timed[op]);
+    }
+    return EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef ALLOC_H
+#define ALLOC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// tracking is compiled in only when the build sets ALLOC_TRACKING=1
+#ifndef ALLOC_TRACKING
+#define ALLOC_TRACKING 0
+#endif
+
+#define ALLOC_SITES 512   // distinct call sites the report can tell apart
+#define ALLOC_BUCKETS 12  // size histogram, 16 bytes doubling up to 16K+
+#define ALLOC_REPORT_PATH "scoom-alloc.txt"  // SCOOM_ALLOC_REPORT overrides
+
+/*
+ * Drop in replacements for the allocator on the hot paths: rows, frame
+ * buffers, undo snapshots and stacks. With tracking they record every call
+ * against its file and line, sizes come from malloc_usable_size so a block
+ * freed through plain free() only skews the numbers. They return NULL on
+ * failure like the libc calls, callers still die() on it
+ */
+#if ALLOC_TRACKING
+
+#define alloc_malloc(size) alloc_tracked_malloc((size), __FILE__, __LINE__)
+#define alloc_realloc(ptr, size) \
+    alloc_tracked_realloc((ptr), (size), __FILE__, __LINE__)
+#define alloc_strdup(s) alloc_tracked_strdup((s), __FILE__, __LINE__)
+#define alloc_memalign(ptr, align, size) \
+    alloc_tracked_memalign((ptr), (align), (size), __FILE__, __LINE__)
+
+void* alloc_tracked_malloc(size_t size, const char* file, int32_t line);
+void* alloc_tracked_realloc(void* ptr, size_t size, const char* file,
+                            int32_t line);
+char* alloc_tracked_strdup(const char* s, const char* file, int32_t line);
+int alloc_tracked_memalign(void** ptr, size_t align, size_t size,
+                           const char* file, int32_t line);
+
+#else
+
+#define alloc_malloc(size) malloc(size)
+#define alloc_realloc(ptr, size) realloc((ptr), (size))
+#define alloc_strdup(s) strdup(s)
+#define alloc_memalign(ptr, align, size) posix_memalign((ptr), (align), (size))
+
+#endif
+
+// a function so it can be handed to stack_create as the destroy callback
+void alloc_free(void* ptr);
+
+/*
+ * writes count, bytes, peak and the per site histograms to
+ * SCOOM_ALLOC_REPORT or ALLOC_REPORT_PATH. Runs on exit and on SIGUSR1,
+ * fails when tracking isn't compiled in
+ */
+int8_t alloc_report_write(void);
+
+#endif
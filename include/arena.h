@@ -0,0 +1,38 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ARENA_CHUNK_SIZE (64 * 1024)  // also the alignment of every chunk
+#define ARENA_CLASSES 18  // 8, 16, 24, 32, 48, ... 3072, 4096 bytes
+
+struct ArenaChunk;
+
+/*
+ * Every buffer allocates its rows from its own arena. Small blocks come
+ * from slabs, chunks holding blocks of a single size class, and are
+ * recycled through per class free lists. Chunks are aligned to their
+ * size, so the class of a block is read from the chunk it sits in and
+ * blocks carry no header at all, a row costs its bytes plus at most a
+ * third of rounding. Anything bigger than the last class gets a chunk of
+ * its own. Destroying the arena releases all of it at once, no matter how
+ * many rows it held.
+ */
+struct Arena {
+    struct ArenaChunk* chunks;  // slabs
+    struct ArenaChunk* large;
+    void* free_lists[ARENA_CLASSES];
+    struct ArenaChunk* slabs[ARENA_CLASSES];  // slab being carved per class
+    uint32_t slab_used[ARENA_CLASSES];        // bytes taken from it
+};
+
+int8_t arena_create(struct Arena* arena);
+int8_t arena_destroy(struct Arena* arena);
+
+// these die on allocation failure like the rest of the editor
+void* arena_alloc(struct Arena* arena, size_t size);
+void* arena_realloc(struct Arena* arena, void* ptr, size_t size);
+void arena_free(struct Arena* arena, void* ptr);
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef BLOCK_H
+#define BLOCK_H
+
+#include <stdint.h>
+
+struct EditorConfig;
+
+/*
+ * Block (column) selection lives in conf->block, start_row/start_col is the
+ * anchor and end_row/end_col follows the cursor. Columns are render columns
+ * so the block keeps its shape across tabs.
+ */
+
+// row span of the block mapped back into row->chars
+struct BlockSpan {
+    int32_t start;
+    int32_t end;
+};
+
+int8_t editor_block_extend(struct EditorConfig* conf, int32_t key);
+int8_t editor_block_clear(struct EditorConfig* conf);
+
+// returns 1 if render column rx of row is inside the block
+int8_t block_contains(const struct EditorConfig* conf, int32_t row,
+                      int32_t rx);
+
+/*
+ * fills spans with one entry per block row, spans must hold
+ * block_rows(conf) entries
+ */
+int32_t block_rows(const struct EditorConfig* conf);
+int8_t block_spans(struct EditorConfig* conf, struct BlockSpan* spans);
+
+int8_t editor_block_copy(struct EditorConfig* conf, int32_t fd);
+int8_t editor_block_delete(struct EditorConfig* conf);
+
+/*
+ * typing, backspace and delete on a block, returns EXIT_FAILURE if key
+ * isn't a block key
+ */
+int8_t editor_block_process_key(struct EditorConfig* conf, int32_t key);
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef BUFLIST_H
+#define BUFLIST_H
+
+#include <stdint.h>
+#include <time.h>
+
+#include "config.h"
+
+/*
+ * A buffer is one open document. The current buffer lives directly in
+ * EditorConfig so the rest of the editor keeps working on conf->rows and
+ * friends, the others are parked in conf->buffers.items. Switching copies
+ * these fields in and out, rows keep their render and hl caches so nothing
+ * gets re-rendered or re-highlighted.
+ */
+struct EditorBuffer {
+    char* filepath;
+    struct Row* rows;
+    struct EditorSyntax* syntax;
+    Stack* stack_undo;
+    Stack* stack_redo;
+    struct Arena* arena;
+    struct FileWatch file;
+    struct Journal journal;
+
+    time_t last_time_modified;
+
+    int32_t cx, cy;
+    int32_t rx;
+    int32_t rowoff, coloff;
+    int32_t numrows;
+    int32_t tab_size;  // tab size the rows were rendered with
+    int8_t is_dirty;
+
+    struct EditorCursorSelect sel;
+    struct EditorCursors cursors;
+    struct EditorCursorSelect block;
+    struct EditorFolds folds;
+    struct HexView hex;
+    struct EditorWrap wrap;
+};
+
+int8_t buflist_create(struct EditorConfig* conf);
+int8_t buflist_destroy(struct EditorConfig* conf);
+
+/*
+ * opens path in a new buffer, reusing the current one if it is an empty
+ * unnamed buffer and switching to path if it is already open
+ */
+int8_t buflist_open(struct EditorConfig* conf, const char* path);
+int8_t buflist_close(struct EditorConfig* conf);
+
+int8_t buflist_switch(struct EditorConfig* conf, int32_t index);
+// same as buflist_switch without the status message, used by views
+int8_t buflist_select(struct EditorConfig* conf, int32_t index);
+// direction is 1 for the next buffer and -1 for the previous one
+int8_t buflist_cycle(struct EditorConfig* conf, int32_t direction);
+
+// first buffer with unsaved changes and its name, -1 when all are saved
+int32_t buflist_dirty(const struct EditorConfig* conf, const char** name);
+
+#endif
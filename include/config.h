@@ -7,10 +7,17 @@
 #include <termios.h>
 #include <time.h>
 
+#include "filewatch.h"
+#include "folds.h"
+#include "gutter.h"
+#include "hexview.h"
+#include "journal.h"
+#include "wrap.h"
+
 #define DEBUG_MODE 1
 
 #define SCOOM_VERSION 0.89
-#define TAB_SIZE 4
+#define TAB_SIZE 4  // default, SCOOM_TAB_SIZE overrides it
 #define QUIT_TIMES 3
 #define IDENT_SIZE 4
 
@@ -19,6 +26,12 @@
 
 struct Snapshot;
 struct DList;
+struct EditorLoop;
+struct EditorBuffer;
+struct EditorView;
+struct ViewNode;
+struct Arena;
+struct JournalWriter;
 
 struct EditorCursorSelect {
     int8_t active;
@@ -28,10 +41,41 @@ struct EditorCursorSelect {
     int32_t end_col;
 };
 
+// extra cursors on top of cx/cy, kept sorted by row then column
+struct EditorCursors {
+    struct EditorCursorSelect* items;
+    int32_t count;
+    int32_t cap;
+};
+
+/*
+ * Open documents, the current one lives directly in EditorConfig and its
+ * slot in items is only written back when switching away, see buflist.h
+ */
+struct EditorBufList {
+    struct EditorBuffer* items;
+    int32_t count;
+    int32_t cap;
+    int32_t current;
+};
+
+// split windows, the current view lives in EditorConfig too, see views.h
+struct EditorViews {
+    struct EditorView* items;
+    struct ViewNode* nodes;
+    int32_t count;
+    int32_t cap;
+    int32_t nnodes;  // node slots, free ones included
+    int32_t root;
+    int32_t current;
+    int32_t rows, cols;  // area the views are laid out in
+};
+
 struct EditorConfigFlags {
     int8_t is_dirty;
     int8_t resize_needed;
     int8_t program_state;  // 1-started or 0-finished
+    int8_t soft_wrap;      // rows wrap instead of scrolling sideways
 };
 
 struct EditorConfig {
@@ -40,20 +84,40 @@ struct EditorConfig {
     struct EditorSyntax* syntax;
     Stack* stack_undo;
     Stack* stack_redo;
+    struct EditorLoop* loop;
+    struct Arena* arena;  // owns rows of the current buffer
+    struct FileWatch file;  // on disk state of the current buffer
+    struct Journal journal;  // crash recovery log of the current buffer
 
-    time_t sbuf_time;
     time_t last_time_modified;
 
     int32_t cx, cy;
     int32_t rx;
-    int32_t screen_rows, screen_cols;
+    int32_t screen_rows, screen_cols;  // text area of the current view
+    int32_t screen_top, screen_left;
     int32_t rowoff, coloff;
     int32_t numrows;
+    int32_t tab_size;
 
     char status_msg[80];
+    int32_t status_timer;  // clears status_msg once it expires
+
+    int32_t inotify_fd;
+    int32_t filewatch_timer;  // debounces inotify events
+
+    struct JournalWriter* journal_writer;
+    int32_t journal_timer;  // hands journal logs to the writer
 
     struct EditorConfigFlags flags;
     struct EditorCursorSelect sel;
+    struct EditorCursors cursors;
+    struct EditorCursorSelect block;  // column selection, see block.h
+    struct EditorFolds folds;  // closed folds of the current buffer
+    struct HexView hex;  // replaces rows for binary files
+    struct EditorWrap wrap;  // visual line index of the current buffer
+    struct EditorGutter gutter;
+    struct EditorBufList buffers;
+    struct EditorViews views;
 };
 
 enum EditorCursorAnchor {
@@ -68,11 +132,17 @@ extern struct EditorConfig* g_conf;
 int8_t conf_create(struct EditorConfig* conf);
 int8_t conf_destroy(struct EditorConfig* conf);
 
+// per document state, everything a buffer stashes when switched away
+int8_t conf_create_document(struct EditorConfig* conf);
+int8_t conf_destroy_document(struct EditorConfig* conf);
+
 int8_t conf_select_update(struct EditorConfig* conf, int32_t start_row,
                           int32_t end_row, int32_t start_col, int32_t end_col);
 int8_t conf_to_snapshot_update(struct EditorConfig* conf,
                                struct Snapshot* snapshot);
 int8_t conf_destroy_rows(struct EditorConfig* conf);
+// re-renders every row, row->glyphs caches depend on the tab size
+int8_t conf_set_tab_size(struct EditorConfig* conf, int32_t tab_size);
 
 enum EditorCursorAnchor conf_check_cursor_anchor(struct EditorConfig* conf,
                                                  int32_t anchor_row,
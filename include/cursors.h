@@ -0,0 +1,49 @@
+#ifndef CURSORS_H
+#define CURSORS_H
+
+#include <stdint.h>
+
+struct EditorConfig;
+struct EditorCursorSelect;
+
+/*
+ * Extra cursors live in conf->cursors on top of the primary cx/cy one.
+ * Each of them is an EditorCursorSelect where end_row/end_col is the caret
+ * and start_row/start_col the anchor, columns are indexes into row->chars.
+ */
+
+int8_t cursors_add(struct EditorConfig* conf, int32_t row, int32_t col);
+int8_t cursors_add_vertical(struct EditorConfig* conf, int32_t direction);
+// one cursor per row in [from_row, to_row] at render column rx
+int8_t cursors_add_column(struct EditorConfig* conf, int32_t from_row,
+                          int32_t to_row, int32_t rx);
+int8_t cursors_clear(struct EditorConfig* conf);
+
+// pushes one undo snapshot for a whole batch, throttled like typing
+int8_t cursors_snapshot(struct EditorConfig* conf);
+
+// returns the first extra cursor on row, or NULL if there is none
+struct EditorCursorSelect* cursors_find_row(struct EditorConfig* conf,
+                                            int32_t row);
+
+/*
+ * applies key to every cursor in one pass over the touched rows
+ * returns EXIT_FAILURE if key isn't a multi cursor key
+ */
+int8_t editor_cursors_process_key(struct EditorConfig* conf, int32_t key);
+
+// tab, printable ASCII or the lead byte of a multibyte UTF-8 character
+static inline int8_t cursors_is_text_key(int32_t key) {
+    return key == '\t' || (key >= 32 && key < 127) ||
+           (key >= 0xC0 && key < 0xF8);
+}
+
+// inserts the len bytes of s at every cursor
+int8_t editor_cursors_insert(struct EditorConfig* conf, const char* s,
+                             int32_t len);
+// key and the rest of its UTF-8 sequence, see editor_read_glyph
+int8_t editor_cursors_insert_key(struct EditorConfig* conf, int32_t key);
+int8_t editor_cursors_delete_char(struct EditorConfig* conf);
+int8_t editor_cursors_move(struct EditorConfig* conf, int32_t key);
+
+#endif
@@ -19,7 +19,10 @@ struct Snapshot {
 int8_t snapshot_create(struct EditorConfig* conf, struct Snapshot* snapshot);
 int8_t snapshot_destroy(struct Snapshot* snapshot);
 
+// binaries, spotted by a NUL byte near the start, open in the hex view
 int8_t editor_open(struct EditorConfig* conf, const char* path);
+// switches a clean buffer between rows and the hex view, bound to F11
+int8_t editor_toggle_hex(struct EditorConfig* conf);
 int8_t editor_run(struct EditorConfig* conf);
 int8_t editor_destroy(struct EditorConfig* conf);
 int8_t editor_save(struct EditorConfig* conf);
@@ -29,6 +32,12 @@ int8_t editor_redo(struct EditorConfig* conf);
 
 int8_t editor_copy(struct EditorConfig* conf);
 int8_t editor_paste(struct EditorConfig* conf);
+/*
+ * inserts len bytes of text at the cursor in one pass
+ * returns the number of bytes pasted or -1
+ */
+int32_t editor_paste_text(struct EditorConfig* conf, const char* text,
+                          int32_t len);
 int8_t editor_cut(struct EditorConfig* conf);
 
 int8_t editor_find(struct EditorConfig* conf);
@@ -0,0 +1,45 @@
+#ifndef FILEWATCH_H
+#define FILEWATCH_H
+
+#include <stdint.h>
+#include <time.h>
+
+struct EditorConfig;
+
+#define FILEWATCH_DEBOUNCE_MS 50
+#define FILEWATCH_READ_CHUNK 65536
+
+/*
+ * What the buffer last knew about its file on disk. hashes holds one hash
+ * per line so a reload can keep the common head and tail of the buffer and
+ * only rebuild the rows in between. The index is only trusted while the
+ * buffer is clean, dirty buffers are never reloaded.
+ */
+struct FileWatch {
+    uint64_t* hashes;
+    int32_t count;
+    int32_t cap;
+
+    int64_t size;
+    struct timespec mtime;
+    int32_t tail_bytes;  // bytes of the last line if it has no '\n' yet
+
+    int32_t wd;  // inotify watch descriptor, -1 when not watched
+    int8_t pending;
+    int8_t follow;  // tail -f mode, only new bytes at the end are read
+};
+
+// one inotify instance shared by every buffer
+int8_t filewatch_create(struct EditorConfig* conf);
+int8_t filewatch_destroy(struct EditorConfig* conf);
+// hooks the inotify fd and the debounce timer into conf->loop
+int8_t filewatch_start(struct EditorConfig* conf);
+
+// per buffer, attach starts watching conf->filepath and indexes the rows
+int8_t filewatch_attach(struct EditorConfig* conf);
+int8_t filewatch_sync(struct EditorConfig* conf);
+int8_t filewatch_forget(struct EditorConfig* conf);
+
+int8_t filewatch_toggle_follow(struct EditorConfig* conf);
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef FOLDS_H
+#define FOLDS_H
+
+#include <stdint.h>
+
+struct EditorConfig;
+struct ABuf;
+
+// rows (start, end] are hidden, the header row start stays visible
+struct Fold {
+    int32_t start;
+    int32_t end;
+};
+
+/*
+ * Closed folds of a buffer, sorted and disjoint. Closing a fold around
+ * closed ones absorbs them, so nesting never has to be stored. before[i]
+ * counts the rows hidden by items[0..i), which lets visible lines and file
+ * rows be mapped both ways with one binary search instead of walking the
+ * hidden rows.
+ */
+struct EditorFolds {
+    struct Fold* items;
+    int32_t* before;
+    int32_t count;
+    int32_t cap;
+};
+
+int8_t folds_create(struct EditorConfig* conf);
+int8_t folds_destroy(struct EditorConfig* conf);
+int8_t folds_clear(struct EditorConfig* conf);
+
+/*
+ * closes the block starting at row, or opens it if row is a fold header.
+ * the block ends at the brace matching one that opens on row, otherwise
+ * it spans the rows indented deeper than row
+ */
+int8_t folds_toggle(struct EditorConfig* conf, int32_t row);
+
+// index of the fold hiding row, -1 if the row is visible
+int32_t folds_hidden(struct EditorConfig* conf, int32_t row);
+// index of the fold whose header is row, -1 if there is none
+int32_t folds_header(struct EditorConfig* conf, int32_t row);
+
+// hidden rows map to their fold header
+int32_t folds_visible_index(struct EditorConfig* conf, int32_t row);
+// indexes past the last visible line map past numrows
+int32_t folds_file_row(struct EditorConfig* conf, int32_t visible);
+// nearest visible row after (direction 1) or before (-1) row
+int32_t folds_next(struct EditorConfig* conf, int32_t row, int32_t direction);
+
+/*
+ * keeps folds in place when count rows are inserted at row at (count > 0)
+ * or removed from it (count < 0), folds the edit lands in are opened
+ */
+int8_t folds_shift(struct EditorConfig* conf, int32_t at, int32_t count);
+
+// "... n lines" after the text of a fold header, within cols columns
+int8_t folds_draw_header(struct EditorConfig* conf, struct ABuf* ab,
+                         int32_t row, int32_t cols);
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef GUTTER_H
+#define GUTTER_H
+
+#include <stdint.h>
+
+struct EditorConfig;
+struct ABuf;
+
+#define GUTTER_RELATIVE (1 << 0)  // distance to the cursor row
+#define GUTTER_MARKERS (1 << 1)   // column showing rows changed since save
+
+enum GutterMarker {
+    GUTTER_MARK_NONE = 0,
+    GUTTER_MARK_ADDED,
+    GUTTER_MARK_CHANGED
+};
+
+/*
+ * The gutter is drawn in its own pass left of the text, cursor positions
+ * never include it. Its width only depends on numrows so it is computed
+ * once per frame by gutter_update.
+ */
+struct EditorGutter {
+    int32_t digits;
+    int32_t width;  // total columns taken, including the separator
+    int8_t flags;
+};
+
+int8_t gutter_update(struct EditorConfig* conf);
+int8_t gutter_toggle(struct EditorConfig* conf, int8_t flag);
+int8_t gutter_draw_row(struct EditorConfig* conf, struct ABuf* ab,
+                       int32_t filerow);
+
+// columns left for text once the gutter is drawn
+int32_t gutter_text_cols(const struct EditorConfig* conf);
+
+int8_t gutter_clear_markers(struct EditorConfig* conf);
+
+#endif
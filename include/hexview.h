@@ -0,0 +1,61 @@
+#ifndef HEXVIEW_H
+#define HEXVIEW_H
+
+#include <stdint.h>
+
+struct EditorConfig;
+struct ABuf;
+
+#define HEXVIEW_SNIFF_SIZE 8192  // bytes checked for NUL on open
+
+struct HexPatch {
+    int64_t offset;
+    uint8_t byte;
+};
+
+/*
+ * Binary files are mmapped instead of split into rows, so opening a multi
+ * GB image costs nothing until pages get drawn. Only the lines on screen
+ * are formatted. Edits live in patches, sorted by offset, and a save
+ * writes just those bytes back in place. A patch that restores the
+ * original byte is dropped, so the map only holds real changes.
+ */
+struct HexView {
+    const uint8_t* map;  // NULL for empty files
+    int64_t size;
+    int32_t fd;
+    int8_t writable;
+    int8_t active;
+
+    int64_t cursor;  // byte offset
+    int64_t top;     // offset of the first byte on screen
+    int8_t nibble;   // 0 for the high half of the cursor byte, 1 for the low
+
+    struct HexPatch* patches;
+    int32_t count;
+    int32_t cap;
+};
+
+// 1 when the start of path holds a NUL byte
+int8_t hexview_detect(const char* path);
+
+int8_t hexview_init(struct EditorConfig* conf);
+int8_t hexview_open(struct EditorConfig* conf, const char* path);
+int8_t hexview_close(struct EditorConfig* conf);
+/*
+ * maps the file again when its size changed on disk, touching pages past
+ * the end of a truncated file would raise SIGBUS
+ */
+int8_t hexview_refresh(struct EditorConfig* conf);
+int8_t hexview_save(struct EditorConfig* conf);
+
+// returns EXIT_FAILURE for keys the hex view leaves to the editor
+int8_t hexview_process_key(struct EditorConfig* conf, int32_t c);
+
+int8_t hexview_scroll(struct EditorConfig* conf);
+int8_t hexview_draw_rows(struct EditorConfig* conf, struct ABuf* ab);
+// 0 based screen position of the cursor inside the current view
+int8_t hexview_cursor_position(struct EditorConfig* conf, int32_t* row,
+                               int32_t* col);
+
+#endif
@@ -28,10 +28,25 @@ struct EditorSyntax {
 
     char indent_start;
     char indent_end;
+
+    /*
+     * the specialized highlighter of a built-in language, NULL to go through
+     * the generic one driven by the fields above. Highlights row->render into
+     * a zeroed row->hl and returns whether the row ends in a comment
+     */
+    int8_t (*highlight)(struct Row* row, int8_t in_comment);
 };
 
 int8_t editor_syntax_highlight_select(struct EditorConfig* conf);
 int8_t editor_syntax_to_color_row(enum EditorHighlight row);
 int8_t editor_update_syntax(struct EditorConfig* conf, struct Row* row);
+int8_t editor_update_syntax_range(struct EditorConfig* conf, int32_t from,
+                                  int32_t to);
+
+// paints len render bytes of row starting at from, the next update_syntax
+// of the row washes it out again
+int8_t editor_highlight_paint(struct EditorConfig* conf, struct Row* row,
+                              int32_t from, int32_t len,
+                              enum EditorHighlight hl);
 
 #endif
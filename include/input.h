@@ -5,6 +5,10 @@
 struct EditorConfig;
 struct Row;
 
+#define INPUT_BUF_SIZE 4096
+#define ESC_SEQ_TIMEOUT_MS 25
+#define CSI_PARAM_MAX 9999
+
 enum EditorKey {
     BACKSPACE = 127,
 
@@ -23,6 +27,16 @@ enum EditorKey {
     CTRL_ARROW_RIGHT,
     CTRL_ARROW_LEFT,
 
+    ALT_ARROW_UP,
+    ALT_ARROW_DOWN,
+    ALT_ARROW_RIGHT,
+    ALT_ARROW_LEFT,
+
+    ALT_SHIFT_ARROW_UP,
+    ALT_SHIFT_ARROW_DOWN,
+    ALT_SHIFT_ARROW_RIGHT,
+    ALT_SHIFT_ARROW_LEFT,
+
     PAGE_UP,
     PAGE_DOWN,
 
@@ -43,6 +57,8 @@ enum EditorKey {
     F11,
     F12,
 
+    PASTE_START,
+    HANGUP,  // stdin hit EOF or POLLHUP, the editor has to exit
 };
 
 int8_t editor_set_status_message(struct EditorConfig *conf, const char *message,
@@ -55,7 +71,23 @@ int8_t editor_cursor_move(struct EditorConfig *conf, int32_t key);
 int8_t editor_shift_select(struct EditorConfig *conf, int32_t key);
 
 int32_t editor_read_key(struct EditorConfig *conf);
+/*
+ * copies key c and, when it is a UTF-8 lead byte, the continuation bytes
+ * already waiting behind it into glyph (UTF8_MAX_BYTES long). Returns how
+ * many bytes were written
+ */
+int32_t editor_read_glyph(struct EditorConfig *conf, int32_t c, char *glyph);
+// returns 1 if more keys are already waiting to be decoded
+int8_t editor_key_pending(struct EditorConfig *conf);
+/*
+ * collects everything up to the bracketed paste terminator into text
+ * should be called right after editor_read_key returned PASTE_START
+ */
+int8_t editor_read_paste(struct EditorConfig *conf, char **text,
+                         int32_t *len);
 int8_t editor_process_key_press(struct EditorConfig *conf);
+// event loop callback for stdin becoming readable
+void editor_on_input(struct EditorConfig *conf, void *data);
 
 int8_t editor_insert_newline(struct EditorConfig *conf);
 
@@ -0,0 +1,66 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stdint.h>
+
+struct EditorConfig;
+struct Row;
+
+#define JOURNAL_FLUSH_MS 250
+#define JOURNAL_COMPACT_SLACK 65536  // log bytes allowed past the snapshot
+
+enum JournalOp {
+    JOURNAL_OP_RESET = 1,  // drops every row
+    JOURNAL_OP_INSERT,     // inserts a row at `at`
+    JOURNAL_OP_SET,        // replaces the text of row `at`
+    JOURNAL_OP_DELETE      // removes `len` rows starting at `at`
+};
+
+/*
+ * Crash recovery log of one buffer, kept next to its file as .name.journal.
+ * A journal always starts with a snapshot of the whole buffer followed by
+ * row operations, so replaying it doesn't depend on the file on disk.
+ * Operations are collected in log and handed to a writer thread every
+ * JOURNAL_FLUSH_MS, which appends and fdatasyncs them off the input path.
+ * Once the log outgrows the snapshot it gets compacted into a new one.
+ * Unnamed buffers have no journal.
+ */
+struct Journal {
+    char* path;
+
+    char* log;  // operations not handed to the writer yet
+    int32_t len;
+    int32_t cap;
+
+    int64_t base;    // bytes of the last snapshot
+    int64_t logged;  // bytes appended since
+
+    int8_t snapshot;  // next flush rewrites the journal from the rows
+    int8_t on_disk;
+    int8_t recover;  // a journal from a crashed session is waiting
+};
+
+// the writer thread is shared by every buffer
+int8_t journal_create(struct EditorConfig* conf);
+int8_t journal_destroy(struct EditorConfig* conf);
+// arms the flush timer and offers to replay journals found on startup
+int8_t journal_start(struct EditorConfig* conf);
+// journals survive conf_destroy, used when the editor gets killed
+int8_t journal_preserve(struct EditorConfig* conf);
+
+// per buffer, attach also looks for a journal left by an earlier session
+int8_t journal_attach(struct EditorConfig* conf);
+// the buffer matches its file again, the journal is removed
+int8_t journal_clean(struct EditorConfig* conf);
+int8_t journal_forget(struct EditorConfig* conf);
+int8_t journal_recover(struct EditorConfig* conf);
+
+// called by the row primitives in rows.c
+void journal_log_reset(struct EditorConfig* conf);
+void journal_log_insert(struct EditorConfig* conf, int32_t at,
+                        const char* chars, int32_t len);
+void journal_log_set(struct EditorConfig* conf, int32_t at, const char* chars,
+                     int32_t len);
+void journal_log_delete(struct EditorConfig* conf, int32_t at, int32_t count);
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef LOOP_H
+#define LOOP_H
+
+#include <stdint.h>
+#include <time.h>
+
+struct EditorConfig;
+
+#define LOOP_MAX_WATCHES 32
+#define FRAME_INTERVAL_MS 16
+#define STATUS_MSG_TIMEOUT_MS 5000
+
+typedef void (*LoopCallback)(struct EditorConfig* conf, void* data);
+
+enum LoopWatchKind { WATCH_FD, WATCH_TIMER, WATCH_WAKEUP };
+
+struct LoopWatch {
+    int32_t fd;
+    enum LoopWatchKind kind;
+    LoopCallback callback;
+    void* data;
+};
+
+struct EditorLoop {
+    int32_t epfd;
+    int32_t sigfd;
+
+    int32_t frame_timer;
+    int8_t frame_pending;
+    int8_t running;
+    int32_t exit_signal;  // SIGTERM, SIGHUP or SIGINT that stopped the loop
+    struct timespec last_frame;
+
+    struct LoopWatch watches[LOOP_MAX_WATCHES];
+};
+
+int8_t loop_create(struct EditorLoop* loop);
+int8_t loop_destroy(struct EditorLoop* loop);
+
+/*
+ * every add function returns an id for the watch or -1 on failure
+ * fds passed to loop_watch_add stay owned by the caller
+ */
+int32_t loop_watch_add(struct EditorLoop* loop, int32_t fd,
+                       LoopCallback callback, void* data);
+int8_t loop_watch_remove(struct EditorLoop* loop, int32_t id);
+
+int32_t loop_timer_add(struct EditorLoop* loop, LoopCallback callback,
+                       void* data);
+// ms == 0 disarms the timer
+int8_t loop_timer_arm(struct EditorLoop* loop, int32_t id, int32_t ms,
+                      int8_t periodic);
+
+// wakeups can be signaled from any thread, callback runs on the loop thread
+int32_t loop_wakeup_add(struct EditorLoop* loop, LoopCallback callback,
+                        void* data);
+int8_t loop_wakeup_signal(struct EditorLoop* loop, int32_t id);
+
+void loop_request_frame(struct EditorLoop* loop);
+
+int8_t loop_run(struct EditorConfig* conf);
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+#include <time.h>
+
+struct EditorConfig;
+struct ABuf;
+
+// probes compile to nothing unless configured with -DSCOOM_PROFILE=ON
+#ifndef PROFILE_ENABLED
+#define PROFILE_ENABLED 0
+#endif
+
+#define PROFILE_FRAMES 128  // frames p50 and p99 are taken over
+
+enum ProfileMetric {
+    // nanoseconds per frame, a stage nested in another is taken out of it
+    PROFILE_INPUT,
+    PROFILE_EDIT,
+    PROFILE_HIGHLIGHT,
+    PROFILE_DRAW,
+    PROFILE_WRITE,
+    // counts per frame
+    PROFILE_BYTES,   // written to the terminal
+    PROFILE_ALLOCS,  // arena blocks and frame buffer growth
+    PROFILE_METRICS
+};
+
+#define PROFILE_TIMERS PROFILE_BYTES
+
+/*
+ * current collects the frame being built, it is pushed into history once
+ * the frame is on screen. active is the stage running right now so nested
+ * probes can take their time out of it
+ */
+struct Profile {
+    int64_t current[PROFILE_METRICS];
+    int64_t history[PROFILE_METRICS][PROFILE_FRAMES];
+    int32_t frames;  // pushed so far, history holds the last PROFILE_FRAMES
+    int8_t active;   // enum ProfileMetric or -1
+    int8_t visible;
+};
+
+struct ProfileProbe {
+    int64_t start;
+    int8_t stage;
+    int8_t parent;
+};
+
+// F1, shows or hides the overlay
+int8_t profile_toggle(struct EditorConfig* conf);
+// closes the frame that was just written to the terminal
+int8_t profile_frame_end(void);
+// overlay in the top right corner of the screen, on top of the views
+int8_t profile_draw(struct EditorConfig* conf, struct ABuf* ab);
+
+#if PROFILE_ENABLED
+
+extern struct Profile g_profile;
+
+static inline int64_t profile_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+static inline struct ProfileProbe profile_begin(int8_t stage) {
+    struct ProfileProbe probe = {profile_now(), stage, g_profile.active};
+    g_profile.active = stage;
+    return probe;
+}
+
+static inline void profile_end(struct ProfileProbe probe) {
+    int64_t elapsed = profile_now() - probe.start;
+    g_profile.current[probe.stage] += elapsed;
+    if (probe.parent != -1) g_profile.current[probe.parent] -= elapsed;
+    g_profile.active = probe.parent;
+}
+
+#define PROFILE_BEGIN(stage) \
+    struct ProfileProbe profile_probe_##stage = profile_begin(stage)
+#define PROFILE_END(stage) profile_end(profile_probe_##stage)
+#define PROFILE_COUNT(metric, n) (g_profile.current[metric] += (n))
+
+#else
+
+#define PROFILE_BEGIN(stage)
+#define PROFILE_END(stage)
+#define PROFILE_COUNT(metric, n) ((void)0)
+
+#endif
+
+#endif
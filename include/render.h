@@ -10,7 +10,11 @@ int8_t editor_refresh_screen(struct EditorConfig *conf);
 int8_t editor_scroll(struct EditorConfig *conf);
 
 int8_t editor_draw_messagebar(struct EditorConfig *conf, struct ABuf *ab);
-int8_t editor_draw_statusbar(struct EditorConfig *conf, struct ABuf *ab);
+int8_t editor_draw_statusbar(struct EditorConfig *conf, struct ABuf *ab,
+                             int8_t active);
 int8_t editor_draw_rows(struct EditorConfig *conf, struct ABuf *ab);
 
+// event loop callback clearing the status message
+void editor_on_status_expire(struct EditorConfig *conf, void *data);
+
 #endif
\ No newline at end of file
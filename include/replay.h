@@ -0,0 +1,45 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+
+struct EditorConfig;
+
+#define REPLAY_MAGIC "scoom-replay 1"
+
+/*
+ * SCOOM_RECORD=<file> saves every chunk of input as it comes off stdin with
+ * the microsecond it arrived at, SCOOM_REPLAY=<file> plays one back headless.
+ * Chunks go through the regular decoder, so keys, pastes and multibyte
+ * characters come out exactly as they did, and escape sequence timeouts are
+ * judged against the recorded times instead of the wall clock. The replay
+ * edits and saves like the recorded session did, run it on a copy. Frames
+ * are drawn into a vterm, SCOOM_REPLAY_SCREEN=<file> saves the last one.
+ *
+ * file: REPLAY_MAGIC <rows> <cols>\n then per chunk <usec> <len>\n<bytes>\n
+ */
+
+int8_t replay_record_start(struct EditorConfig* conf, const char* path);
+int8_t replay_record_stop(void);
+// called by the input layer with every chunk read from stdin
+void replay_record(const unsigned char* bytes, int32_t len);
+
+// switches the terminal to a vterm sized like the recorded one
+int8_t replay_open(const char* path);
+int8_t replay_active(void);
+/*
+ * stands in for reading stdin: bytes of the next chunk if it arrived within
+ * timeout_ms of the previous one, 0 otherwise and -1 once the recording is
+ * over, which the input layer treats as a hangup
+ */
+int32_t replay_read(unsigned char* buf, int32_t cap, int32_t timeout_ms);
+
+/*
+ * feeds the recording through editor_process_key_press the way the event
+ * loop would, drawing a frame after every batch of keys. Prints latency per
+ * key and per frame plus throughput to stdout once it runs out, then returns
+ * so the editor shuts down the usual way
+ */
+int8_t replay_run(struct EditorConfig* conf);
+
+#endif
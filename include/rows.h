@@ -9,20 +9,56 @@ struct EditorConfig;
 enum EditorHighlight;
 enum EditorKey;
 
+/*
+ * a tab or multibyte character, the spots where bytes stop matching screen
+ * columns. cx, ri and rx are where it starts in chars, render and on screen
+ */
+struct RowGlyph {
+    int32_t cx;
+    int32_t ri;
+    int32_t rx;
+    int16_t rlen;   // bytes in render
+    int16_t width;  // columns on screen
+    int8_t len;     // bytes in chars
+};
+
+/*
+ * render is chars itself when the row has no tabs and is plain ASCII, most
+ * rows of space indented code, see render_shared. hl packs two highlight
+ * classes per byte, low nibble first, and is NULL when the whole row is
+ * HL_NORMAL. Read it through editor_row_hl.
+ *
+ * Rows are memmoved on every insert and streamed by search, save and draw,
+ * so the fields every scan reads come first and the whole row fits a 64 byte
+ * cache line. Its index is its position in conf->rows, row - conf->rows
+ */
 struct Row {
     char* chars;
     char* render;
     unsigned char* hl;  // stands for highlighting
-
-    int32_t indentation;
     int32_t size;
     int32_t rsize;
 
-    int32_t idx;
-    int8_t hl_open_comment;
+    struct RowGlyph* glyphs;  // rebuilt along with render, NULL for plain
+                              // ASCII rows without tabs
+    int32_t* breaks;          // soft wrap segment starts, see wrap.h
+    int32_t rwidth;           // columns render takes on screen
+    int32_t nglyphs;
+    int32_t nbreaks;
+    int16_t wrap_width;  // width breaks were computed for, 0 when stale
+
+    uint8_t hl_open_comment : 1;
+    uint8_t render_shared : 1;  // render aliases chars, never free it
+    uint8_t marker : 2;  // enum GutterMarker, reset on open and save
 };
 
-int8_t editor_free_row(struct Row* row);
+// highlight class of render byte i, 0 is HL_NORMAL
+static inline uint8_t editor_row_hl(const struct Row* row, int32_t i) {
+    if (!row->hl) return 0;
+    return (row->hl[i >> 1] >> ((i & 1) << 2)) & 0x0F;
+}
+
+int8_t editor_free_row(struct EditorConfig* conf, struct Row* row);
 int8_t editor_insert_row_char(struct EditorConfig* conf, struct Row* row,
                               int32_t at, int32_t c);
 int8_t editor_delete_row_char(struct EditorConfig* conf, struct Row* row,
@@ -30,8 +66,29 @@ int8_t editor_delete_row_char(struct EditorConfig* conf, struct Row* row,
 int8_t editor_insert_row(struct EditorConfig* conf, int32_t at,
                          const char* content, int32_t content_size);
 
+/*
+ * splices count rows in at index at with a single shift of the rows after
+ * it, highlighting runs once over the block after every row is in place
+ */
+int8_t editor_insert_rows(struct EditorConfig* conf, int32_t at,
+                          const char** lines, const int32_t* lens,
+                          int32_t count);
+
+/*
+ * splits text on '\n' into lines pointing into it, trailing '\r' are
+ * dropped and the last line only counts if it isn't empty. Used by both
+ * loading and reloading so they agree on what the rows of a file are
+ */
+int32_t editor_split_lines(const char* text, int64_t len, const char*** lines,
+                           int32_t** lens);
+
 int8_t editor_update_row(struct EditorConfig* conf, struct Row* row);
+// same without marking or journaling the row, its text didn't change
+int8_t editor_retab_row(struct EditorConfig* conf, struct Row* row);
 int8_t editor_delete_row(struct EditorConfig* conf, int32_t at);
+// removes rows [at, at + count) with a single shift of the rows after them
+int8_t editor_delete_rows(struct EditorConfig* conf, int32_t at,
+                          int32_t count);
 
 int8_t editor_insert_char(struct EditorConfig* conf, int32_t c);
 int8_t editor_delete_char(struct EditorConfig* conf);
@@ -50,10 +107,23 @@ int8_t editor_row_append_string(struct EditorConfig* conf, struct Row* row,
  */
 int8_t editor_row_indent(struct EditorConfig* conf, struct Row* row,
                          char** newline, int32_t* len);
+// tabs in the row, what a new line below it starts with
+int32_t editor_row_indentation(const struct Row* row);
 
+/*
+ * every conversion binary searches row->glyphs, so plain ASCII rows are O(1)
+ * and the rest O(log glyphs). Columns inside a wide character or a tab map
+ * back to where it starts
+ */
 int32_t editor_update_cx_rx(struct Row* row, int32_t cx);
 int32_t editor_update_rx_cx(struct Row* row, int32_t rx);
+// render bytes and screen columns, a column inside a wide character maps
+// to the byte after it
+int32_t editor_row_ri_rx(struct Row* row, int32_t ri);
+int32_t editor_row_rx_ri(struct Row* row, int32_t rx);
 
-int32_t editor_row_numline_calculate(const struct Row* row);
+// chars index of the next or previous character, combining marks included
+int32_t editor_row_next_cx(struct Row* row, int32_t cx);
+int32_t editor_row_prev_cx(struct Row* row, int32_t cx);
 
 #endif
\ No newline at end of file
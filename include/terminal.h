@@ -6,14 +6,39 @@ struct EditorConfig;
 
 #define SCROLL_DISABLE 1
 #define MOUSE_REPORTING 0
+#define BRACKETED_PASTE 1
 
 extern struct termios orig_termios;
 
+/*
+ * Everything the editor does to the terminal goes through a backend: the
+ * tty on stdin/stdout by default, or the in-memory vterm replays and tests
+ * draw into. create and destroy set it up and restore it, get_size reports
+ * rows x cols including the message bar row
+ */
+struct TermBackend {
+    const char* name;
+    int8_t (*create)(void);
+    void (*destroy)(void);
+    int8_t (*get_size)(int32_t* rows, int32_t* cols);
+    int32_t (*write)(const char* buf, int32_t len);
+};
+
+extern const struct TermBackend term_tty;
+
+// has to be picked before conf_create asks for the window size
+int8_t term_set_backend(const struct TermBackend* backend);
+const struct TermBackend* term_get_backend(void);
+
 void term_create(void);
 void term_exit(int32_t sig);
 
 int8_t term_get_window_size(struct EditorConfig* conf, int32_t* rows,
                             int32_t* cols);
 int8_t term_get_cursor_position(int32_t* rows, int32_t* cols);
+// refreshes screen_rows/screen_cols after the terminal got resized
+int8_t term_resize(struct EditorConfig* conf);
+
+int32_t term_write(const char* buf, int32_t len);
 
 #endif
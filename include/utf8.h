@@ -0,0 +1,25 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <stdint.h>
+
+#define UTF8_MAX_BYTES 4
+
+// 1 when no byte of s has its high bit set, checked 16 bytes at a time
+int8_t utf8_is_ascii(const char* s, int32_t len);
+
+static inline int8_t utf8_is_continuation(char c) {
+    return ((unsigned char)c & 0xC0) == 0x80;
+}
+
+/*
+ * bytes taken by the well formed sequence at the start of s, 0 when it is
+ * truncated, overlong, a surrogate or out of range. Its code point goes in
+ * cp
+ */
+int32_t utf8_decode(const char* s, int32_t len, uint32_t* cp);
+
+// columns a code point takes on screen: 0 for combining marks, 2 for wide
+int32_t utf8_width(uint32_t cp);
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef VIEWS_H
+#define VIEWS_H
+
+#include <stdint.h>
+
+#include "config.h"
+
+struct ABuf;
+
+enum ViewNodeKind {
+    VIEW_NODE_FREE = 0,
+    VIEW_NODE_LEAF,
+    VIEW_NODE_HSPLIT,  // children stacked top and bottom
+    VIEW_NODE_VSPLIT   // children side by side with a separator column
+};
+
+/*
+ * Splits form a binary tree, leaves hold one view each. Nodes keep the
+ * rect they were laid out with so separators can be drawn from them.
+ */
+struct ViewNode {
+    int8_t kind;
+    int32_t parent;
+    int32_t child[2];
+    int32_t view;  // leaves only
+
+    int32_t top, left;
+    int32_t height, width;
+};
+
+/*
+ * A view is a window on one buffer with its own viewport, cursor and
+ * selection. Views on the same buffer render the same rows, so render and
+ * hl data is shared. Like buffers, the current view lives in EditorConfig
+ * and is only written back to its slot when another view gets loaded.
+ */
+struct EditorView {
+    int32_t top, left;      // 0 based screen position
+    int32_t height, width;  // height includes the view's status bar
+    int32_t node;
+    int32_t buffer;
+
+    int32_t cx, cy;
+    int32_t rx;
+    int32_t rowoff, coloff;
+    struct EditorCursorSelect sel;
+};
+
+// one view covering rows x cols, the area above the message bar
+int8_t views_create(struct EditorConfig* conf, int32_t rows, int32_t cols);
+int8_t views_destroy(struct EditorConfig* conf);
+int8_t views_layout(struct EditorConfig* conf, int32_t rows, int32_t cols);
+
+// kind is VIEW_NODE_HSPLIT or VIEW_NODE_VSPLIT, focus moves to the new view
+int8_t views_split(struct EditorConfig* conf, int8_t kind);
+int8_t views_close(struct EditorConfig* conf);
+int8_t views_cycle(struct EditorConfig* conf, int32_t direction);
+
+// keeps buffer indexes of the views valid after buflist_close
+int8_t views_buffer_closed(struct EditorConfig* conf, int32_t index);
+
+// draws every view and the separators between them into ab
+int8_t views_draw(struct EditorConfig* conf, struct ABuf* ab);
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef VTERM_H
+#define VTERM_H
+
+#include <stdint.h>
+
+#include "terminal.h"
+
+#define VTERM_ATTR_BOLD 1
+#define VTERM_ATTR_DIM 2
+#define VTERM_ATTR_REVERSE 4
+
+#define VTERM_SEQ_MAX 32  // longest escape sequence kept, the rest is dropped
+
+struct VTermCell {
+    uint32_t cp;    // ' ' when blank, 0 on the right half of a wide glyph
+    uint8_t fg;     // SGR foreground 30-37 or 90-97, 0 for the default
+    uint8_t attrs;  // VTERM_ATTR_*
+};
+
+struct VTermStats {
+    int64_t bytes;      // everything written to the terminal
+    int64_t sequences;  // escape sequences parsed
+    int64_t unknown;    // sequences the vterm doesn't implement
+    int64_t glyphs;     // cells printed to, wide glyphs count once
+};
+
+/*
+ * An in-memory terminal for running without a tty: the frames the editor
+ * writes are parsed into a rows x cols grid of cells the way an xterm
+ * would, cursor addressing, erases, SGR colours and attributes, autowrap
+ * and UTF-8 included. Modes it has no use for (alternate screen, bracketed
+ * paste, mouse, cursor shape) are accepted and ignored. Queries like
+ * <esc>[6n get no reply
+ */
+extern const struct TermBackend term_vterm;
+
+// allocates the grid, term_set_backend(&term_vterm) makes the editor use it
+int8_t vterm_create(int32_t rows, int32_t cols);
+void vterm_destroy(void);
+
+// parses len bytes of output, what term_write does with the vterm backend
+int32_t vterm_write(const char* buf, int32_t len);
+
+const struct VTermCell* vterm_cell(int32_t row, int32_t col);
+// 0 based, returns whether the cursor is shown
+int8_t vterm_cursor(int32_t* row, int32_t* col);
+const struct VTermStats* vterm_stats(void);
+
+/*
+ * row as UTF-8 without trailing blanks, NUL terminated and cut at cap.
+ * Returns its length
+ */
+int32_t vterm_row_text(int32_t row, char* buf, int32_t cap);
+// every row of the screen, one per line, to path
+int8_t vterm_dump(const char* path);
+
+#endif
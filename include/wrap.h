@@ -0,0 +1,62 @@
+#ifndef WRAP_H
+#define WRAP_H
+
+#include <stdint.h>
+
+struct EditorConfig;
+struct Row;
+
+/*
+ * Soft wrap splits rows into visual lines at the last space that fits,
+ * or mid word when there is none. Each row caches its break points for
+ * the width they were computed at, so after a resize only rows longer
+ * than the new width get wrapped again. A Fenwick tree over the visual
+ * lines of every row maps visual lines to (row, segment) and back in
+ * O(log n). Folded rows count as zero lines. Inserting or deleting rows
+ * invalidates the tree and it is rebuilt on the next lookup, while edits
+ * inside a row update it in place.
+ */
+struct WrapIndex {
+    int32_t* tree;   // 1 based
+    int32_t* lines;  // visual lines of each row
+    int32_t count;   // rows indexed
+    int32_t cap;
+    int32_t width;  // text columns the index was built for, 0 when unused
+    int8_t valid;
+};
+
+// views on one buffer can differ in width, each width keeps its own index
+#define WRAP_WIDTHS 4
+
+struct EditorWrap {
+    struct WrapIndex index[WRAP_WIDTHS];
+    int32_t next;  // slot taken over once every slot holds another width
+};
+
+int8_t wrap_create(struct EditorConfig* conf);
+int8_t wrap_destroy(struct EditorConfig* conf);
+int8_t wrap_toggle(struct EditorConfig* conf);
+
+void wrap_invalidate(struct EditorConfig* conf);
+// the text of row changed, only its own count is updated
+int8_t wrap_update_row(struct EditorConfig* conf, struct Row* row);
+
+// segment of row holding render column rx and its column range
+int32_t wrap_row_segment(struct EditorConfig* conf, struct Row* row,
+                         int32_t rx);
+int32_t wrap_segment_start(struct Row* row, int32_t segment);
+int32_t wrap_segment_end(struct Row* row, int32_t segment);
+
+int32_t wrap_visual_line(struct EditorConfig* conf, int32_t row, int32_t rx);
+// row of a visual line, numrows past the last one
+int32_t wrap_locate(struct EditorConfig* conf, int32_t line,
+                    int32_t* segment);
+
+// first visual line on screen, coloff holds the segment of rowoff it shows
+int32_t wrap_screen_top(struct EditorConfig* conf);
+// puts the cursor at the start of a visual line
+int8_t wrap_cursor_to_line(struct EditorConfig* conf, int32_t line);
+// moves the cursor one visual line up (-1) or down (1)
+int8_t wrap_move(struct EditorConfig* conf, int32_t direction);
+
+#endif
@@ -0,0 +1,175 @@
+#include "alloc.h"
+
+#include <stdio.h>
+
+#if ALLOC_TRACKING
+
+#include <malloc.h>
+#include <pthread.h>
+
+struct AllocSite {
+    const char* file;  // __FILE__ of the call, NULL for a free slot
+    int32_t line;
+    int64_t calls;
+    int64_t bytes;
+    int64_t sizes[ALLOC_BUCKETS];
+};
+
+struct AllocStats {
+    int64_t calls;
+    int64_t frees;
+    int64_t bytes;  // requested over the whole run
+    int64_t live;   // usable bytes held right now
+    int64_t peak;
+    int32_t nsites;
+    struct AllocSite sites[ALLOC_SITES];
+};
+
+// cheap next to malloc itself, and the counts stay right off the main thread
+static pthread_mutex_t alloc_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct AllocStats alloc_stats;
+
+static int32_t alloc_bucket(size_t size) {
+    int32_t bucket = 0;
+    for (size_t limit = 16; size > limit && bucket < ALLOC_BUCKETS - 1;
+         limit <<= 1)
+        bucket++;
+    return bucket;
+}
+
+// open addressing on the file pointer and line, NULL once the table is full
+static struct AllocSite* alloc_site(const char* file, int32_t line) {
+    uint32_t hash = (uint32_t)(uintptr_t)file * 31u + (uint32_t)line;
+    hash *= 2654435761u;
+
+    for (int32_t probe = 0; probe < ALLOC_SITES; probe++) {
+        struct AllocSite* site =
+            &alloc_stats.sites[(hash + probe) % ALLOC_SITES];
+        if (site->file == file && site->line == line) return site;
+        if (!site->file) {
+            site->file = file;
+            site->line = line;
+            alloc_stats.nsites++;
+            return site;
+        }
+    }
+    return NULL;
+}
+
+// freed is the usable size the call gave back, realloc frees and allocates
+static void alloc_record(void* ptr, size_t size, size_t freed,
+                         const char* file, int32_t line) {
+    if (!ptr) return;
+
+    pthread_mutex_lock(&alloc_lock);
+    alloc_stats.calls++;
+    alloc_stats.bytes += size;
+    alloc_stats.live += malloc_usable_size(ptr) - freed;
+    if (alloc_stats.live > alloc_stats.peak)
+        alloc_stats.peak = alloc_stats.live;
+
+    struct AllocSite* site = alloc_site(file, line);
+    if (site) {
+        site->calls++;
+        site->bytes += size;
+        site->sizes[alloc_bucket(size)]++;
+    }
+    pthread_mutex_unlock(&alloc_lock);
+}
+
+void* alloc_tracked_malloc(size_t size, const char* file, int32_t line) {
+    void* ptr = malloc(size);
+    alloc_record(ptr, size, 0, file, line);
+    return ptr;
+}
+
+void* alloc_tracked_realloc(void* ptr, size_t size, const char* file,
+                            int32_t line) {
+    size_t freed = ptr ? malloc_usable_size(ptr) : 0;
+    void* new_ptr = realloc(ptr, size);
+    alloc_record(new_ptr, size, freed, file, line);
+    return new_ptr;
+}
+
+char* alloc_tracked_strdup(const char* s, const char* file, int32_t line) {
+    char* copy = strdup(s);
+    alloc_record(copy, strlen(s) + 1, 0, file, line);
+    return copy;
+}
+
+int alloc_tracked_memalign(void** ptr, size_t align, size_t size,
+                           const char* file, int32_t line) {
+    int res = posix_memalign(ptr, align, size);
+    if (res == 0) alloc_record(*ptr, size, 0, file, line);
+    return res;
+}
+
+void alloc_free(void* ptr) {
+    if (!ptr) return;
+
+    pthread_mutex_lock(&alloc_lock);
+    alloc_stats.frees++;
+    alloc_stats.live -= malloc_usable_size(ptr);
+    pthread_mutex_unlock(&alloc_lock);
+
+    free(ptr);
+}
+
+static int alloc_site_compare(const void* a, const void* b) {
+    const struct AllocSite* x = a;
+    const struct AllocSite* y = b;
+    return (x->calls < y->calls) - (x->calls > y->calls);
+}
+
+int8_t alloc_report_write(void) {
+    const char* path = getenv("SCOOM_ALLOC_REPORT");
+    FILE* fp = fopen(path ? path : ALLOC_REPORT_PATH, "w");
+    if (!fp) return EXIT_FAILURE;
+
+    pthread_mutex_lock(&alloc_lock);
+    struct AllocStats stats = alloc_stats;
+    pthread_mutex_unlock(&alloc_lock);
+
+    fprintf(fp,
+            "calls %lld  frees %lld  requested %lld  live %lld  peak %lld\n",
+            (long long)stats.calls, (long long)stats.frees,
+            (long long)stats.bytes, (long long)stats.live,
+            (long long)stats.peak);
+
+    // busiest sites first
+    qsort(stats.sites, ALLOC_SITES, sizeof(struct AllocSite),
+          alloc_site_compare);
+
+    fprintf(fp, "\n%-24s %10s %12s", "site", "calls", "bytes");
+    static const char* buckets[ALLOC_BUCKETS] = {
+        "16", "32", "64", "128", "256", "512",
+        "1K", "2K", "4K", "8K",  "16K", "more"};
+    for (int32_t b = 0; b < ALLOC_BUCKETS; b++)
+        fprintf(fp, " %8s", buckets[b]);
+    fprintf(fp, "\n");
+
+    for (int32_t i = 0; i < stats.nsites; i++) {
+        const struct AllocSite* site = &stats.sites[i];
+        const char* name = strrchr(site->file, '/');
+
+        char where[64];
+        snprintf(where, sizeof(where), "%s:%d", name ? name + 1 : site->file,
+                 site->line);
+        fprintf(fp, "%-24s %10lld %12lld", where, (long long)site->calls,
+                (long long)site->bytes);
+        for (int32_t b = 0; b < ALLOC_BUCKETS; b++)
+            fprintf(fp, " %8lld", (long long)site->sizes[b]);
+        fprintf(fp, "\n");
+    }
+
+    fclose(fp);
+    return EXIT_SUCCESS;
+}
+
+#else
+
+void alloc_free(void* ptr) { free(ptr); }
+
+int8_t alloc_report_write(void) { return EXIT_FAILURE; }
+
+#endif
@@ -0,0 +1,171 @@
+#include "arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "alloc.h"
+#include "core.h"
+#include "profile.h"
+
+#define ARENA_LARGE_CLASS -1
+
+/*
+    sits at the start of every chunk, the data after it starts on a cache
+    line so big arrays like conf->rows don't split rows across two. prev is
+    only kept for large chunks, which are freed one by one
+*/
+struct ArenaChunk {
+    struct ArenaChunk* prev;
+    struct ArenaChunk* next;
+    int64_t size_class;  // index into free_lists or ARENA_LARGE_CLASS
+    int64_t size;        // usable bytes of a large chunk
+    _Alignas(64) char data[];
+};
+
+#define ARENA_SLAB_DATA (ARENA_CHUNK_SIZE - sizeof(struct ArenaChunk))
+
+// powers of two with a step half way, blocks waste at most a third
+static const uint32_t arena_class_size[ARENA_CLASSES] = {
+    8,   16,  24,  32,  48,   64,   96,   128,  192,
+    256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096};
+
+static int32_t arena_size_class(size_t size) {
+    if (size > arena_class_size[ARENA_CLASSES - 1]) return ARENA_CLASSES;
+
+    int32_t lo = 0, hi = ARENA_CLASSES - 1;
+    while (lo < hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if (arena_class_size[mid] < size)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static struct ArenaChunk* arena_chunk_of(void* ptr) {
+    return (struct ArenaChunk*)((uintptr_t)ptr &
+                                ~(uintptr_t)(ARENA_CHUNK_SIZE - 1));
+}
+
+static struct ArenaChunk* arena_chunk_new(size_t size) {
+    void* chunk;
+    if (alloc_memalign(&chunk, ARENA_CHUNK_SIZE, size) != 0)
+        die("arena chunk alloc failed");
+    return chunk;
+}
+
+int8_t arena_create(struct Arena* arena) {
+    arena->chunks = NULL;
+    arena->large = NULL;
+    for (int32_t i = 0; i < ARENA_CLASSES; i++) {
+        arena->free_lists[i] = NULL;
+        arena->slabs[i] = NULL;
+        arena->slab_used[i] = 0;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int8_t arena_destroy(struct Arena* arena) {
+    while (arena->chunks) {
+        struct ArenaChunk* next = arena->chunks->next;
+        alloc_free(arena->chunks);
+        arena->chunks = next;
+    }
+    while (arena->large) {
+        struct ArenaChunk* next = arena->large->next;
+        alloc_free(arena->large);
+        arena->large = next;
+    }
+
+    return arena_create(arena);
+}
+
+static void* arena_alloc_large(struct Arena* arena, size_t size) {
+    struct ArenaChunk* large =
+        arena_chunk_new(sizeof(struct ArenaChunk) + size);
+
+    large->prev = NULL;
+    large->next = arena->large;
+    if (arena->large) arena->large->prev = large;
+    arena->large = large;
+
+    large->size_class = ARENA_LARGE_CLASS;
+    large->size = size;
+
+    return large->data;
+}
+
+void* arena_alloc(struct Arena* arena, size_t size) {
+    PROFILE_COUNT(PROFILE_ALLOCS, 1);
+    if (size == 0) size = 1;
+
+    int32_t size_class = arena_size_class(size);
+    if (size_class >= ARENA_CLASSES) return arena_alloc_large(arena, size);
+
+    // free list links are stored inside the freed blocks themselves
+    void* ptr = arena->free_lists[size_class];
+    if (ptr) {
+        arena->free_lists[size_class] = *(void**)ptr;
+        return ptr;
+    }
+
+    uint32_t block_size = arena_class_size[size_class];
+    struct ArenaChunk* slab = arena->slabs[size_class];
+    if (!slab || arena->slab_used[size_class] + block_size > ARENA_SLAB_DATA) {
+        slab = arena_chunk_new(ARENA_CHUNK_SIZE);
+        slab->prev = NULL;
+        slab->next = arena->chunks;
+        slab->size_class = size_class;
+        slab->size = 0;
+        arena->chunks = slab;
+
+        arena->slabs[size_class] = slab;
+        arena->slab_used[size_class] = 0;
+    }
+
+    ptr = &slab->data[arena->slab_used[size_class]];
+    arena->slab_used[size_class] += block_size;
+
+    return ptr;
+}
+
+void arena_free(struct Arena* arena, void* ptr) {
+    if (!ptr) return;
+
+    struct ArenaChunk* chunk = arena_chunk_of(ptr);
+    if (chunk->size_class == ARENA_LARGE_CLASS) {
+        if (chunk->prev)
+            chunk->prev->next = chunk->next;
+        else
+            arena->large = chunk->next;
+        if (chunk->next) chunk->next->prev = chunk->prev;
+        alloc_free(chunk);
+        return;
+    }
+
+    *(void**)ptr = arena->free_lists[chunk->size_class];
+    arena->free_lists[chunk->size_class] = ptr;
+}
+
+void* arena_realloc(struct Arena* arena, void* ptr, size_t size) {
+    if (!ptr) return arena_alloc(arena, size);
+
+    struct ArenaChunk* chunk = arena_chunk_of(ptr);
+    size_t old_size = chunk->size_class == ARENA_LARGE_CLASS
+                          ? (size_t)chunk->size
+                          : arena_class_size[chunk->size_class];
+    if (old_size >= size) return ptr;
+
+    // large blocks can't be grown in place, they double so a row array
+    // growing one row at a time isn't copied every time. Pages of the slack
+    // are never touched until used
+    if (chunk->size_class == ARENA_LARGE_CLASS) size *= 2;
+
+    void* new_ptr = arena_alloc(arena, size);
+    memcpy(new_ptr, ptr, old_size);
+    arena_free(arena, ptr);
+
+    return new_ptr;
+}
@@ -0,0 +1,243 @@
+#include "block.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "core.h"
+#include "cursors.h"
+#include "input.h"
+#include "rows.h"
+
+#define BLOCK_IOV_BATCH 512
+
+static int32_t block_top(const struct EditorConfig* conf) {
+    return min(conf->block.start_row, conf->block.end_row);
+}
+
+static int32_t block_bottom(const struct EditorConfig* conf) {
+    return max(conf->block.start_row, conf->block.end_row);
+}
+
+static int32_t block_left(const struct EditorConfig* conf) {
+    return min(conf->block.start_col, conf->block.end_col);
+}
+
+static int32_t block_right(const struct EditorConfig* conf) {
+    return max(conf->block.start_col, conf->block.end_col);
+}
+
+// render column of the primary cursor
+static int32_t cursor_text_rx(struct EditorConfig* conf) {
+    return editor_update_cx_rx(&conf->rows[conf->cy], conf->cx);
+}
+
+int8_t editor_block_extend(struct EditorConfig* conf, int32_t key) {
+    if (conf->cy >= conf->numrows) return EXIT_FAILURE;
+
+    struct EditorCursorSelect* block = &conf->block;
+    if (!block->active) {
+        int32_t rx = cursor_text_rx(conf);
+        block->active = 1;
+        block->start_row = block->end_row = conf->cy;
+        block->start_col = block->end_col = rx;
+    }
+
+    // the block keeps its column even when passing over shorter rows
+    switch (key) {
+        case ALT_SHIFT_ARROW_UP:
+            if (block->end_row > 0) block->end_row--;
+            break;
+        case ALT_SHIFT_ARROW_DOWN:
+            if (block->end_row < conf->numrows - 1) block->end_row++;
+            break;
+        case ALT_SHIFT_ARROW_LEFT:
+            if (block->end_col > 0) block->end_col--;
+            break;
+        case ALT_SHIFT_ARROW_RIGHT: {
+            int32_t widest = 0;
+            for (int32_t i = block_top(conf); i <= block_bottom(conf); i++) {
+                widest = max(widest, conf->rows[i].rwidth);
+            }
+            if (block->end_col < widest) block->end_col++;
+            break;
+        }
+        default:
+            return EXIT_FAILURE;
+    }
+
+    struct Row* row = &conf->rows[block->end_row];
+    conf->cy = block->end_row;
+    conf->cx = editor_update_rx_cx(row, block->end_col);
+
+    return EXIT_SUCCESS;
+}
+
+int8_t editor_block_clear(struct EditorConfig* conf) {
+    conf->block.active = 0;
+    conf->block.start_row = conf->block.end_row = -1;
+    conf->block.start_col = conf->block.end_col = -1;
+    return EXIT_SUCCESS;
+}
+
+int8_t block_contains(const struct EditorConfig* conf, int32_t row,
+                      int32_t rx) {
+    if (!conf->block.active) return 0;
+    return block_top(conf) <= row && row <= block_bottom(conf) &&
+           block_left(conf) <= rx && rx < block_right(conf);
+}
+
+int32_t block_rows(const struct EditorConfig* conf) {
+    if (!conf->block.active) return 0;
+    return block_bottom(conf) - block_top(conf) + 1;
+}
+
+int8_t block_spans(struct EditorConfig* conf, struct BlockSpan* spans) {
+    int32_t top = block_top(conf);
+    int32_t left = block_left(conf);
+    int32_t right = block_right(conf);
+
+    for (int32_t i = 0; i < block_rows(conf); i++) {
+        struct Row* row = &conf->rows[top + i];
+        spans[i].start = editor_update_rx_cx(row, left);
+        spans[i].end = editor_update_rx_cx(row, right);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// writev wrapper that carries on after partial writes
+static int8_t write_iov_all(int32_t fd, struct iovec* iov, int32_t iovcnt) {
+    while (iovcnt > 0) {
+        ssize_t written = writev(fd, iov, iovcnt);
+        if (written == -1) {
+            if (errno == EINTR) continue;
+            return EXIT_FAILURE;
+        }
+
+        while (iovcnt > 0 && (size_t)written >= iov->iov_len) {
+            written -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char*)iov->iov_base + written;
+            iov->iov_len -= written;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+int8_t editor_block_copy(struct EditorConfig* conf, int32_t fd) {
+    int32_t nrows = block_rows(conf);
+    if (nrows == 0) return EXIT_FAILURE;
+
+    struct BlockSpan* spans = malloc(sizeof(struct BlockSpan) * nrows);
+    if (!spans) die("block spans malloc failed");
+    block_spans(conf, spans);
+
+    // slices point straight into row->chars, nothing gets copied on our side
+    struct iovec iov[BLOCK_IOV_BATCH * 2];
+    int32_t iovcnt = 0;
+    int32_t top = block_top(conf);
+    int64_t bytes_size = 0;
+
+    for (int32_t i = 0; i < nrows; i++) {
+        struct Row* row = &conf->rows[top + i];
+        iov[iovcnt].iov_base = &row->chars[spans[i].start];
+        iov[iovcnt++].iov_len = spans[i].end - spans[i].start;
+        bytes_size += spans[i].end - spans[i].start;
+
+        if (i != nrows - 1) {
+            iov[iovcnt].iov_base = "\n";
+            iov[iovcnt++].iov_len = 1;
+        }
+
+        if (iovcnt >= BLOCK_IOV_BATCH * 2 - 1 || i == nrows - 1) {
+            if (write_iov_all(fd, iov, iovcnt) == EXIT_FAILURE) {
+                free(spans);
+                return EXIT_FAILURE;
+            }
+            iovcnt = 0;
+        }
+    }
+
+    free(spans);
+    editor_set_status_message(conf, "copied %d bytes from %d rows",
+                              (int32_t)bytes_size, nrows);
+
+    return EXIT_SUCCESS;
+}
+
+int8_t editor_block_delete(struct EditorConfig* conf) {
+    int32_t nrows = block_rows(conf);
+    if (nrows == 0) return EXIT_FAILURE;
+
+    struct BlockSpan* spans = malloc(sizeof(struct BlockSpan) * nrows);
+    if (!spans) die("block spans malloc failed");
+    block_spans(conf, spans);
+
+    int32_t top = block_top(conf);
+    for (int32_t i = 0; i < nrows; i++) {
+        int32_t len = spans[i].end - spans[i].start;
+        if (len == 0) continue;
+
+        struct Row* row = &conf->rows[top + i];
+        memmove(&row->chars[spans[i].start], &row->chars[spans[i].end],
+                row->size - spans[i].end);
+        row->size -= len;
+        row->chars[row->size] = '\0';
+        editor_update_row(conf, row);
+    }
+
+    free(spans);
+    conf->flags.is_dirty = 1;
+    conf->block.start_col = conf->block.end_col = block_left(conf);
+
+    return EXIT_SUCCESS;
+}
+
+// a zero width block is just a column of cursors
+static int8_t block_to_cursors(struct EditorConfig* conf) {
+    int32_t left = block_left(conf);
+    struct Row* row = &conf->rows[conf->block.end_row];
+
+    conf->cy = conf->block.end_row;
+    conf->cx = editor_update_rx_cx(row, left);
+
+    cursors_clear(conf);
+    cursors_add_column(conf, block_top(conf), block_bottom(conf), left);
+    editor_block_clear(conf);
+
+    return EXIT_SUCCESS;
+}
+
+int8_t editor_block_process_key(struct EditorConfig* conf, int32_t key) {
+    int8_t has_width = block_left(conf) != block_right(conf);
+
+    switch (key) {
+        case '\x1b':
+            return editor_block_clear(conf);
+        case BACKSPACE:
+        case CTRL_KEY('h'):
+        case DEL_KEY:
+            cursors_snapshot(conf);
+            if (has_width) {
+                editor_block_delete(conf);
+                return block_to_cursors(conf);
+            }
+            block_to_cursors(conf);
+            return editor_cursors_process_key(conf, key);
+        default:
+            if (cursors_is_text_key(key)) {
+                cursors_snapshot(conf);
+                if (has_width) editor_block_delete(conf);
+                block_to_cursors(conf);
+                return editor_cursors_insert_key(conf, key);
+            }
+            return EXIT_FAILURE;
+    }
+}
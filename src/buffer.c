@@ -3,11 +3,14 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "alloc.h"
 #include "core.h"
+#include "profile.h"
 
 int8_t ab_append(struct ABuf *ab, const char *s, int32_t slen) {
-    char *new = realloc(ab->buf, ab->len + slen);
+    char *new = alloc_realloc(ab->buf, ab->len + slen);
     if (!new) die("realloc failed, out of memory");
+    PROFILE_COUNT(PROFILE_ALLOCS, 1);
 
     memcpy(&new[ab->len], s, slen);
     ab->buf = new;
@@ -17,7 +20,7 @@ int8_t ab_append(struct ABuf *ab, const char *s, int32_t slen) {
 }
 
 int8_t ab_free(struct ABuf *ab) {
-    free(ab->buf);
+    alloc_free(ab->buf);
     ab->buf = NULL;
     return EXIT_SUCCESS;
 }
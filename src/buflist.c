@@ -0,0 +1,208 @@
+#include "buflist.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "core.h"
+#include "file.h"
+#include "input.h"
+#include "rows.h"
+#include "views.h"
+
+static void buflist_stash(struct EditorConfig* conf,
+                          struct EditorBuffer* buffer) {
+    buffer->filepath = conf->filepath;
+    buffer->rows = conf->rows;
+    buffer->syntax = conf->syntax;
+    buffer->stack_undo = conf->stack_undo;
+    buffer->stack_redo = conf->stack_redo;
+    buffer->arena = conf->arena;
+    buffer->file = conf->file;
+    buffer->journal = conf->journal;
+    buffer->last_time_modified = conf->last_time_modified;
+
+    buffer->cx = conf->cx;
+    buffer->cy = conf->cy;
+    buffer->rx = conf->rx;
+    buffer->rowoff = conf->rowoff;
+    buffer->coloff = conf->coloff;
+    buffer->numrows = conf->numrows;
+    buffer->tab_size = conf->tab_size;
+    buffer->is_dirty = conf->flags.is_dirty;
+
+    buffer->sel = conf->sel;
+    buffer->cursors = conf->cursors;
+    buffer->block = conf->block;
+    buffer->folds = conf->folds;
+    buffer->hex = conf->hex;
+    buffer->wrap = conf->wrap;
+}
+
+static void buflist_load(struct EditorConfig* conf,
+                         const struct EditorBuffer* buffer) {
+    conf->filepath = buffer->filepath;
+    conf->rows = buffer->rows;
+    conf->syntax = buffer->syntax;
+    conf->stack_undo = buffer->stack_undo;
+    conf->stack_redo = buffer->stack_redo;
+    conf->arena = buffer->arena;
+    conf->file = buffer->file;
+    conf->journal = buffer->journal;
+    conf->last_time_modified = buffer->last_time_modified;
+
+    conf->cx = buffer->cx;
+    conf->cy = buffer->cy;
+    conf->rx = buffer->rx;
+    conf->rowoff = buffer->rowoff;
+    conf->coloff = buffer->coloff;
+    conf->numrows = buffer->numrows;
+    conf->flags.is_dirty = buffer->is_dirty;
+
+    conf->sel = buffer->sel;
+    conf->cursors = buffer->cursors;
+    conf->block = buffer->block;
+    conf->folds = buffer->folds;
+    conf->hex = buffer->hex;
+    conf->wrap = buffer->wrap;
+
+    // the only cache that can go stale while parked is the tab expansion
+    if (buffer->tab_size != conf->tab_size) {
+        for (int32_t i = 0; i < conf->numrows; i++)
+            editor_retab_row(conf, &conf->rows[i]);
+    }
+}
+
+static void buflist_reserve(struct EditorBufList* buffers) {
+    if (buffers->count < buffers->cap) return;
+
+    buffers->cap = buffers->cap ? buffers->cap * 2 : 4;
+    buffers->items =
+        realloc(buffers->items, sizeof(struct EditorBuffer) * buffers->cap);
+    if (!buffers->items) die("buffers realloc failed");
+}
+
+int8_t buflist_create(struct EditorConfig* conf) {
+    struct EditorBufList* buffers = &conf->buffers;
+    buffers->items = NULL;
+    buffers->count = 0;
+    buffers->cap = 0;
+
+    // slot of the document conf_create_document just set up
+    buflist_reserve(buffers);
+    buffers->count = 1;
+    buffers->current = 0;
+
+    return EXIT_SUCCESS;
+}
+
+int8_t buflist_destroy(struct EditorConfig* conf) {
+    struct EditorBufList* buffers = &conf->buffers;
+
+    // the slot of the current buffer is stale until it is stashed
+    buflist_stash(conf, &buffers->items[buffers->current]);
+    for (int32_t i = 0; i < buffers->count; i++) {
+        buflist_load(conf, &buffers->items[i]);
+        conf_destroy_document(conf);
+    }
+
+    free(buffers->items);
+    buffers->items = NULL;
+    buffers->count = 0;
+    buffers->cap = 0;
+    buffers->current = 0;
+
+    return EXIT_SUCCESS;
+}
+
+int32_t buflist_dirty(const struct EditorConfig* conf, const char** name) {
+    const struct EditorBufList* buffers = &conf->buffers;
+
+    for (int32_t i = 0; i < buffers->count; i++) {
+        int8_t current = i == buffers->current;
+        if (!(current ? conf->flags.is_dirty : buffers->items[i].is_dirty))
+            continue;
+
+        const char* filepath =
+            current ? conf->filepath : buffers->items[i].filepath;
+        *name = filepath ? filepath : "[No Name]";
+        return i;
+    }
+    return -1;
+}
+
+int8_t buflist_select(struct EditorConfig* conf, int32_t index) {
+    struct EditorBufList* buffers = &conf->buffers;
+    if (index < 0 || index >= buffers->count) return EXIT_FAILURE;
+    if (index == buffers->current) return EXIT_SUCCESS;
+
+    buflist_stash(conf, &buffers->items[buffers->current]);
+    buflist_load(conf, &buffers->items[index]);
+    buffers->current = index;
+
+    return EXIT_SUCCESS;
+}
+
+int8_t buflist_switch(struct EditorConfig* conf, int32_t index) {
+    struct EditorBufList* buffers = &conf->buffers;
+    if (index == buffers->current) return EXIT_SUCCESS;
+    if (buflist_select(conf, index) == EXIT_FAILURE) return EXIT_FAILURE;
+
+    editor_set_status_message(conf, "buffer %d/%d: %s", index + 1,
+                              buffers->count,
+                              conf->filepath ? conf->filepath : "[No Name]");
+
+    return EXIT_SUCCESS;
+}
+
+int8_t buflist_cycle(struct EditorConfig* conf, int32_t direction) {
+    struct EditorBufList* buffers = &conf->buffers;
+    if (buffers->count < 2) return EXIT_FAILURE;
+
+    int32_t index =
+        (buffers->current + direction + buffers->count) % buffers->count;
+    return buflist_switch(conf, index);
+}
+
+int8_t buflist_open(struct EditorConfig* conf, const char* path) {
+    struct EditorBufList* buffers = &conf->buffers;
+
+    for (int32_t i = 0; i < buffers->count; i++) {
+        const char* filepath = i == buffers->current
+                                   ? conf->filepath
+                                   : buffers->items[i].filepath;
+        if (filepath && strcmp(filepath, path) == 0)
+            return buflist_switch(conf, i);
+    }
+
+    // a fresh editor starts with an empty unnamed buffer, reuse it
+    if (conf->filepath || conf->numrows || conf->flags.is_dirty) {
+        buflist_stash(conf, &buffers->items[buffers->current]);
+        buflist_reserve(buffers);
+        buffers->current = buffers->count++;
+        conf_create_document(conf);
+    }
+
+    return editor_open(conf, path);
+}
+
+int8_t buflist_close(struct EditorConfig* conf) {
+    struct EditorBufList* buffers = &conf->buffers;
+    int32_t closed = buffers->current;
+
+    conf_destroy_document(conf);
+
+    if (buffers->count == 1) {
+        conf_create_document(conf);
+        return views_buffer_closed(conf, closed);
+    }
+
+    memmove(&buffers->items[closed], &buffers->items[closed + 1],
+            sizeof(struct EditorBuffer) * (buffers->count - closed - 1));
+    buffers->count--;
+    if (buffers->current == buffers->count) buffers->current--;
+
+    buflist_load(conf, &buffers->items[buffers->current]);
+
+    return views_buffer_closed(conf, closed);
+}
@@ -3,17 +3,29 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "alloc.h"
+#include "arena.h"
+#include "block.h"
+#include "buflist.h"
 #include "core.h"
+#include "cursors.h"
 #include "file.h"
+#include "filewatch.h"
+#include "folds.h"
+#include "gutter.h"
+#include "hexview.h"
+#include "journal.h"
 #include "rows.h"
 #include "terminal.h"
+#include "views.h"
+#include "wrap.h"
 
 struct EditorConfig* g_conf = NULL;
 
 static void app_destroy(void* el) {
     if (snapshot_destroy((struct Snapshot*)el) != 0)
         die("snapshot destroy failed");
-    free(el);
+    alloc_free(el);
 }
 
 static int32_t app_cmp(const void* str1, const void* str2) {
@@ -21,50 +33,34 @@ static int32_t app_cmp(const void* str1, const void* str2) {
 }
 
 int8_t conf_create(struct EditorConfig* conf) {
-    conf->filepath = NULL;
+    conf->tab_size = TAB_SIZE;
+    const char* tab_size = getenv("SCOOM_TAB_SIZE");
+    if (tab_size && atoi(tab_size) > 0) conf->tab_size = atoi(tab_size);
     // this is true only when user inputs something
     conf->flags.program_state = 0;
 
     // status message section
     conf->status_msg[0] = '\0';
-    conf->sbuf_time = 0;
-
-    // cursor section
-    conf->cx = 2;
-    conf->cy = 0;
-    conf->rx = 0;
-
-    conf->numrows = 0;
-    conf->rows = NULL;
-    conf->rowoff = 0;
-    conf->coloff = 0;
-    conf->flags.is_dirty = 0;
-    conf->syntax = NULL;
+    conf->status_timer = -1;
+    conf->loop = NULL;
     conf->flags.resize_needed = 0;
 
-    conf->stack_undo = malloc(sizeof(Stack));
-    conf->stack_redo = malloc(sizeof(Stack));
-
-    if (!conf->stack_undo || !conf->stack_redo)
-        die("malloc for stack_undo or stack_redo failed");
-
-    conf->last_time_modified = time(NULL);
-    if (conf->last_time_modified == -1) die("time funciton init failed");
-
-    stack_create(conf->stack_undo, app_cmp, app_destroy);
-    stack_create(conf->stack_redo, app_cmp, app_destroy);
-
     // even if it returned overflowed values it will execute die exit function
-    if (term_get_window_size(conf, &conf->screen_rows, &conf->screen_cols) != 0)
+    int32_t rows, cols;
+    if (term_get_window_size(conf, &rows, &cols) != 0)
         die("operation of retrieving window size failed");
 
-    conf->sel.start_row = -1;
-    conf->sel.start_col = -1;
-    conf->sel.end_row = -1;
-    conf->sel.end_col = -1;
+    filewatch_create(conf);
+    journal_create(conf);
+    conf_create_document(conf);
+    buflist_create(conf);
+
+    // the last row is the message bar, views take the rest
+    views_create(conf, rows - 1, cols);
 
-    // inorder to have message bar and status bar we need to decrement by 2
-    conf->screen_rows -= 2;
+    conf->gutter.flags = 0;
+    conf->flags.soft_wrap = 0;
+    gutter_update(conf);
 
     return EXIT_SUCCESS;
 }
@@ -97,27 +93,116 @@ int8_t conf_to_snapshot_update(struct EditorConfig* conf,
     return EXIT_SUCCESS;
 }
 
+// every row lives in the buffer arena, so they all go in one step
 int8_t conf_destroy_rows(struct EditorConfig* conf) {
-    for (int32_t i = 0; i < conf->numrows; i++) {
-        free(conf->rows[i].chars);
-        free(conf->rows[i].render);
-        free(conf->rows[i].hl);
-    }
+    arena_destroy(conf->arena);
+    conf->rows = NULL;
+    conf->numrows = 0;
+    folds_clear(conf);
+
+    return EXIT_SUCCESS;
+}
+
+int8_t conf_create_document(struct EditorConfig* conf) {
+    conf->filepath = NULL;
+    conf->syntax = NULL;
+
+    // cursor section
+    conf->cx = 0;
+    conf->cy = 0;
+    conf->rx = 0;
 
-    free(conf->rows);
+    conf->numrows = 0;
     conf->rows = NULL;
+    conf->rowoff = 0;
+    conf->coloff = 0;
+    conf->flags.is_dirty = 0;
+
+    conf->file.hashes = NULL;
+    conf->file.count = 0;
+    conf->file.cap = 0;
+    conf->file.wd = -1;
+    conf->file.pending = 0;
+    conf->file.follow = 0;
+
+    conf->journal.path = NULL;
+    conf->journal.log = NULL;
+    conf->journal.len = 0;
+    conf->journal.cap = 0;
+    conf->journal.base = 0;
+    conf->journal.logged = 0;
+    conf->journal.snapshot = 0;
+    conf->journal.on_disk = 0;
+    conf->journal.recover = 0;
+
+    conf->arena = malloc(sizeof(struct Arena));
+    if (!conf->arena) die("arena malloc failed");
+    arena_create(conf->arena);
+
+    conf->stack_undo = alloc_malloc(sizeof(Stack));
+    conf->stack_redo = alloc_malloc(sizeof(Stack));
+
+    if (!conf->stack_undo || !conf->stack_redo)
+        die("malloc for stack_undo or stack_redo failed");
+
+    conf->last_time_modified = time(NULL);
+    if (conf->last_time_modified == -1) die("time funciton init failed");
+
+    stack_create(conf->stack_undo, app_cmp, app_destroy);
+    stack_create(conf->stack_redo, app_cmp, app_destroy);
+
+    conf->sel.active = 0;
+    conf->sel.start_row = -1;
+    conf->sel.start_col = -1;
+    conf->sel.end_row = -1;
+    conf->sel.end_col = -1;
+
+    conf->cursors.items = NULL;
+    conf->cursors.count = 0;
+    conf->cursors.cap = 0;
+
+    editor_block_clear(conf);
+    folds_create(conf);
+    hexview_init(conf);
+    wrap_create(conf);
 
     return EXIT_SUCCESS;
 }
 
-int8_t conf_destroy(struct EditorConfig* conf) {
-    if (conf->filepath) free(conf->filepath);
-    conf->flags.program_state = 0;
+int8_t conf_destroy_document(struct EditorConfig* conf) {
+    filewatch_forget(conf);
+    journal_forget(conf);
+    free(conf->filepath);
+    conf->filepath = NULL;
 
-    if (conf_destroy_rows(conf) != EXIT_SUCCESS) die("destroy rows failed");
+    conf_destroy_rows(conf);
+    free(conf->arena);
+    conf->arena = NULL;
 
     stack_destroy(conf->stack_redo);
     stack_destroy(conf->stack_undo);
+    alloc_free(conf->stack_redo);
+    alloc_free(conf->stack_undo);
+    conf->stack_redo = NULL;
+    conf->stack_undo = NULL;
+
+    cursors_clear(conf);
+    editor_block_clear(conf);
+    folds_destroy(conf);
+    hexview_close(conf);
+    wrap_destroy(conf);
+
+    return EXIT_SUCCESS;
+}
+
+int8_t conf_destroy(struct EditorConfig* conf) {
+    conf->flags.program_state = 0;
+
+    // tears down every open buffer, the current one included
+    buflist_destroy(conf);
+    views_destroy(conf);
+    filewatch_destroy(conf);
+    journal_destroy(conf);
 
     // Reset all fields to safe values
     conf->cx = 0;
@@ -136,7 +221,7 @@ int8_t conf_destroy(struct EditorConfig* conf) {
     conf->flags.is_dirty = 0;
 
     conf->status_msg[0] = '\0';
-    conf->sbuf_time = 0;
+    conf->status_timer = -1;
     conf->last_time_modified = 0;
 
     conf->sel.active = 0;
@@ -145,8 +230,16 @@ int8_t conf_destroy(struct EditorConfig* conf) {
     conf->sel.end_row = -1;
     conf->sel.end_col = -1;
 
-    free(conf->stack_redo);
-    free(conf->stack_undo);
+    return EXIT_SUCCESS;
+}
+
+int8_t conf_set_tab_size(struct EditorConfig* conf, int32_t tab_size) {
+    if (tab_size <= 0) return EXIT_FAILURE;
+    if (tab_size == conf->tab_size) return EXIT_SUCCESS;
+
+    conf->tab_size = tab_size;
+    for (int32_t i = 0; i < conf->numrows; i++)
+        editor_retab_row(conf, &conf->rows[i]);
 
     return EXIT_SUCCESS;
 }
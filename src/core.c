@@ -6,6 +6,7 @@
 #include <string.h>
 #include <unistd.h>
 
+#include "alloc.h"
 #include "stack.h"
 
 /* Misc */
@@ -73,10 +74,10 @@ int8_t check_compound_statement(const char* str, int32_t len) {
     if (count_char(str, len, '{') == 0 && count_char(str, len, '}') == 0)
         return 0;
 
-    Stack* s = malloc(sizeof(Stack));
+    Stack* s = alloc_malloc(sizeof(Stack));
     if (!s) die("stack 's' malloc failed...");
 
-    stack_create(s, NULL, free);
+    stack_create(s, NULL, alloc_free);
 
     int8_t in_string = 0;
 
@@ -90,18 +91,18 @@ int8_t check_compound_statement(const char* str, int32_t len) {
         if (!in_string) {
             char* data;
             if (c == '{') {
-                data = strdup("{");
+                data = alloc_strdup("{");
                 if (!data) die("data strdup failed");
 
                 stack_push(s, data);
             } else if (c == '}') {
                 char* peaked = stack_peek(s);
-                void* ptr;
+                void* ptr = NULL;
                 if (peaked && strcmp(peaked, "{") == 0) {
                     stack_pop(s, &ptr);
-                    free(ptr);
+                    alloc_free(ptr);
                 } else {
-                    data = strdup("}");
+                    data = alloc_strdup("}");
                     if (!data) die("data strdup failed");
 
                     stack_push(s, data);
@@ -112,7 +113,7 @@ int8_t check_compound_statement(const char* str, int32_t len) {
 
     int8_t isempty = stack_size(s) == 0;
     stack_destroy(s);
-    free(s);
+    alloc_free(s);
 
     return isempty;
 }
@@ -0,0 +1,393 @@
+#include "cursors.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "alloc.h"
+#include "arena.h"
+#include "config.h"
+#include "core.h"
+#include "file.h"
+#include "input.h"
+#include "rows.h"
+#include "utf8.h"
+
+// id is the index inside conf->cursors.items, -1 stands for the primary one
+struct CursorRef {
+    int32_t row;
+    int32_t col;
+    int32_t id;
+};
+
+static int32_t cursor_cmp(const void* a, const void* b) {
+    const struct EditorCursorSelect* ca = a;
+    const struct EditorCursorSelect* cb = b;
+    if (ca->end_row != cb->end_row) return ca->end_row < cb->end_row ? -1 : 1;
+    if (ca->end_col != cb->end_col) return ca->end_col < cb->end_col ? -1 : 1;
+    return 0;
+}
+
+static void cursor_set(struct EditorCursorSelect* cursor, int32_t row,
+                       int32_t col) {
+    cursor->active = 0;
+    cursor->start_row = cursor->end_row = row;
+    cursor->start_col = cursor->end_col = col;
+}
+
+// primary cursor position in row->chars coordinates
+static int32_t primary_col(struct EditorConfig* conf) {
+    if (conf->cy >= conf->numrows) return 0;
+    return conf->cx;
+}
+
+/*
+    keeps extra cursors sorted by position and drops duplicates,
+    including any that landed on the primary cursor
+*/
+static void cursors_normalize(struct EditorConfig* conf) {
+    struct EditorCursors* cursors = &conf->cursors;
+    if (cursors->count == 0) return;
+
+    qsort(cursors->items, cursors->count, sizeof(struct EditorCursorSelect),
+          cursor_cmp);
+
+    int32_t pcol = primary_col(conf);
+    int32_t n = 0;
+    for (int32_t i = 0; i < cursors->count; i++) {
+        struct EditorCursorSelect* cursor = &cursors->items[i];
+        if (cursor->end_row == conf->cy && cursor->end_col == pcol) continue;
+        if (n > 0 && cursor_cmp(&cursors->items[n - 1], cursor) == 0) continue;
+        cursors->items[n++] = *cursor;
+    }
+    cursors->count = n;
+}
+
+/*
+    merges the primary cursor into the (sorted) extra cursors
+    returns how many refs were written into refs
+*/
+static int32_t cursors_collect(struct EditorConfig* conf,
+                               struct CursorRef* refs) {
+    struct EditorCursors* cursors = &conf->cursors;
+    int32_t n = 0;
+    int8_t primary_added = conf->cy >= conf->numrows;
+    int32_t pcol = primary_col(conf);
+
+    for (int32_t i = 0; i < cursors->count; i++) {
+        struct EditorCursorSelect* cursor = &cursors->items[i];
+        if (!primary_added &&
+            (conf->cy < cursor->end_row ||
+             (conf->cy == cursor->end_row && pcol < cursor->end_col))) {
+            refs[n++] = (struct CursorRef){conf->cy, pcol, -1};
+            primary_added = 1;
+        }
+        refs[n++] = (struct CursorRef){cursor->end_row, cursor->end_col, i};
+    }
+    if (!primary_added) refs[n++] = (struct CursorRef){conf->cy, pcol, -1};
+
+    return n;
+}
+
+static void cursors_write_back(struct EditorConfig* conf,
+                               const struct CursorRef* refs, int32_t count) {
+    for (int32_t i = 0; i < count; i++) {
+        if (refs[i].id == -1) {
+            conf->cy = refs[i].row;
+            conf->cx = refs[i].col;
+        } else {
+            cursor_set(&conf->cursors.items[refs[i].id], refs[i].row,
+                       refs[i].col);
+        }
+    }
+    cursors_normalize(conf);
+}
+
+int8_t cursors_snapshot(struct EditorConfig* conf) {
+    time_t current_time = time(NULL);
+    if (difftime(current_time, conf->last_time_modified) > 0.5) {
+        struct Snapshot* s = alloc_malloc(sizeof(struct Snapshot));
+        if (!s) die("snapshot malloc failed");
+        snapshot_create(conf, s);
+        stack_push(conf->stack_undo, s);
+    }
+    conf->last_time_modified = current_time;
+
+    return EXIT_SUCCESS;
+}
+
+static void cursors_reserve(struct EditorCursors* cursors, int32_t extra) {
+    if (cursors->count + extra <= cursors->cap) return;
+
+    if (!cursors->cap) cursors->cap = 16;
+    while (cursors->count + extra > cursors->cap) cursors->cap *= 2;
+    cursors->items = realloc(cursors->items,
+                             sizeof(struct EditorCursorSelect) * cursors->cap);
+    if (!cursors->items) die("cursors realloc failed");
+}
+
+int8_t cursors_add(struct EditorConfig* conf, int32_t row, int32_t col) {
+    if (row < 0 || row >= conf->numrows) return EXIT_FAILURE;
+    if (col < 0) col = 0;
+    if (col > conf->rows[row].size) col = conf->rows[row].size;
+
+    struct EditorCursors* cursors = &conf->cursors;
+    cursors_reserve(cursors, 1);
+    cursor_set(&cursors->items[cursors->count++], row, col);
+    cursors_normalize(conf);
+
+    return EXIT_SUCCESS;
+}
+
+int8_t cursors_add_column(struct EditorConfig* conf, int32_t from_row,
+                          int32_t to_row, int32_t rx) {
+    if (from_row < 0 || to_row >= conf->numrows || from_row > to_row)
+        return EXIT_FAILURE;
+
+    // sorted once at the end rather than once per added cursor
+    struct EditorCursors* cursors = &conf->cursors;
+    cursors_reserve(cursors, to_row - from_row + 1);
+    for (int32_t i = from_row; i <= to_row; i++) {
+        int32_t col = editor_update_rx_cx(&conf->rows[i], rx);
+        cursor_set(&cursors->items[cursors->count++], i, col);
+    }
+    cursors_normalize(conf);
+
+    return EXIT_SUCCESS;
+}
+
+int8_t cursors_add_vertical(struct EditorConfig* conf, int32_t direction) {
+    if (conf->cy >= conf->numrows) return EXIT_FAILURE;
+
+    // new cursors grow from whichever cursor is furthest in that direction
+    int32_t row = conf->cy;
+    int32_t col = primary_col(conf);
+    struct EditorCursors* cursors = &conf->cursors;
+    if (cursors->count) {
+        struct EditorCursorSelect* edge =
+            direction > 0 ? &cursors->items[cursors->count - 1]
+                          : &cursors->items[0];
+        if ((direction > 0 && edge->end_row > row) ||
+            (direction < 0 && edge->end_row < row)) {
+            row = edge->end_row;
+            col = edge->end_col;
+        }
+    }
+
+    // same screen column on the next row, never the middle of a glyph
+    int32_t to = row + direction;
+    if (to < 0 || to >= conf->numrows) return EXIT_FAILURE;
+    int32_t rx = editor_update_cx_rx(&conf->rows[row], col);
+    return cursors_add(conf, to, editor_update_rx_cx(&conf->rows[to], rx));
+}
+
+int8_t cursors_clear(struct EditorConfig* conf) {
+    free(conf->cursors.items);
+    conf->cursors.items = NULL;
+    conf->cursors.count = 0;
+    conf->cursors.cap = 0;
+
+    return EXIT_SUCCESS;
+}
+
+struct EditorCursorSelect* cursors_find_row(struct EditorConfig* conf,
+                                            int32_t row) {
+    struct EditorCursors* cursors = &conf->cursors;
+
+    // lower bound on row, cursors are kept sorted
+    int32_t lo = 0, hi = cursors->count;
+    while (lo < hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if (cursors->items[mid].end_row < row)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo < cursors->count && cursors->items[lo].end_row == row)
+        return &cursors->items[lo];
+    return NULL;
+}
+
+/*
+    Every row touched by the batch is rebuilt once with all of its cursors
+    applied, then goes through a single editor_update_row.
+*/
+
+int8_t editor_cursors_insert(struct EditorConfig* conf, const char* s,
+                             int32_t len) {
+    struct CursorRef* refs =
+        malloc(sizeof(struct CursorRef) * (conf->cursors.count + 1));
+    if (!refs) die("cursor refs malloc failed");
+    int32_t count = cursors_collect(conf, refs);
+
+    for (int32_t i = 0; i < count;) {
+        int32_t j = i;
+        while (j < count && refs[j].row == refs[i].row) j++;
+        if (refs[i].row >= conf->numrows) break;
+
+        struct Row* row = &conf->rows[refs[i].row];
+        char* chars = arena_alloc(conf->arena, row->size + (j - i) * len + 1);
+
+        int32_t prev = 0, size = 0;
+        for (int32_t k = i; k < j; k++) {
+            int32_t col = refs[k].col;
+            memcpy(&chars[size], &row->chars[prev], col - prev);
+            size += col - prev;
+            memcpy(&chars[size], s, len);
+            size += len;
+            refs[k].col = size;
+            prev = col;
+        }
+        memcpy(&chars[size], &row->chars[prev], row->size - prev);
+        size += row->size - prev;
+        chars[size] = '\0';
+
+        arena_free(conf->arena, row->chars);
+        row->chars = chars;
+        row->size = size;
+        editor_update_row(conf, row);
+
+        i = j;
+    }
+
+    conf->flags.is_dirty = 1;
+    cursors_write_back(conf, refs, count);
+    free(refs);
+
+    return EXIT_SUCCESS;
+}
+
+int8_t editor_cursors_insert_key(struct EditorConfig* conf, int32_t key) {
+    char glyph[UTF8_MAX_BYTES];
+    int32_t len = editor_read_glyph(conf, key, glyph);
+    return editor_cursors_insert(conf, glyph, len);
+}
+
+// forward deletes the glyph under each cursor (DEL) instead of before it
+static int8_t cursors_delete(struct EditorConfig* conf, int8_t forward) {
+    struct CursorRef* refs =
+        malloc(sizeof(struct CursorRef) * (conf->cursors.count + 1));
+    if (!refs) die("cursor refs malloc failed");
+    int32_t count = cursors_collect(conf, refs);
+    // start of the glyph each cursor removes, found before chars moves
+    int32_t* from = malloc(sizeof(int32_t) * count);
+    if (!from) die("cursor spans malloc failed");
+
+    for (int32_t i = 0; i < count;) {
+        int32_t j = i;
+        while (j < count && refs[j].row == refs[i].row) j++;
+        if (refs[i].row >= conf->numrows) break;
+
+        struct Row* row = &conf->rows[refs[i].row];
+        for (int32_t k = i; k < j; k++) {
+            from[k] = forward ? refs[k].col
+                              : editor_row_prev_cx(row, refs[k].col);
+            // [from, col) is the glyph removed, DEL takes the one after col
+            if (forward) refs[k].col = editor_row_next_cx(row, refs[k].col);
+        }
+
+        int32_t prev = 0, len = 0, removed = 0;
+        for (int32_t k = i; k < j; k++) {
+            int32_t to = refs[k].col;
+            if (from[k] == to || from[k] < prev) {
+                // nothing left to delete, the cursor sticks to the last cut
+                refs[k].col = forward ? from[k] - removed : to - removed;
+                if (refs[k].col < len) refs[k].col = len;
+                continue;
+            }
+
+            // chars is compacted in place, len never passes prev
+            memmove(&row->chars[len], &row->chars[prev], from[k] - prev);
+            len += from[k] - prev;
+            prev = to;
+            removed += to - from[k];
+            refs[k].col = len;
+        }
+        memmove(&row->chars[len], &row->chars[prev], row->size - prev);
+        len += row->size - prev;
+
+        if (removed) {
+            row->size = len;
+            row->chars[len] = '\0';
+            editor_update_row(conf, row);
+        }
+
+        i = j;
+    }
+
+    conf->flags.is_dirty = 1;
+    cursors_write_back(conf, refs, count);
+    free(from);
+    free(refs);
+
+    return EXIT_SUCCESS;
+}
+
+int8_t editor_cursors_delete_char(struct EditorConfig* conf) {
+    return cursors_delete(conf, 0);
+}
+
+int8_t editor_cursors_move(struct EditorConfig* conf, int32_t key) {
+    struct CursorRef* refs =
+        malloc(sizeof(struct CursorRef) * (conf->cursors.count + 1));
+    if (!refs) die("cursor refs malloc failed");
+    int32_t count = cursors_collect(conf, refs);
+
+    // cursors stay on their own row for left/right, like column editing
+    for (int32_t i = 0; i < count; i++) {
+        struct CursorRef* ref = &refs[i];
+        if (ref->row >= conf->numrows) continue;
+
+        switch (key) {
+            case ARROW_LEFT:
+                ref->col = editor_row_prev_cx(&conf->rows[ref->row], ref->col);
+                break;
+            case ARROW_RIGHT:
+                ref->col = editor_row_next_cx(&conf->rows[ref->row], ref->col);
+                break;
+            case ARROW_UP:
+            case ARROW_DOWN: {
+                // the screen column is kept, like editor_cursor_move
+                int32_t to = ref->row + (key == ARROW_UP ? -1 : 1);
+                if (to < 0 || to >= conf->numrows) break;
+                int32_t rx = editor_update_cx_rx(&conf->rows[ref->row],
+                                                 ref->col);
+                ref->row = to;
+                ref->col = editor_update_rx_cx(&conf->rows[to], rx);
+                break;
+            }
+        }
+        ref->col = min(ref->col, conf->rows[ref->row].size);
+    }
+
+    cursors_write_back(conf, refs, count);
+    free(refs);
+
+    return EXIT_SUCCESS;
+}
+
+int8_t editor_cursors_process_key(struct EditorConfig* conf, int32_t key) {
+    switch (key) {
+        case '\x1b':
+            return cursors_clear(conf);
+        case ARROW_UP:
+        case ARROW_DOWN:
+        case ARROW_LEFT:
+        case ARROW_RIGHT:
+            return editor_cursors_move(conf, key);
+        case BACKSPACE:
+        case CTRL_KEY('h'):
+            cursors_snapshot(conf);
+            return editor_cursors_delete_char(conf);
+        case DEL_KEY:
+            cursors_snapshot(conf);
+            return cursors_delete(conf, 1);
+        default:
+            if (cursors_is_text_key(key)) {
+                cursors_snapshot(conf);
+                return editor_cursors_insert_key(conf, key);
+            }
+            return EXIT_FAILURE;
+    }
+}
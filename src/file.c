@@ -7,11 +7,22 @@
 #include <string.h>
 #include <unistd.h>
 
+#include "alloc.h"
+#include "arena.h"
+#include "block.h"
+#include "buflist.h"
 #include "config.h"
 #include "core.h"
+#include "filewatch.h"
+#include "folds.h"
+#include "gutter.h"
+#include "hexview.h"
 #include "highlight.h"
 #include "input.h"
+#include "journal.h"
+#include "loop.h"
 #include "render.h"
+#include "replay.h"
 #include "rows.h"
 #include "terminal.h"
 
@@ -20,6 +31,13 @@ int8_t snapshot_create(struct EditorConfig* conf, struct Snapshot* snapshot) {
     snapshot->cy = conf->cy;
     snapshot->numrows = conf->numrows;
 
+    // an empty document has no string, undo still needs one to restore
+    if (conf->numrows == 0) {
+        snapshot->text = alloc_strdup("");
+        snapshot->len = 0;
+        return snapshot->text ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     if (editor_rows_to_string(conf, &snapshot->text, &snapshot->len) ==
         EXIT_FAILURE)
         return EXIT_FAILURE;
@@ -29,15 +47,61 @@ int8_t snapshot_create(struct EditorConfig* conf, struct Snapshot* snapshot) {
 
 int8_t snapshot_destroy(struct Snapshot* snapshot) {
     if (!snapshot) die("empty sna(pshot passed");
-    if (snapshot->text) free(snapshot->text);
+    if (snapshot->text) alloc_free(snapshot->text);
+    return EXIT_SUCCESS;
+}
+
+static int8_t editor_open_hex(struct EditorConfig* conf) {
+    conf->syntax = NULL;
+    if (hexview_open(conf, conf->filepath) == EXIT_FAILURE) {
+        editor_set_status_message(conf, "couldn't map %.40s", conf->filepath);
+        return EXIT_FAILURE;
+    }
+    // the map is remapped when the file changes size under it
+    filewatch_attach(conf);
     return EXIT_SUCCESS;
 }
 
+static int8_t editor_load_rows(struct EditorConfig* conf, FILE* fp) {
+    char* text = NULL;
+    size_t len = 0, cap = 0;
+    while (!feof(fp) && !ferror(fp)) {
+        if (len == cap) {
+            cap = cap ? cap * 2 : FILEWATCH_READ_CHUNK;
+            text = realloc(text, cap);
+            if (!text) die("file read realloc failed");
+        }
+        len += fread(&text[len], 1, cap - len, fp);
+    }
+    fclose(fp);
+
+    // split the same way a reload does, so an unchanged file stays unchanged
+    const char** lines;
+    int32_t* lens;
+    int32_t count = editor_split_lines(text, len, &lines, &lens);
+    if (editor_insert_rows(conf, conf->numrows, lines, lens, count) ==
+        EXIT_FAILURE)
+        die("editor insert rows failed");
+
+    gutter_clear_markers(conf);
+    conf->flags.is_dirty = 0;
+    free(lines);
+    free(lens);
+    free(text);
+
+    filewatch_attach(conf);
+
+    return journal_attach(conf);
+}
+
 int8_t editor_open(struct EditorConfig* conf, const char* path) {
     free(conf->filepath);
     conf->filepath = strdup(path);
     if (!conf->filepath) die("strdup failed for path");
 
+    // splitting a binary on '\n' and saving it as text would corrupt it
+    if (hexview_detect(path)) return editor_open_hex(conf);
+
     editor_syntax_highlight_select(conf);
 
     FILE* fp = fopen(path, "r");
@@ -46,52 +110,81 @@ int8_t editor_open(struct EditorConfig* conf, const char* path) {
     if (!fp) {
         fp = fopen(path, "w");
         if (!fp) die("fopen failed");
+        fclose(fp);
 
         conf->flags.is_dirty = 0;
-        return EXIT_SUCCESS;
+        filewatch_attach(conf);
+        return journal_attach(conf);
     };
 
-    char* line = NULL;
-    size_t line_cap = 0;  // size of buf basically
-    int32_t line_len = 0;
-    while ((line_len = getline(&line, &line_cap, fp)) != -1) {
-        while (line_len > 0 &&
-               (line[line_len - 1] == '\r' || line[line_len - 1] == '\n')) {
-            line_len--;
-        }
-        editor_insert_row(conf, conf->numrows, line, line_len);
+    return editor_load_rows(conf, fp);
+}
+
+int8_t editor_toggle_hex(struct EditorConfig* conf) {
+    if (!conf->filepath) {
+        editor_set_status_message(conf, "hex mode needs a file on disk");
+        return EXIT_FAILURE;
+    }
+    if (conf->flags.is_dirty) {
+        editor_set_status_message(conf, "save before switching modes");
+        return EXIT_FAILURE;
     }
 
-    conf->flags.is_dirty = 0;
-    free(line);
-    fclose(fp);
+    if (conf->hex.active) {
+        hexview_close(conf);
+        FILE* fp = fopen(conf->filepath, "r");
+        if (!fp) return EXIT_FAILURE;
+        editor_syntax_highlight_select(conf);
+        return editor_load_rows(conf, fp);
+    }
 
-    return EXIT_SUCCESS;
+    conf_destroy_rows(conf);
+    conf->cx = conf->cy = conf->rx = 0;
+    conf->rowoff = conf->coloff = 0;
+    return editor_open_hex(conf);
 }
 int8_t editor_run(struct EditorConfig* conf) {
-    g_conf = conf;
-    conf_create(conf);
+    if (replay_active()) return replay_run(conf);
+
     term_create();
 
 #if DEBUG_MODE
-    if (editor_open(conf, "test.c") != EXIT_SUCCESS)
+    if (!conf->filepath && buflist_open(conf, "test.c") != EXIT_SUCCESS)
         die("couldn't open test.c");
 
 #endif
 
+    conf->loop = malloc(sizeof(struct EditorLoop));
+    if (!conf->loop) die("loop malloc failed");
+    loop_create(conf->loop);
+
+    if (loop_watch_add(conf->loop, STDIN_FILENO, editor_on_input, NULL) == -1)
+        die("couldn't watch stdin");
+    conf->status_timer = loop_timer_add(conf->loop, editor_on_status_expire,
+                                        NULL);
+    if (conf->status_timer == -1) die("couldn't create status timer");
+    filewatch_start(conf);
+    if (journal_start(conf) == EXIT_FAILURE) die("couldn't start the journal");
+
     editor_set_status_message(
         conf, "HELP: CTRL-S = save | CTRL-Q = Quit | CTRL-F = Find");
 
-    while (1) {
-        editor_refresh_screen(conf);
-        if (editor_process_key_press(conf) == EXIT_LOOP_CODE) {
-            break;
-        }
-    }
+    const char* record = getenv("SCOOM_RECORD");
+    if (record && replay_record_start(conf, record) == EXIT_FAILURE)
+        die("couldn't open SCOOM_RECORD");
+
+    loop_run(conf);
+    replay_record_stop();
+
+    // killed rather than quit, unsaved changes stay recoverable
+    if (conf->loop->exit_signal) journal_preserve(conf);
 
-    if (write(STDOUT_FILENO, "\x1b[2J", 4) == 0)
-        die("writing to stdout failed");
-    if (write(STDOUT_FILENO, "\x1b[H", 3) == 0) die("writing to stdout failed");
+    loop_destroy(conf->loop);
+    free(conf->loop);
+    conf->loop = NULL;
+
+    if (term_write("\x1b[2J", 4) == 0) die("writing to stdout failed");
+    if (term_write("\x1b[H", 3) == 0) die("writing to stdout failed");
 
     return EXIT_SUCCESS;
 }
@@ -118,6 +211,8 @@ int8_t editor_destroy(struct EditorConfig* conf) {
 }
 
 int8_t editor_save(struct EditorConfig* conf) {
+    if (conf->hex.active) return hexview_save(conf);
+
     if (!conf->filepath) {
         conf->filepath = editor_prompt(conf, "Save as: %s", NULL);
         if (!conf->filepath) {
@@ -150,9 +245,14 @@ int8_t editor_save(struct EditorConfig* conf) {
         editor_set_status_message(conf, "saved empty file", file_data_size);
     }
 
+    gutter_clear_markers(conf);
     conf->flags.is_dirty = 0;
     close(fd);
-    free(file_data);
+    alloc_free(file_data);
+
+    // indexes what was just written, so our own write isn't seen as a change
+    filewatch_attach(conf);
+    journal_clean(conf);
 
     return EXIT_SUCCESS;
 }
@@ -160,15 +260,15 @@ int8_t editor_save(struct EditorConfig* conf) {
 int8_t editor_undo(struct EditorConfig* conf) {
     if (stack_size(conf->stack_undo) == 0) return EXIT_FAILURE;
 
-    struct Snapshot *popped_snapshot, *current_snapshot;
+    struct Snapshot *popped_snapshot = NULL, *current_snapshot;
 
-    current_snapshot = malloc(sizeof(struct Snapshot));
+    current_snapshot = alloc_malloc(sizeof(struct Snapshot));
     snapshot_create(conf, current_snapshot);
     stack_push(conf->stack_redo, current_snapshot);
 
     stack_pop(conf->stack_undo, (void**)&popped_snapshot);
     conf_to_snapshot_update(conf, popped_snapshot);
-    free(popped_snapshot);
+    alloc_free(popped_snapshot);
 
     editor_set_status_message(conf, "undo success!");
 
@@ -178,15 +278,15 @@ int8_t editor_undo(struct EditorConfig* conf) {
 int8_t editor_redo(struct EditorConfig* conf) {
     if (stack_size(conf->stack_redo) == 0) return EXIT_FAILURE;
 
-    struct Snapshot *popped_snapshot, *current_snapshot;
+    struct Snapshot *popped_snapshot = NULL, *current_snapshot;
 
-    current_snapshot = malloc(sizeof(struct Snapshot));
+    current_snapshot = alloc_malloc(sizeof(struct Snapshot));
     snapshot_create(conf, current_snapshot);
     stack_push(conf->stack_undo, current_snapshot);
 
     stack_pop(conf->stack_redo, (void**)&popped_snapshot);
     conf_to_snapshot_update(conf, popped_snapshot);
-    free(popped_snapshot);
+    alloc_free(popped_snapshot);
 
     editor_set_status_message(conf, "redo success!");
 
@@ -201,6 +301,12 @@ int8_t editor_copy(struct EditorConfig* conf) {
     FILE* pipe = popen("xclip -selection clipboard", "w");
     if (!pipe) return 1;
 
+    if (conf->block.active) {
+        int8_t res = editor_block_copy(conf, fileno(pipe));
+        pclose(pipe);
+        return res;
+    }
+
     struct EditorCursorSelect* sel = &conf->sel;
 
     int64_t bytes_size = 0;
@@ -208,7 +314,8 @@ int8_t editor_copy(struct EditorConfig* conf) {
     if (!sel->active) {
         struct Row* row = &conf->rows[conf->cy];
         if ((bytes_size = fwrite(row->chars, sizeof(char), row->size, pipe)) ==
-            0) {
+                0 &&
+            row->size) {
             pclose(pipe);
             die("fwrite to pipe failed");
         }
@@ -217,153 +324,146 @@ int8_t editor_copy(struct EditorConfig* conf) {
             sel->end_row == -1 || sel->end_col == -1)
             die("selected text was expected");
 
-        int32_t i = sel->start_row;
-        struct Row* row = &conf->rows[i];
+        // selection columns are render columns
+        int32_t start_row = sel->start_row, start_col = sel->start_col;
+        int32_t end_row = sel->end_row, end_col = sel->end_col;
+        if (start_row > end_row ||
+            (start_row == end_row && start_col > end_col)) {
+            swap(&start_row, &end_row, sizeof(int32_t));
+            swap(&start_col, &end_col, sizeof(int32_t));
+        }
 
-        int32_t numline_offset = editor_row_numline_calculate(row);
+        for (int32_t i = start_row; i <= end_row && i < conf->numrows; i++) {
+            struct Row* row = &conf->rows[i];
 
-        int32_t sel_start_col_cx =
-            editor_update_rx_cx(row, sel->start_row - numline_offset);
-        int32_t sel_end_col_cx =
-            editor_update_rx_cx(row, sel->end_row - numline_offset);
+            int32_t from = 0, to = row->size;
+            if (i == start_row) from = editor_update_rx_cx(row, start_col);
+            if (i == end_row) to = editor_update_rx_cx(row, end_col);
 
-        while (i <= sel->end_row) {
-            row = &conf->rows[i];
-            int32_t temp = 0;
-            if (i == sel->start_row) {
-                // TODO: this check could be wrong, fix it if that is the case
-                if ((temp = fwrite(row->chars + sel_start_col_cx, sizeof(char),
-                                   row->size - sel_start_col_cx, pipe)) == 0) {
-                    pclose(pipe);
-                    die("fwrite to pipe failed");
-                }
-
-            } else if (i == sel->end_row - 1) {
-                if ((temp = fwrite(row->chars + sel_end_col_cx, sizeof(char),
-                                   row->size - sel_end_col_cx, pipe)) == 0) {
-                    pclose(pipe);
-                    die("fwrite to pipe failed");
-                }
-            } else {
-                if ((temp = fwrite(row->chars, sizeof(char), row->size,
-                                   pipe)) == 0) {
-                    pclose(pipe);
-                    die("fwrite to pipe failed");
-                }
+            if (to > from &&
+                fwrite(&row->chars[from], sizeof(char), to - from, pipe) == 0) {
+                pclose(pipe);
+                die("fwrite to pipe failed");
             }
+            bytes_size += max(to - from, 0);
 
             // add new line if not end of row
-            if (i != sel->end_row) {
+            if (i != end_row) {
                 if (fwrite("\n", sizeof(char), 1, pipe) == 0) {
                     pclose(pipe);
                     die("fwrite to pipe failed");
                 }
             }
-
-            bytes_size += temp;
-            i++;
         }
     }
 
-    editor_set_status_message(conf, "copied %d bytes into buffer", bytes_size);
+    editor_set_status_message(conf, "copied %d bytes into buffer",
+                              (int32_t)bytes_size);
     pclose(pipe);
     return EXIT_SUCCESS;
 }
 
 /*
 Function is based on this logic:
-    - step 1: text5
-    - step 2: te(cursor)xt
-    - step 3: te + copy_buffer[0]
-    - step 4: copy_buffer[1]
-                      copy_buffer[2]
-                      ...
-                      copy_buffer[n - 2]
-    - step 5: copy_buffer[n - 1] + xt
-    */
-
-// Step 1 and 2 were already done, we need to just care about the rest
-// We always negate by 1 for each copy_buffer element because each has \n.
+    - step 1: te(cursor)xt
+    - step 2: te + lines[0]
+    - step 3: lines[1]
+              lines[2]
+              ...
+              lines[n - 2]
+    - step 4: lines[n - 1] + xt
+
+Step 3 and 4 are spliced in as one block through editor_insert_rows so the
+rows after the cursor are shifted and highlighted only once.
+*/
+
+int32_t editor_paste_text(struct EditorConfig* conf, const char* text,
+                          int32_t len) {
+    if (!text || len <= 0) return -1;
+    if (conf->cy == conf->numrows) editor_insert_row(conf, conf->cy, "", 0);
 
-static int32_t editor_paste_buffer(struct EditorConfig* conf,
-                                   char** copy_buffer,
-                                   int32_t copy_buffer_size) {
-    if (copy_buffer_size == 0) {
-        return -1;
+    // lines point straight into text, \r\n, \r and \n all end a line
+    int32_t count = 1;
+    for (int32_t i = 0; i < len; i++) {
+        if (text[i] == '\n' || (text[i] == '\r' &&
+                                (i + 1 == len || text[i + 1] != '\n')))
+            count++;
     }
 
-    int32_t total_size = 0;
+    const char** lines = malloc(sizeof(char*) * count);
+    int32_t* lens = malloc(sizeof(int32_t) * count);
+    if (!lines || !lens) die("malloc failed for paste lines");
 
-    // Step 3:
+    int32_t n = 0;
+    const char* start = text;
+    for (int32_t i = 0; i < len; i++) {
+        if (text[i] != '\n' && text[i] != '\r') continue;
+
+        lines[n] = start;
+        lens[n++] = &text[i] - start;
+        if (text[i] == '\r' && i + 1 < len && text[i + 1] == '\n') i++;
+        start = &text[i + 1];
+    }
+    lines[n] = start;
+    lens[n++] = &text[len] - start;
 
     struct Row* row = &conf->rows[conf->cy];
-    int32_t numline_offset = editor_row_numline_calculate(row);
-    int32_t cursor_offset = conf->cx - numline_offset;
+    int32_t at = conf->cx;
+    if (at < 0) at = 0;
+    if (at > row->size) at = row->size;
 
-    char* first_copy_buffer = copy_buffer[0];
-    int32_t first_buffer_size = strlen(first_copy_buffer);
+    int32_t total_size = 0;
+    for (int32_t i = 0; i < count; i++) total_size += lens[i];
 
-    // just get rid of any existing \n
-    if (strchr(first_copy_buffer, '\n')) first_buffer_size--;
+    int32_t remaining_size = row->size - at;
 
-    char* str_appended = malloc(cursor_offset + first_buffer_size + 1);
-    char* str_remaining = strdup(row->chars + cursor_offset);
-    if (!str_remaining || !str_appended)
-        die("malloc/strdup failed for str_append/str_remaining");
+    if (count == 1) {
+        // only one line, so we just splice it inside the current row
+        row->chars =
+            arena_realloc(conf->arena, row->chars, row->size + lens[0] + 1);
 
-    int32_t str_remaining_size = strlen(str_remaining);
+        memmove(&row->chars[at + lens[0]], &row->chars[at], remaining_size);
+        memcpy(&row->chars[at], lines[0], lens[0]);
+        row->size += lens[0];
+        row->chars[row->size] = '\0';
 
-    memcpy(str_appended, row->chars, cursor_offset);
-    memcpy(str_appended + cursor_offset, first_copy_buffer, first_buffer_size);
-    str_appended[cursor_offset + first_buffer_size] = '\0';
+        editor_update_row(conf, row);
+        conf->flags.is_dirty = 1;
+        conf->cx += lens[0];
+    } else {
+        // Step 4: last pasted line takes whatever was after the cursor
+        int32_t last_size = lens[count - 1] + remaining_size;
+        char* last_line = malloc(last_size + 1);
+        if (!last_line) die("malloc failed for last pasted line");
 
-    total_size += first_buffer_size;
+        memcpy(last_line, lines[count - 1], lens[count - 1]);
+        memcpy(&last_line[lens[count - 1]], &row->chars[at], remaining_size);
+        last_line[last_size] = '\0';
 
-    // if there is only one line
-    // go straight to step 5 and just append remaining string
-    if (copy_buffer_size == 1) {
-        str_append(&str_appended, str_remaining);
-        editor_delete_row(conf, conf->cy);
-        editor_insert_row(
-            conf, conf->cy, str_appended,
-            first_buffer_size + cursor_offset + str_remaining_size);
-    } else {
-        // add previous row
-        editor_delete_row(conf, conf->cy);
-        editor_insert_row(conf, conf->cy, str_appended,
-                          first_buffer_size + cursor_offset);
-        // Step 4:
-        if (copy_buffer_size > 1) {
-            for (int32_t i = 1; i < copy_buffer_size - 1; i++) {
-                conf->cy++;
-                editor_insert_row(conf, conf->cy, copy_buffer[i],
-                                  strlen(copy_buffer[i]) - 1);
-                total_size += strlen(copy_buffer[i]) - 1;
-            }
-        }
+        lines[count - 1] = last_line;
+        lens[count - 1] = last_size;
 
-        // Step 5:
-        conf->cy++;
+        // Step 2:
+        row->chars = arena_realloc(conf->arena, row->chars, at + lens[0] + 1);
 
-        row = &conf->rows[conf->cy];
-        char* last_copy_buffer = copy_buffer[copy_buffer_size - 1];
-        int32_t last_row_size = strlen(last_copy_buffer) - 1;
-        last_copy_buffer[last_row_size] = '\0';  // replace \n with \0
+        memcpy(&row->chars[at], lines[0], lens[0]);
+        row->size = at + lens[0];
+        row->chars[row->size] = '\0';
+        editor_update_row(conf, row);
 
-        char* last_modified_row = strdup(last_copy_buffer);
-        str_append(&last_modified_row, str_remaining);
+        // Step 3 and 4:
+        if (editor_insert_rows(conf, conf->cy + 1, &lines[1], &lens[1],
+                               count - 1) == EXIT_FAILURE)
+            die("editor insert rows failed");
 
-        editor_insert_row(conf, conf->cy, last_modified_row,
-                          last_row_size + str_remaining_size);
+        conf->cy += count - 1;
+        conf->cx = last_size - remaining_size;
 
-        numline_offset = editor_row_numline_calculate(&conf->rows[conf->cy]);
-        total_size += strlen(last_modified_row);
-        conf->cx = last_row_size + numline_offset;
-        free(last_modified_row);
+        free(last_line);
     }
 
-    free(str_appended);
-    free(str_remaining);
+    free(lines);
+    free(lens);
 
     return total_size;
 }
@@ -372,35 +472,33 @@ int8_t editor_paste(struct EditorConfig* conf) {
     FILE* pipe = popen("xclip -selection clipboard -o", "r");
     if (!pipe) die("paste pipe failed to initialize");
 
-    char** copy_buffer = NULL;
-    int32_t copy_buffer_size = 0;
-
-    char* content_pasted = NULL;
-    size_t size = 0;
+    // read the whole clipboard at once instead of line by line
+    int32_t cap = 4096;
     int32_t len = 0;
-    while ((len = getline(&content_pasted, &size, pipe)) != -1) {
-        copy_buffer =
-            realloc(copy_buffer, sizeof(char*) * (copy_buffer_size + 1));
-        copy_buffer[copy_buffer_size] = strdup(content_pasted);
-        if (!copy_buffer || !copy_buffer[copy_buffer_size]) {
-            for (int32_t i = 0; i < copy_buffer_size; i++) {
-                free(copy_buffer[i]);
-            }
-            pclose(pipe);
-            die("copy buffer failed during realloc or strdup");
+    char* content_pasted = malloc(cap);
+    if (!content_pasted) die("content_pasted malloc failed");
+
+    size_t nread;
+    while ((nread = fread(&content_pasted[len], sizeof(char), cap - len,
+                          pipe)) > 0) {
+        len += nread;
+        if (len == cap) {
+            cap *= 2;
+            content_pasted = realloc(content_pasted, cap);
+            if (!content_pasted) die("content_pasted realloc failed");
         }
-        copy_buffer_size++;
     }
 
     pclose(pipe);
 
     // empty buffer so we just return
-    if (copy_buffer_size == 1 && len == -1 && *content_pasted == '\0')
-        EXIT_FAILURE;
-    if (conf->cy == conf->numrows) editor_insert_row(conf, conf->cy, "", 0);
+    if (len == 0) {
+        free(content_pasted);
+        return EXIT_FAILURE;
+    }
 
     int32_t total_bytes_pasted =
-        editor_paste_buffer(conf, copy_buffer, copy_buffer_size);
+        editor_paste_text(conf, content_pasted, len);
 
     if (total_bytes_pasted > -1)
         editor_set_status_message(conf, "pasted %d bytes into buffer",
@@ -408,9 +506,6 @@ int8_t editor_paste(struct EditorConfig* conf) {
     else
         editor_set_status_message(conf, "error encountered while pasting...");
 
-    for (int32_t i = 0; i < copy_buffer_size; i++) free(copy_buffer[i]);
-
-    free(copy_buffer);
     free(content_pasted);
 
     return EXIT_SUCCESS;
@@ -432,10 +527,8 @@ int8_t editor_cut(struct EditorConfig* conf) {
         if (conf->rows[conf->cy].size == 0) {
             return 1;
         } else {
-            conf->cx = editor_row_numline_calculate(row);
+            conf->cx = 0;
             editor_delete_row(conf, conf->rowoff);
-            row = &conf->rows[conf->cy];
-            if (row) conf->cx = editor_row_numline_calculate(row);
         }
     };
 
@@ -460,14 +553,13 @@ static void editor_find_callback(struct EditorConfig* conf, char* query,
     static int32_t last_match = -1;
     static int8_t direction = 1;
 
-    static int32_t saved_hl_line;
-    static char* saved_hl = NULL;
+    static int32_t saved_hl_line = -1;
 
-    if (saved_hl) {
-        memcpy(conf->rows[saved_hl_line].hl, saved_hl,
-               conf->rows[saved_hl_line].rsize);
-        free(saved_hl);
-        saved_hl = NULL;
+    // highlighting the row again washes out the match
+    if (saved_hl_line != -1) {
+        if (saved_hl_line < conf->numrows)
+            editor_update_syntax(conf, &conf->rows[saved_hl_line]);
+        saved_hl_line = -1;
     }
 
     if (key == '\r' || key == '\x1b') {
@@ -487,7 +579,7 @@ static void editor_find_callback(struct EditorConfig* conf, char* query,
 
     if (last_match == -1) direction = 1;
     // index of current row
-    int8_t current = last_match;
+    int32_t current = last_match;
 
     for (int32_t i = 0; i < conf->numrows; i++) {
         current += direction;
@@ -497,18 +589,27 @@ static void editor_find_callback(struct EditorConfig* conf, char* query,
             current = 0;
         // if user tried to go back before the first occurred element
 
+        // folded rows are stepped over as a whole, the next step lands
+        // after the fold or on its header
+        int32_t fold = folds_hidden(conf, current);
+        if (fold != -1) {
+            const struct Fold* skipped = &conf->folds.items[fold];
+            current = direction > 0 ? skipped->end : skipped->start + 1;
+            continue;
+        }
+
         struct Row* row = &conf->rows[current];
         char* match = strstr(row->render, query);
         if (match) {
             last_match = current;
             conf->cy = current;
-            conf->cx = editor_update_rx_cx(row, match - row->render);
+            conf->cx = editor_update_rx_cx(
+                row, editor_row_ri_rx(row, match - row->render));
             conf->rowoff = conf->cy;
 
             saved_hl_line = current;
-            saved_hl = malloc(row->rsize);
-            memcpy(saved_hl, row->hl, row->rsize);
-            memset(&row->hl[match - row->render], HL_MATCH, strlen(query));
+            editor_highlight_paint(conf, row, match - row->render,
+                                   strlen(query), HL_MATCH);
 
             break;
         }
@@ -0,0 +1,418 @@
+#include "filewatch.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "arena.h"
+#include "buflist.h"
+#include "config.h"
+#include "core.h"
+#include "gutter.h"
+#include "hexview.h"
+#include "input.h"
+#include "journal.h"
+#include "loop.h"
+#include "rows.h"
+
+#define FILEWATCH_EVENTS \
+    (IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF)
+
+// FNV-1a, only used to tell lines apart
+static uint64_t line_hash(const char* s, int32_t len) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (int32_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)s[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static void index_reserve(struct FileWatch* file, int32_t count) {
+    if (count <= file->cap) return;
+
+    if (!file->cap) file->cap = 64;
+    while (count > file->cap) file->cap *= 2;
+    file->hashes = realloc(file->hashes, sizeof(uint64_t) * file->cap);
+    if (!file->hashes) die("file index realloc failed");
+}
+
+// reads len bytes of path starting at offset, returns NULL on failure
+static char* read_range(const char* path, int64_t offset, int64_t len) {
+    int32_t fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) return NULL;
+
+    char* text = malloc(len + 1);
+    if (!text) die("file read malloc failed");
+
+    int64_t got = 0;
+    while (got < len) {
+        int64_t chunk = min(len - got, FILEWATCH_READ_CHUNK);
+        ssize_t n = pread(fd, &text[got], chunk, offset + got);
+        if (n <= 0) break;
+        got += n;
+    }
+    close(fd);
+
+    // the file shrank under us, the next event will sort it out
+    if (got != len) {
+        free(text);
+        return NULL;
+    }
+    return text;
+}
+
+int8_t filewatch_create(struct EditorConfig* conf) {
+    // without inotify the editor keeps working, files just aren't watched
+    conf->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    conf->filewatch_timer = -1;
+
+    return EXIT_SUCCESS;
+}
+
+int8_t filewatch_destroy(struct EditorConfig* conf) {
+    if (conf->inotify_fd != -1) close(conf->inotify_fd);
+    conf->inotify_fd = -1;
+
+    return EXIT_SUCCESS;
+}
+
+int8_t filewatch_sync(struct EditorConfig* conf) {
+    struct FileWatch* file = &conf->file;
+
+    index_reserve(file, conf->numrows);
+    for (int32_t i = 0; i < conf->numrows; i++) {
+        file->hashes[i] = line_hash(conf->rows[i].chars, conf->rows[i].size);
+    }
+    file->count = conf->numrows;
+    file->pending = 0;
+    file->size = 0;
+    file->tail_bytes = 0;
+
+    struct stat st;
+    if (!conf->filepath || stat(conf->filepath, &st) == -1)
+        return EXIT_FAILURE;
+
+    file->size = st.st_size;
+    file->mtime = st.st_mtim;
+
+    // a last line without '\n' is read again once the file grows. Its bytes
+    // are counted on disk, the row may have lost trailing '\r'
+    if (st.st_size > 0 && conf->numrows) {
+        int64_t len = min(st.st_size, conf->rows[conf->numrows - 1].size +
+                                          (int64_t)FILEWATCH_READ_CHUNK);
+        char* text = read_range(conf->filepath, st.st_size - len, len);
+        if (text && text[len - 1] != '\n') {
+            int64_t start = len;
+            while (start > 0 && text[start - 1] != '\n') start--;
+            file->tail_bytes = len - start;
+        }
+        free(text);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int8_t filewatch_attach(struct EditorConfig* conf) {
+    if (!conf->filepath) return EXIT_FAILURE;
+
+    struct FileWatch* file = &conf->file;
+    if (file->wd == -1 && conf->inotify_fd != -1)
+        file->wd = inotify_add_watch(conf->inotify_fd, conf->filepath,
+                                     FILEWATCH_EVENTS);
+
+    return filewatch_sync(conf);
+}
+
+int8_t filewatch_forget(struct EditorConfig* conf) {
+    struct FileWatch* file = &conf->file;
+    if (file->wd != -1 && conf->inotify_fd != -1)
+        inotify_rm_watch(conf->inotify_fd, file->wd);
+
+    free(file->hashes);
+    file->hashes = NULL;
+    file->count = 0;
+    file->cap = 0;
+    file->wd = -1;
+    file->pending = 0;
+    file->follow = 0;
+
+    return EXIT_SUCCESS;
+}
+
+static void filewatch_clamp_cursor(struct EditorConfig* conf) {
+    if (conf->cy > conf->numrows) conf->cy = conf->numrows;
+    if (conf->cy < conf->numrows)
+        conf->cx = min(conf->cx, conf->rows[conf->cy].size);
+    else
+        conf->cx = 0;
+}
+
+// rows coming from disk aren't changes of ours
+static void filewatch_clean(struct EditorConfig* conf, int32_t from,
+                            int32_t to) {
+    for (int32_t i = from; i < to; i++) {
+        conf->rows[i].marker = GUTTER_MARK_NONE;
+    }
+    conf->flags.is_dirty = 0;
+    journal_clean(conf);
+}
+
+// follow mode, only the bytes past the last known size get read
+static int8_t filewatch_tail(struct EditorConfig* conf, const struct stat* st) {
+    struct FileWatch* file = &conf->file;
+    int64_t from = file->size - file->tail_bytes;
+    int64_t len = st->st_size - from;
+
+    char* text = read_range(conf->filepath, from, len);
+    if (!text) return EXIT_FAILURE;
+
+    const char** lines;
+    int32_t* lens;
+    int32_t count = editor_split_lines(text, len, &lines, &lens);
+
+    // the old unterminated last line got continued
+    int32_t first = 0;
+    if (file->tail_bytes && conf->numrows && count) {
+        int32_t last = conf->numrows - 1;
+        struct Row* row = &conf->rows[last];
+        row->chars = arena_realloc(conf->arena, row->chars, lens[0] + 1);
+        memcpy(row->chars, lines[0], lens[0]);
+        row->size = lens[0];
+        row->chars[row->size] = '\0';
+        editor_update_row(conf, row);
+
+        file->hashes[last] = line_hash(lines[0], lens[0]);
+        first = 1;
+    }
+
+    int32_t at = conf->numrows;
+    if (editor_insert_rows(conf, at, &lines[first], &lens[first],
+                           count - first) == EXIT_FAILURE)
+        die("editor insert rows failed");
+    filewatch_clean(conf, at - first, conf->numrows);
+
+    index_reserve(file, conf->numrows);
+    for (int32_t i = first; i < count; i++) {
+        file->hashes[at + i - first] = line_hash(lines[i], lens[i]);
+    }
+    file->count = conf->numrows;
+    file->size = st->st_size;
+    file->mtime = st->st_mtim;
+    // counted on disk, the row may have lost a trailing '\r'
+    file->tail_bytes =
+        (len > 0 && text[len - 1] != '\n') ? &text[len] - lines[count - 1] : 0;
+
+    // tail -f keeps the newest line in sight
+    if (conf->numrows) {
+        conf->cy = conf->numrows - 1;
+        conf->cx = 0;
+    }
+
+    free(lines);
+    free(lens);
+    free(text);
+
+    return EXIT_SUCCESS;
+}
+
+/*
+    The whole file has to be read to know what changed, but only the rows
+    between the common head and tail are rebuilt and highlighted again
+*/
+static int8_t filewatch_reload(struct EditorConfig* conf,
+                               const struct stat* st) {
+    struct FileWatch* file = &conf->file;
+
+    char* text = read_range(conf->filepath, 0, st->st_size);
+    if (!text) return EXIT_FAILURE;
+
+    const char** lines;
+    int32_t* lens;
+    int32_t count = editor_split_lines(text, st->st_size, &lines, &lens);
+
+    uint64_t* hashes = malloc(sizeof(uint64_t) * max(count, 1));
+    if (!hashes) die("file index malloc failed");
+    for (int32_t i = 0; i < count; i++) {
+        hashes[i] = line_hash(lines[i], lens[i]);
+    }
+
+    // a stale index can't be trusted, rebuild everything then
+    int32_t old = conf->numrows;
+    int32_t head = 0, tail = 0;
+    if (file->count == old) {
+        while (head < old && head < count && file->hashes[head] == hashes[head])
+            head++;
+        while (tail < old - head && tail < count - head &&
+               file->hashes[old - 1 - tail] == hashes[count - 1 - tail])
+            tail++;
+    }
+
+    int32_t removed = old - head - tail;
+    int32_t added = count - head - tail;
+    editor_delete_rows(conf, head, removed);
+    if (editor_insert_rows(conf, head, &lines[head], &lens[head], added) ==
+        EXIT_FAILURE)
+        die("editor insert rows failed");
+    filewatch_clean(conf, head, head + added);
+
+    // the cursor stays on the same text when the change is above it
+    if (conf->cy >= old - tail) conf->cy += added - removed;
+    filewatch_clamp_cursor(conf);
+
+    free(file->hashes);
+    file->hashes = hashes;
+    file->count = count;
+    file->cap = max(count, 1);
+    file->size = st->st_size;
+    file->mtime = st->st_mtim;
+    file->tail_bytes = (st->st_size > 0 && text[st->st_size - 1] != '\n')
+                           ? &text[st->st_size] - lines[count - 1]
+                           : 0;
+
+    if (removed || added)
+        editor_set_status_message(conf,
+                                  "%.40s changed on disk, %d rows reloaded",
+                                  conf->filepath, added);
+
+    free(lines);
+    free(lens);
+    free(text);
+
+    return EXIT_SUCCESS;
+}
+
+static void filewatch_check(struct EditorConfig* conf) {
+    struct FileWatch* file = &conf->file;
+    file->pending = 0;
+    if (!conf->filepath) return;
+
+    // the old inode went away, the path may point to a new file by now
+    if (file->wd == -1 && conf->inotify_fd != -1) {
+        file->wd = inotify_add_watch(conf->inotify_fd, conf->filepath,
+                                     FILEWATCH_EVENTS);
+        if (file->wd == -1) {
+            editor_set_status_message(conf, "%.40s was removed from disk",
+                                      conf->filepath);
+            return;
+        }
+    }
+
+    // hex buffers map the file, there are no rows to reload
+    if (conf->hex.active) {
+        hexview_refresh(conf);
+        return;
+    }
+
+    struct stat st;
+    if (stat(conf->filepath, &st) == -1) return;
+
+    // our own saves land here too, they were synced already
+    if (st.st_size == file->size && st.st_mtim.tv_sec == file->mtime.tv_sec &&
+        st.st_mtim.tv_nsec == file->mtime.tv_nsec)
+        return;
+
+    if (conf->flags.is_dirty) {
+        editor_set_status_message(
+            conf, "%.40s changed on disk, buffer has unsaved changes",
+            conf->filepath);
+        return;
+    }
+
+    if (file->follow && st.st_size >= file->size)
+        filewatch_tail(conf, &st);
+    else
+        filewatch_reload(conf, &st);
+}
+
+static struct FileWatch* filewatch_find(struct EditorConfig* conf,
+                                        int32_t wd) {
+    if (conf->file.wd == wd) return &conf->file;
+
+    struct EditorBufList* buffers = &conf->buffers;
+    for (int32_t i = 0; i < buffers->count; i++) {
+        if (i != buffers->current && buffers->items[i].file.wd == wd)
+            return &buffers->items[i].file;
+    }
+    return NULL;
+}
+
+static void on_inotify(struct EditorConfig* conf, void* data) {
+    (void)data;
+    char buf[4096]
+        __attribute__((aligned(__alignof__(struct inotify_event))));
+    int8_t seen = 0;
+
+    ssize_t len;
+    while ((len = read(conf->inotify_fd, buf, sizeof(buf))) > 0) {
+        const struct inotify_event* event;
+        for (char* ptr = buf; ptr < buf + len;
+             ptr += sizeof(struct inotify_event) + event->len) {
+            event = (const struct inotify_event*)ptr;
+
+            struct FileWatch* file = filewatch_find(conf, event->wd);
+            if (!file) continue;
+
+            if (event->mask & (IN_MOVE_SELF | IN_DELETE_SELF)) {
+                inotify_rm_watch(conf->inotify_fd, file->wd);
+                file->wd = -1;
+            }
+            if (event->mask & IN_IGNORED) file->wd = -1;
+
+            file->pending = 1;
+            seen = 1;
+        }
+    }
+
+    // writers usually come in bursts, wait for them to settle
+    if (seen)
+        loop_timer_arm(conf->loop, conf->filewatch_timer,
+                       FILEWATCH_DEBOUNCE_MS, 0);
+}
+
+static void on_debounce(struct EditorConfig* conf, void* data) {
+    (void)data;
+    struct EditorBufList* buffers = &conf->buffers;
+    int32_t current = buffers->current;
+
+    if (conf->file.pending) filewatch_check(conf);
+
+    // parked buffers are swapped in just long enough to be patched
+    for (int32_t i = 0; i < buffers->count; i++) {
+        if (i == current || !buffers->items[i].file.pending) continue;
+        buflist_select(conf, i);
+        filewatch_check(conf);
+    }
+    buflist_select(conf, current);
+
+    loop_request_frame(conf->loop);
+}
+
+int8_t filewatch_start(struct EditorConfig* conf) {
+    if (conf->inotify_fd == -1) return EXIT_FAILURE;
+
+    if (loop_watch_add(conf->loop, conf->inotify_fd, on_inotify, NULL) == -1)
+        return EXIT_FAILURE;
+    conf->filewatch_timer = loop_timer_add(conf->loop, on_debounce, NULL);
+    if (conf->filewatch_timer == -1) return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
+
+int8_t filewatch_toggle_follow(struct EditorConfig* conf) {
+    struct FileWatch* file = &conf->file;
+    if (!conf->filepath) return EXIT_FAILURE;
+
+    file->follow = !file->follow;
+    if (file->follow && conf->numrows) {
+        conf->cy = conf->numrows - 1;
+        conf->cx = 0;
+    }
+    editor_set_status_message(conf, "follow mode %s",
+                              file->follow ? "on" : "off");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,276 @@
+#include "folds.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "buffer.h"
+#include "config.h"
+#include "core.h"
+#include "highlight.h"
+#include "input.h"
+#include "rows.h"
+#include "wrap.h"
+
+static void folds_reserve(struct EditorFolds* folds, int32_t count) {
+    if (count <= folds->cap) return;
+
+    folds->cap = folds->cap ? folds->cap * 2 : 8;
+    folds->items = realloc(folds->items, sizeof(struct Fold) * folds->cap);
+    folds->before = realloc(folds->before, sizeof(int32_t) * (folds->cap + 1));
+    if (!folds->items || !folds->before) die("folds realloc failed");
+}
+
+// before[count] ends up holding every hidden row
+static void folds_sum(struct EditorFolds* folds) {
+    if (!folds->before) return;
+
+    folds->before[0] = 0;
+    for (int32_t i = 0; i < folds->count; i++) {
+        folds->before[i + 1] =
+            folds->before[i] + folds->items[i].end - folds->items[i].start;
+    }
+}
+
+// number of folds whose header comes before row
+static int32_t folds_count_before(const struct EditorFolds* folds,
+                                  int32_t row) {
+    int32_t lo = 0, hi = folds->count;
+    while (lo < hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if (folds->items[mid].start < row)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+int8_t folds_create(struct EditorConfig* conf) {
+    conf->folds.items = NULL;
+    conf->folds.before = NULL;
+    conf->folds.count = 0;
+    conf->folds.cap = 0;
+    return EXIT_SUCCESS;
+}
+
+int8_t folds_destroy(struct EditorConfig* conf) {
+    free(conf->folds.items);
+    free(conf->folds.before);
+    return folds_create(conf);
+}
+
+int8_t folds_clear(struct EditorConfig* conf) {
+    conf->folds.count = 0;
+    folds_sum(&conf->folds);
+    wrap_invalidate(conf);
+    return EXIT_SUCCESS;
+}
+
+int32_t folds_hidden(struct EditorConfig* conf, int32_t row) {
+    const struct EditorFolds* folds = &conf->folds;
+    int32_t k = folds_count_before(folds, row);
+    if (k > 0 && row <= folds->items[k - 1].end) return k - 1;
+    return -1;
+}
+
+int32_t folds_header(struct EditorConfig* conf, int32_t row) {
+    const struct EditorFolds* folds = &conf->folds;
+    int32_t k = folds_count_before(folds, row);
+    if (k < folds->count && folds->items[k].start == row) return k;
+    return -1;
+}
+
+int32_t folds_visible_index(struct EditorConfig* conf, int32_t row) {
+    const struct EditorFolds* folds = &conf->folds;
+    if (!folds->count) return row;
+
+    int32_t k = folds_count_before(folds, row);
+    if (k > 0 && row <= folds->items[k - 1].end)
+        return folds->items[k - 1].start - folds->before[k - 1];
+    return row - folds->before[k];
+}
+
+int32_t folds_file_row(struct EditorConfig* conf, int32_t visible) {
+    const struct EditorFolds* folds = &conf->folds;
+    if (!folds->count) return visible;
+
+    // headers sit at visible index start - before[i], find the last one
+    // above the line we're after
+    int32_t lo = 0, hi = folds->count;
+    while (lo < hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if (folds->items[mid].start - folds->before[mid] < visible)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return visible + folds->before[lo];
+}
+
+int32_t folds_next(struct EditorConfig* conf, int32_t row, int32_t direction) {
+    row += direction;
+    int32_t i = folds_hidden(conf, row);
+    if (i == -1) return row;
+
+    return direction > 0 ? conf->folds.items[i].end + 1
+                         : conf->folds.items[i].start;
+}
+
+static int32_t row_indent(const struct Row* row) {
+    int32_t n = 0;
+    while (n < row->rsize && row->render[n] == ' ') n++;
+    return n;
+}
+
+/*
+    last row of the block opened on row, the row holding the matching
+    close brace, or -1 when row opens nothing
+*/
+static int32_t folds_brace_end(struct EditorConfig* conf, int32_t row) {
+    char open = '{', close = '}';
+    if (conf->syntax && conf->syntax->indent_end) {
+        open = conf->syntax->indent_start;
+        close = conf->syntax->indent_end;
+    }
+
+    int32_t depth = 0;
+    for (int32_t i = row; i < conf->numrows; i++) {
+        const struct Row* r = &conf->rows[i];
+        char quote = 0;
+
+        for (int32_t j = 0; j < r->size; j++) {
+            char c = r->chars[j];
+            if (quote) {
+                if (c == '\\')
+                    j++;
+                else if (c == quote)
+                    quote = 0;
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+            } else if (c == open) {
+                depth++;
+            } else if (c == close) {
+                depth--;
+            }
+        }
+
+        // the header has to leave a brace open for there to be a block
+        if (i == row && depth <= 0) return -1;
+        if (depth <= 0) return i;
+    }
+    return conf->numrows - 1;
+}
+
+// last row indented deeper than row, blank rows don't end the block
+static int32_t folds_indent_end(struct EditorConfig* conf, int32_t row) {
+    int32_t indent = row_indent(&conf->rows[row]);
+    int32_t end = -1;
+
+    for (int32_t i = row + 1; i < conf->numrows; i++) {
+        const struct Row* r = &conf->rows[i];
+        int32_t n = row_indent(r);
+        if (n == r->rsize) continue;
+        if (n <= indent) break;
+        end = i;
+    }
+    return end;
+}
+
+int8_t folds_toggle(struct EditorConfig* conf, int32_t row) {
+    struct EditorFolds* folds = &conf->folds;
+    if (row < 0 || row >= conf->numrows) return EXIT_FAILURE;
+
+    int32_t open = folds_header(conf, row);
+    if (open != -1) {
+        memmove(&folds->items[open], &folds->items[open + 1],
+                sizeof(struct Fold) * (folds->count - open - 1));
+        folds->count--;
+        folds_sum(folds);
+        wrap_invalidate(conf);
+        return EXIT_SUCCESS;
+    }
+
+    int32_t end = folds_brace_end(conf, row);
+    if (end <= row) end = folds_indent_end(conf, row);
+    if (end <= row) {
+        editor_set_status_message(conf, "nothing to fold here");
+        return EXIT_FAILURE;
+    }
+
+    // closed folds inside the new one are absorbed
+    int32_t first = folds_count_before(folds, row);
+    int32_t last = first;
+    while (last < folds->count && folds->items[last].start <= end) {
+        end = max(end, folds->items[last].end);
+        last++;
+    }
+
+    if (last == first) {
+        folds_reserve(folds, folds->count + 1);
+        memmove(&folds->items[first + 1], &folds->items[first],
+                sizeof(struct Fold) * (folds->count - first));
+        folds->count++;
+    } else {
+        memmove(&folds->items[first + 1], &folds->items[last],
+                sizeof(struct Fold) * (folds->count - last));
+        folds->count -= last - first - 1;
+    }
+
+    folds->items[first].start = row;
+    folds->items[first].end = end;
+    folds_sum(folds);
+    wrap_invalidate(conf);
+
+    return EXIT_SUCCESS;
+}
+
+int8_t folds_shift(struct EditorConfig* conf, int32_t at, int32_t count) {
+    struct EditorFolds* folds = &conf->folds;
+    if (!folds->count || !count) return EXIT_SUCCESS;
+
+    int32_t kept = 0;
+    for (int32_t i = 0; i < folds->count; i++) {
+        struct Fold fold = folds->items[i];
+
+        if (count > 0) {
+            if (fold.start < at && at <= fold.end) continue;
+            if (fold.start >= at) {
+                fold.start += count;
+                fold.end += count;
+            }
+        } else {
+            int32_t removed_end = at - count;  // one past the last removed
+            if (fold.start >= removed_end) {
+                fold.start += count;
+                fold.end += count;
+            } else if (fold.end >= at) {
+                continue;
+            }
+        }
+
+        folds->items[kept++] = fold;
+    }
+
+    folds->count = kept;
+    folds_sum(folds);
+
+    return EXIT_SUCCESS;
+}
+
+int8_t folds_draw_header(struct EditorConfig* conf, struct ABuf* ab,
+                         int32_t row, int32_t cols) {
+    int32_t i = folds_header(conf, row);
+    if (i == -1 || cols <= 0) return EXIT_SUCCESS;
+
+    const struct Fold* fold = &conf->folds.items[i];
+    char buf[32];
+    int32_t len = snprintf(buf, sizeof(buf), " ... %d lines",
+                           fold->end - fold->start);
+
+    ab_append(ab, "\x1b[2m", 4);  // faint
+    ab_append(ab, buf, min(len, cols));
+    ab_append(ab, "\x1b[22m", 5);
+
+    return EXIT_SUCCESS;
+}
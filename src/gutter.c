@@ -0,0 +1,70 @@
+#include "gutter.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "buffer.h"
+#include "config.h"
+#include "core.h"
+#include "folds.h"
+#include "rows.h"
+
+int8_t gutter_update(struct EditorConfig* conf) {
+    struct EditorGutter* gutter = &conf->gutter;
+
+    gutter->digits = max(count_digits(conf->numrows), 1);
+    gutter->width = gutter->digits + 1;
+    if (gutter->flags & GUTTER_MARKERS) gutter->width++;
+
+    // never leave less than one column for text
+    if (gutter->width >= conf->screen_cols) gutter->width = 0;
+
+    return EXIT_SUCCESS;
+}
+
+int8_t gutter_toggle(struct EditorConfig* conf, int8_t flag) {
+    conf->gutter.flags ^= flag;
+    return gutter_update(conf);
+}
+
+int8_t gutter_draw_row(struct EditorConfig* conf, struct ABuf* ab,
+                       int32_t filerow) {
+    struct EditorGutter* gutter = &conf->gutter;
+    if (gutter->width == 0) return EXIT_SUCCESS;
+
+    if (gutter->flags & GUTTER_MARKERS) {
+        switch (conf->rows[filerow].marker) {
+            case GUTTER_MARK_ADDED:
+                ab_append(ab, "\x1b[32m+\x1b[39m", 11);
+                break;
+            case GUTTER_MARK_CHANGED:
+                ab_append(ab, "\x1b[33m~\x1b[39m", 11);
+                break;
+            default:
+                ab_append(ab, " ", 1);
+        }
+    }
+
+    // the cursor row keeps its absolute number in relative mode
+    int32_t number = filerow + 1;
+    if ((gutter->flags & GUTTER_RELATIVE) && filerow != conf->cy)
+        number = abs(folds_visible_index(conf, filerow) -
+                     folds_visible_index(conf, conf->cy));
+
+    char buf[16];
+    int32_t len = snprintf(buf, sizeof(buf), "%*d ", gutter->digits, number);
+    ab_append(ab, buf, len);
+
+    return EXIT_SUCCESS;
+}
+
+int32_t gutter_text_cols(const struct EditorConfig* conf) {
+    return conf->screen_cols - conf->gutter.width;
+}
+
+int8_t gutter_clear_markers(struct EditorConfig* conf) {
+    for (int32_t i = 0; i < conf->numrows; i++) {
+        conf->rows[i].marker = GUTTER_MARK_NONE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,428 @@
+#include "hexview.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "buffer.h"
+#include "config.h"
+#include "core.h"
+#include "input.h"
+
+#define HEXVIEW_WRITE_CHUNK 4096
+
+// bytes per line for the view width, from 16 down to 1
+static int32_t hexview_layout(struct EditorConfig* conf, int32_t* digits) {
+    *digits = conf->hex.size > 0xffffffffLL ? 16 : 8;
+
+    // offset, two spaces, "xx " per byte, a space and one ascii column each
+    int32_t bpl = 16;
+    while (bpl > 1 && *digits + 3 + bpl * 4 > conf->screen_cols) bpl /= 2;
+    return bpl;
+}
+
+// first patch at or after offset
+static int32_t hexview_lower_bound(const struct HexView* hex, int64_t offset) {
+    int32_t lo = 0, hi = hex->count;
+    while (lo < hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if (hex->patches[mid].offset < offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static uint8_t hexview_byte(const struct HexView* hex, int64_t offset) {
+    int32_t i = hexview_lower_bound(hex, offset);
+    if (i < hex->count && hex->patches[i].offset == offset)
+        return hex->patches[i].byte;
+    return hex->map[offset];
+}
+
+static void hexview_patch(struct HexView* hex, int64_t offset, uint8_t byte) {
+    int32_t i = hexview_lower_bound(hex, offset);
+    int8_t found = i < hex->count && hex->patches[i].offset == offset;
+
+    // back to what is on disk, nothing left to write
+    if (byte == hex->map[offset]) {
+        if (found) {
+            memmove(&hex->patches[i], &hex->patches[i + 1],
+                    sizeof(struct HexPatch) * (hex->count - i - 1));
+            hex->count--;
+        }
+        return;
+    }
+
+    if (!found) {
+        if (hex->count == hex->cap) {
+            hex->cap = hex->cap ? hex->cap * 2 : 64;
+            hex->patches =
+                realloc(hex->patches, sizeof(struct HexPatch) * hex->cap);
+            if (!hex->patches) die("hex patches realloc failed");
+        }
+        memmove(&hex->patches[i + 1], &hex->patches[i],
+                sizeof(struct HexPatch) * (hex->count - i));
+        hex->count++;
+        hex->patches[i].offset = offset;
+    }
+    hex->patches[i].byte = byte;
+}
+
+int8_t hexview_detect(const char* path) {
+    int32_t fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) return 0;
+
+    char buf[HEXVIEW_SNIFF_SIZE];
+    ssize_t len = read(fd, buf, sizeof(buf));
+    close(fd);
+
+    return len > 0 && memchr(buf, '\0', len) != NULL;
+}
+
+int8_t hexview_init(struct EditorConfig* conf) {
+    struct HexView* hex = &conf->hex;
+    hex->map = NULL;
+    hex->size = 0;
+    hex->fd = -1;
+    hex->writable = 0;
+    hex->active = 0;
+    hex->cursor = 0;
+    hex->top = 0;
+    hex->nibble = 0;
+    hex->patches = NULL;
+    hex->count = 0;
+    hex->cap = 0;
+
+    return EXIT_SUCCESS;
+}
+
+int8_t hexview_open(struct EditorConfig* conf, const char* path) {
+    struct HexView* hex = &conf->hex;
+    hexview_close(conf);
+
+    hex->fd = open(path, O_RDWR | O_CLOEXEC);
+    hex->writable = hex->fd != -1;
+    if (hex->fd == -1) hex->fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (hex->fd == -1) return EXIT_FAILURE;
+
+    struct stat st;
+    if (fstat(hex->fd, &st) == -1) {
+        hexview_close(conf);
+        return EXIT_FAILURE;
+    }
+    hex->size = st.st_size;
+
+    // pages are only read once they get drawn
+    if (hex->size) {
+        void* map = mmap(NULL, hex->size, PROT_READ, MAP_SHARED, hex->fd, 0);
+        if (map == MAP_FAILED) {
+            hexview_close(conf);
+            return EXIT_FAILURE;
+        }
+        hex->map = map;
+    }
+
+    hex->active = 1;
+    conf->flags.is_dirty = 0;
+
+    return EXIT_SUCCESS;
+}
+
+int8_t hexview_close(struct EditorConfig* conf) {
+    struct HexView* hex = &conf->hex;
+
+    if (hex->map) munmap((void*)hex->map, hex->size);
+    if (hex->fd != -1) close(hex->fd);
+    free(hex->patches);
+
+    return hexview_init(conf);
+}
+
+int8_t hexview_refresh(struct EditorConfig* conf) {
+    struct HexView* hex = &conf->hex;
+    struct stat st;
+    if (!hex->active || fstat(hex->fd, &st) == -1 || st.st_size == hex->size)
+        return EXIT_SUCCESS;
+
+    if (hex->map) munmap((void*)hex->map, hex->size);
+    hex->map = NULL;
+    hex->size = st.st_size;
+
+    if (hex->size) {
+        void* map = mmap(NULL, hex->size, PROT_READ, MAP_SHARED, hex->fd, 0);
+        if (map == MAP_FAILED)
+            hex->size = 0;
+        else
+            hex->map = map;
+    }
+
+    // patches past the new end have nothing left to change
+    hex->count = hexview_lower_bound(hex, hex->size);
+    if (hex->cursor >= hex->size) {
+        hex->cursor = max(hex->size - 1, 0);
+        hex->nibble = 0;
+    }
+    hex->top = min(hex->top, hex->cursor);
+    conf->flags.is_dirty = hex->count > 0;
+
+    editor_set_status_message(conf, "%.40s changed on disk, %lld bytes mapped",
+                              conf->filepath, (long long)hex->size);
+
+    return EXIT_SUCCESS;
+}
+
+// runs of neighbouring patches go out in one pwrite each
+int8_t hexview_save(struct EditorConfig* conf) {
+    struct HexView* hex = &conf->hex;
+    if (!hex->writable) {
+        editor_set_status_message(conf, "file is read only");
+        return EXIT_FAILURE;
+    }
+
+    uint8_t buf[HEXVIEW_WRITE_CHUNK];
+    int32_t written = 0;
+
+    for (int32_t i = 0; i < hex->count;) {
+        int64_t start = hex->patches[i].offset;
+        int32_t len = 0;
+        while (i < hex->count && len < HEXVIEW_WRITE_CHUNK &&
+               hex->patches[i].offset == start + len) {
+            buf[len++] = hex->patches[i++].byte;
+        }
+
+        if (pwrite(hex->fd, buf, len, start) != len) {
+            editor_set_status_message(conf, "write failed at 0x%llx",
+                                      (unsigned long long)start);
+            return EXIT_FAILURE;
+        }
+        written += len;
+    }
+    fdatasync(hex->fd);
+
+    // the shared mapping already shows what was written
+    hex->count = 0;
+    conf->flags.is_dirty = 0;
+    editor_set_status_message(conf, "%d bytes written in place", written);
+
+    return EXIT_SUCCESS;
+}
+
+static int8_t hexview_edit(struct EditorConfig* conf, int32_t digit) {
+    struct HexView* hex = &conf->hex;
+    if (!hex->writable) {
+        editor_set_status_message(conf, "file is read only");
+        return EXIT_FAILURE;
+    }
+    if (hex->cursor >= hex->size) return EXIT_FAILURE;
+
+    uint8_t byte = hexview_byte(hex, hex->cursor);
+    if (hex->nibble == 0)
+        byte = (byte & 0x0f) | (digit << 4);
+    else
+        byte = (byte & 0xf0) | digit;
+    hexview_patch(hex, hex->cursor, byte);
+    conf->flags.is_dirty = hex->count > 0;
+
+    if (hex->nibble == 0) {
+        hex->nibble = 1;
+    } else if (hex->cursor + 1 < hex->size) {
+        hex->nibble = 0;
+        hex->cursor++;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int32_t hex_digit(int32_t c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+int8_t hexview_process_key(struct EditorConfig* conf, int32_t c) {
+    struct HexView* hex = &conf->hex;
+    hexview_refresh(conf);
+
+    int32_t digits;
+    int64_t bpl = hexview_layout(conf, &digits);
+    int64_t cursor = hex->cursor;
+
+    switch (c) {
+        // buffers, views, saving and quitting work as usual
+        case CTRL_KEY('q'):
+        case CTRL_KEY('s'):
+        case CTRL_KEY('o'):
+        case CTRL_KEY('w'):
+        case ALT_ARROW_LEFT:
+        case ALT_ARROW_RIGHT:
+        case F5:
+        case F6:
+        case F7:
+        case F8:
+        case F11:
+        case INTERRUPT_ENCOUNTERED:
+        case HANGUP:
+            return EXIT_FAILURE;
+
+        case ARROW_LEFT:
+            cursor--;
+            break;
+        case ARROW_RIGHT:
+            cursor++;
+            break;
+        case ARROW_UP:
+            cursor -= bpl;
+            break;
+        case ARROW_DOWN:
+            cursor += bpl;
+            break;
+        case PAGE_UP:
+            cursor -= bpl * conf->screen_rows;
+            break;
+        case PAGE_DOWN:
+            cursor += bpl * conf->screen_rows;
+            break;
+        case HOME_KEY:
+            cursor -= cursor % bpl;
+            break;
+        case END_KEY:
+            cursor += bpl - 1 - cursor % bpl;
+            break;
+
+        // steps back and drops the edit of the byte it lands on
+        case BACKSPACE:
+        case CTRL_KEY('h'):
+            if (hex->nibble == 0) cursor--;
+            if (cursor >= 0 && cursor < hex->size)
+                hexview_patch(hex, cursor, hex->map[cursor]);
+            conf->flags.is_dirty = hex->count > 0;
+            break;
+
+        default:
+            if (hex_digit(c) != -1) hexview_edit(conf, hex_digit(c));
+            return EXIT_SUCCESS;
+    }
+
+    if (cursor > hex->size - 1) cursor = hex->size - 1;
+    if (cursor < 0) cursor = 0;
+    hex->cursor = cursor;
+    hex->nibble = 0;
+
+    return EXIT_SUCCESS;
+}
+
+int8_t hexview_scroll(struct EditorConfig* conf) {
+    struct HexView* hex = &conf->hex;
+    // the watch only fires after the debounce, a frame may come first
+    hexview_refresh(conf);
+
+    int32_t digits;
+    int64_t bpl = hexview_layout(conf, &digits);
+    int64_t rows = max(conf->screen_rows, 1);
+
+    // another view may have left top on a different line width
+    hex->top -= hex->top % bpl;
+
+    if (hex->cursor < hex->top)
+        hex->top = hex->cursor - hex->cursor % bpl;
+    else if (hex->cursor >= hex->top + rows * bpl)
+        hex->top = (hex->cursor / bpl - rows + 1) * bpl;
+
+    return EXIT_SUCCESS;
+}
+
+static void hexview_draw_line(struct EditorConfig* conf, struct ABuf* ab,
+                              int64_t line, int32_t bpl, int32_t digits) {
+    const struct HexView* hex = &conf->hex;
+    int32_t patch = hexview_lower_bound(hex, line);
+    uint8_t bytes[16];
+    int8_t patched[16];
+
+    char buf[32];
+    int32_t len = snprintf(buf, sizeof(buf), "%0*llx  ", digits,
+                           (unsigned long long)line);
+    ab_append(ab, buf, len);
+
+    // one pass over the patches of the line instead of a lookup per byte
+    int32_t n = (int32_t)min((int64_t)bpl, hex->size - line);
+    for (int32_t i = 0; i < n; i++) {
+        bytes[i] = hex->map[line + i];
+        patched[i] = 0;
+        if (patch < hex->count && hex->patches[patch].offset == line + i) {
+            bytes[i] = hex->patches[patch++].byte;
+            patched[i] = 1;
+        }
+    }
+
+    for (int32_t i = 0; i < bpl; i++) {
+        if (i >= n) {
+            ab_append(ab, "   ", 3);
+            continue;
+        }
+        len = snprintf(buf, sizeof(buf), "%02x ", bytes[i]);
+        if (patched[i]) ab_append(ab, "\x1b[33m", 5);
+        ab_append(ab, buf, len);
+        if (patched[i]) ab_append(ab, "\x1b[39m", 5);
+    }
+
+    ab_append(ab, " ", 1);
+    for (int32_t i = 0; i < n; i++) {
+        char c = (bytes[i] >= 32 && bytes[i] < 127) ? bytes[i] : '.';
+        if (patched[i]) ab_append(ab, "\x1b[33m", 5);
+        ab_append(ab, &c, 1);
+        if (patched[i]) ab_append(ab, "\x1b[39m", 5);
+    }
+}
+
+int8_t hexview_draw_rows(struct EditorConfig* conf, struct ABuf* ab) {
+    struct HexView* hex = &conf->hex;
+    int32_t digits;
+    int32_t bpl = hexview_layout(conf, &digits);
+    int8_t fits = digits + 3 + bpl * 4 <= conf->screen_cols;
+
+    int8_t full_width =
+        conf->screen_left + conf->screen_cols == conf->views.cols;
+
+    for (int32_t y = 0; y < conf->screen_rows; y++) {
+        int64_t line = hex->top + (int64_t)y * bpl;
+
+        char pos[32];
+        int32_t pos_len =
+            snprintf(pos, sizeof(pos), "\x1b[%d;%dH",
+                     conf->screen_top + y + 1, conf->screen_left + 1);
+        ab_append(ab, pos, pos_len);
+        if (!full_width) {
+            pos_len = snprintf(pos, sizeof(pos), "\x1b[%dX", conf->screen_cols);
+            ab_append(ab, pos, pos_len);
+        }
+
+        // only the lines on screen ever get formatted
+        if (line < hex->size && fits)
+            hexview_draw_line(conf, ab, line, bpl, digits);
+        else
+            ab_append(ab, "~", 1);
+
+        if (full_width) ab_append(ab, "\x1b[K", 3);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int8_t hexview_cursor_position(struct EditorConfig* conf, int32_t* row,
+                               int32_t* col) {
+    struct HexView* hex = &conf->hex;
+    int32_t digits;
+    int64_t bpl = hexview_layout(conf, &digits);
+
+    *row = (int32_t)((hex->cursor - hex->top) / bpl);
+    *col = digits + 2 + (int32_t)(hex->cursor % bpl) * 3 + hex->nibble;
+
+    return EXIT_SUCCESS;
+}
@@ -5,9 +5,11 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "arena.h"
 #include "config.h"
 #include "core.h"
 #include "file.h"
+#include "profile.h"
 #include "rows.h"
 
 #define HL_HIGHLIGHT_NUMBERS (1 << 0)
@@ -16,53 +18,67 @@
 #define HL_HIGHLIGHT_MCOMMENTS (1 << 3)
 
 // init of database
-char* C_HL_EXTENSIONS[] = {".c", ".h", ".cpp", NULL};
-char* C_HL_KEYWORDS[] = {
-    // Control flow
-    "if", "else", "switch", "case", "default", "for", "while", "do", "break",
-    "continue", "return", "goto",
-
-    // Data types (with | to highlight them as types)
-    "char|", "short|", "int|", "long|", "float|", "double|", "void|",
-    "_Bool|", "unsigned|", "signed|", "int32_t|", "ptrdiff_t|", "intptr_t|",
-    "uintptr_t|",
-
-    // Qualifiers & Storage class
-    "const", "volatile", "static", "extern", "register", "auto", "restrict",
-    "inline",
-
-    // Type definitions & Structuring
-    "struct", "union", "enum", "typedef", "sizeof|", "typeof|",
-
-    // Preprocessor
-    "#define|", "#undef|", "#include|", "#if|", "#ifdef|", "#ifndef|", "#else|",
-    "#elif|", "#endif|", "#pragma|",
-
-    // Boolean literals (C99+)
-    "true|", "false|",
-
-    // C++ compatibility (optional in case you handle C++)
-    "class", "public", "private", "protected", "namespace", "new", "delete",
-    "this", "operator", "try", "catch", "throw",
+/*
+ * keyword lists take the macro for plain keywords (HL_KEYWORD1) and the one
+ * for types and literals (HL_KEYWORD2). The generic tables below mark the
+ * latter with a trailing '|', the specialized ones get lengths and classes
+ */
+#define C_KEYWORDS(KW1, KW2)                                                 \
+    /* Control flow */                                                       \
+    KW1("if") KW1("else") KW1("switch") KW1("case") KW1("default")           \
+    KW1("for") KW1("while") KW1("do") KW1("break") KW1("continue")           \
+    KW1("return") KW1("goto")                                                \
+    /* Data types */                                                         \
+    KW2("char") KW2("short") KW2("int") KW2("long") KW2("float")             \
+    KW2("double") KW2("void") KW2("_Bool") KW2("unsigned") KW2("signed")     \
+    KW2("int32_t") KW2("ptrdiff_t") KW2("intptr_t") KW2("uintptr_t")         \
+    /* Qualifiers & Storage class */                                         \
+    KW1("const") KW1("volatile") KW1("static") KW1("extern")                 \
+    KW1("register") KW1("auto") KW1("restrict") KW1("inline")                \
+    /* Type definitions & Structuring */                                     \
+    KW1("struct") KW1("union") KW1("enum") KW1("typedef") KW2("sizeof")      \
+    KW2("typeof")                                                            \
+    /* Preprocessor */                                                       \
+    KW2("#define") KW2("#undef") KW2("#include") KW2("#if") KW2("#ifdef")    \
+    KW2("#ifndef") KW2("#else") KW2("#elif") KW2("#endif") KW2("#pragma")    \
+    /* Boolean literals (C99+) */                                            \
+    KW2("true") KW2("false")                                                 \
+    /* C++ compatibility */                                                  \
+    KW1("class") KW1("public") KW1("private") KW1("protected")               \
+    KW1("namespace") KW1("new") KW1("delete") KW1("this") KW1("operator")    \
+    KW1("try") KW1("catch") KW1("throw")
+
+#define PY_KEYWORDS(KW1, KW2)                                                \
+    KW1("def") KW1("return") KW1("if") KW1("elif") KW1("else") KW1("for")    \
+    KW1("while") KW1("break") KW1("continue") KW1("pass") KW1("import")      \
+    KW1("from") KW1("as") KW1("class") KW1("try") KW1("except")              \
+    KW1("finally") KW1("raise") KW1("with") KW1("lambda") KW1("global")      \
+    KW1("nonlocal") KW1("assert") KW1("yield") KW1("del") KW2("True")        \
+    KW2("False") KW2("None")
+
+#define JS_KEYWORDS(KW1, KW2)                                                \
+    KW1("function") KW1("return") KW1("if") KW1("else") KW1("for")           \
+    KW1("while") KW1("break") KW1("continue") KW1("var") KW1("let")          \
+    KW1("const") KW1("switch") KW1("case") KW1("default") KW1("try")         \
+    KW1("catch") KW1("finally") KW1("throw") KW1("class") KW1("extends")     \
+    KW1("import") KW1("from") KW1("export") KW1("new") KW1("this")           \
+    KW1("super") KW2("true") KW2("false") KW2("null") KW2("undefined")
+
+#define HL_WORD1(word) word,
+#define HL_WORD2(word) word "|",
 
-    NULL};
+char* C_HL_EXTENSIONS[] = {".c", ".h", ".cpp", NULL};
+char* C_HL_KEYWORDS[] = {C_KEYWORDS(HL_WORD1, HL_WORD2) NULL};
 
 char* PY_HL_EXTENSIONS[] = {".py", NULL};
-char* PY_HL_KEYWORDS[] = {"def",    "return",   "if",     "elif",     "else",
-                          "for",    "while",    "break",  "continue", "pass",
-                          "import", "from",     "as",     "class",    "try",
-                          "except", "finally",  "raise",  "with",     "lambda",
-                          "global", "nonlocal", "assert", "yield",    "del",
-                          "True|",  "False|",   "None|",  NULL};
+char* PY_HL_KEYWORDS[] = {PY_KEYWORDS(HL_WORD1, HL_WORD2) NULL};
 
 char* JS_HL_EXTENSIONS[] = {".js", ".jsx", NULL};
-char* JS_HL_KEYWORDS[] = {
-    "function", "return",   "if",     "else",   "for",     "while",
-    "break",    "continue", "var",    "let",    "const",   "switch",
-    "case",     "default",  "try",    "catch",  "finally", "throw",
-    "class",    "extends",  "import", "from",   "export",  "new",
-    "this",     "super",    "true|",  "false|", "null|",   "undefined|",
-    NULL};
+char* JS_HL_KEYWORDS[] = {JS_KEYWORDS(HL_WORD1, HL_WORD2) NULL};
+
+static int8_t highlight_c(struct Row* row, int8_t in_comment);
+static int8_t highlight_python(struct Row* row, int8_t in_comment);
+static int8_t highlight_js(struct Row* row, int8_t in_comment);
 
 // HLDB: highlight database
 
@@ -70,16 +86,16 @@ struct EditorSyntax HLDB[] = {
     {"C", C_HL_EXTENSIONS, C_HL_KEYWORDS, "//", "/*", "*/",
      HL_HIGHLIGHT_NUMBERS | HL_HIGHLIGHT_STRINGS | HL_HIGHLIGHT_COMMENTS |
          HL_HIGHLIGHT_MCOMMENTS,
-     '{', '}'},
+     '{', '}', highlight_c},
 
     {"Python", PY_HL_EXTENSIONS, PY_HL_KEYWORDS, "#", NULL, NULL,
      HL_HIGHLIGHT_NUMBERS | HL_HIGHLIGHT_STRINGS | HL_HIGHLIGHT_COMMENTS, ':',
-     '\0'},
+     '\0', highlight_python},
 
     {"JavaScript", JS_HL_EXTENSIONS, JS_HL_KEYWORDS, "//", "/*", "*/",
      HL_HIGHLIGHT_NUMBERS | HL_HIGHLIGHT_STRINGS | HL_HIGHLIGHT_COMMENTS |
          HL_HIGHLIGHT_MCOMMENTS,
-     '{', '}'}};
+     '{', '}', highlight_js}};
 
 #define HLDB_ENTRIES (sizeof(HLDB) / sizeof(HLDB[0]))
 
@@ -140,6 +156,21 @@ int8_t editor_syntax_highlight_select(struct EditorConfig* conf) {
     return EXIT_FAILURE;
 }
 
+// hl packs two classes per byte, low nibble first, see struct Row
+static void highlight_set(unsigned char* hl, int32_t i, uint8_t cls) {
+    int32_t shift = (i & 1) << 2;
+    hl[i >> 1] = (hl[i >> 1] & ~(0x0F << shift)) | (cls << shift);
+}
+
+static void highlight_fill(unsigned char* hl, int32_t from, int32_t len,
+                           uint8_t cls) {
+    int32_t to = from + len;
+    if ((from & 1) && from < to) highlight_set(hl, from++, cls);
+    if ((to & 1) && from < to) highlight_set(hl, --to, cls);
+    // whole bytes in between
+    memset(&hl[from >> 1], cls * 0x11, (to - from) >> 1);
+}
+
 /*
     ? in the upcoming static functions we return numbers because each of these
     ? returns return how much to step
@@ -148,9 +179,9 @@ int8_t editor_syntax_highlight_select(struct EditorConfig* conf) {
 static int32_t handle_multiline_comment(struct Row* row, int32_t i,
                                         const char* mce, int32_t mce_len,
                                         int8_t* in_comment) {
-    row->hl[i] = HL_MCOMMENT;
+    highlight_set(row->hl, i, HL_MCOMMENT);
     if (strncmp(&row->render[i], mce, mce_len) == 0) {
-        memset(&row->hl[i], HL_MCOMMENT, mce_len);
+        highlight_fill(row->hl, i, mce_len, HL_MCOMMENT);
         *in_comment = 0;
         return mce_len;
     }
@@ -159,9 +190,9 @@ static int32_t handle_multiline_comment(struct Row* row, int32_t i,
 
 static int32_t handle_string(struct Row* row, int32_t i, int8_t* in_string) {
     char c = row->render[i];
-    row->hl[i] = HL_STRING;
-    if (c == '\\' && i + 1 < row->size) {
-        row->hl[i + 1] = HL_STRING;
+    highlight_set(row->hl, i, HL_STRING);
+    if (c == '\\' && i + 1 < row->rsize) {
+        highlight_set(row->hl, i + 1, HL_STRING);
         return 2;
     }
     if (c == *in_string) *in_string = 0;
@@ -175,26 +206,22 @@ static int32_t handle_keywords(struct Row* row, int32_t i, char** keywords) {
         if (is_kw2) klen--;
         if ((strncmp(&row->render[i], keywords[j], klen) == 0) &&
             check_seperator(row->render[i + klen])) {
-            memset(&row->hl[i], is_kw2 ? HL_KEYWORD2 : HL_KEYWORD1, klen);
+            highlight_fill(row->hl, i, klen,
+                           is_kw2 ? HL_KEYWORD2 : HL_KEYWORD1);
             return klen;
         }
     }
     return 0;
 }
 
-int8_t editor_update_syntax(struct EditorConfig* conf, struct Row* row) {
-    if (!row->chars) return EXIT_FAILURE;
-
-    row->hl = realloc(row->hl, row->rsize);
-    memset(row->hl, HL_NORMAL, row->rsize);
+// any syntax, read from its EditorSyntax as it goes
+static int8_t highlight_generic(const struct EditorSyntax* syntax,
+                                struct Row* row, int8_t in_comment) {
+    char** keywords = syntax->keywords;
 
-    if (!conf->syntax) return EXIT_FAILURE;
-
-    char** keywords = conf->syntax->keywords;
-
-    char* scs = conf->syntax->singleline_comment_start;
-    char* mcs = conf->syntax->multiline_comment_start;
-    char* mce = conf->syntax->multiline_comment_end;
+    char* scs = syntax->singleline_comment_start;
+    char* mcs = syntax->multiline_comment_start;
+    char* mce = syntax->multiline_comment_end;
 
     int32_t scs_len = scs ? strlen(scs) : 0;
     int32_t mcs_len = mcs ? strlen(mcs) : 0;
@@ -202,20 +229,17 @@ int8_t editor_update_syntax(struct EditorConfig* conf, struct Row* row) {
 
     int32_t i = 0;
     int8_t prev_separator = 1;
-    int8_t in_comment =
-        (row->idx > 0 && conf->rows[row->idx - 1].hl_open_comment);
-
     int8_t in_string = 0;
 
     while (i < row->rsize) {
         char c = row->render[i];
-        unsigned char prev_hl = (i > 0) ? row->hl[i - 1] : HL_NORMAL;
+        uint8_t prev_hl = (i > 0) ? editor_row_hl(row, i - 1) : HL_NORMAL;
 
         // Singleline comment
         if (scs_len && !in_string && !in_comment) {
-            if (i + scs_len <= row->size &&
-                strncmp(&row->chars[i], scs, scs_len) == 0) {
-                memset(&row->hl[i], HL_COMMENT, row->size - i);
+            if (i + scs_len <= row->rsize &&
+                strncmp(&row->render[i], scs, scs_len) == 0) {
+                highlight_fill(row->hl, i, row->rsize - i, HL_COMMENT);
                 break;
             }
         }
@@ -235,23 +259,24 @@ int8_t editor_update_syntax(struct EditorConfig* conf, struct Row* row) {
         }
 
         // String
-        if (conf->syntax->flags & HL_HIGHLIGHT_STRINGS) {
+        if (syntax->flags & HL_HIGHLIGHT_STRINGS) {
             if (in_string) {
                 i += handle_string(row, i, &in_string);
                 prev_separator = 1;
                 continue;
             } else if (c == '"' || c == '\'' || c == '\"') {
                 in_string = c;
-                row->hl[i++] = HL_STRING;
+                highlight_set(row->hl, i++, HL_STRING);
                 continue;
             }
         }
 
         // Number
-        if (conf->syntax->flags & HL_HIGHLIGHT_NUMBERS) {
-            if ((isdigit(c) && (prev_separator || prev_hl == HL_NUMBER)) ||
+        if (syntax->flags & HL_HIGHLIGHT_NUMBERS) {
+            if ((isdigit((unsigned char)c) &&
+                 (prev_separator || prev_hl == HL_NUMBER)) ||
                 (c == '.' && prev_hl == HL_NUMBER)) {
-                row->hl[i] = HL_NUMBER;
+                highlight_set(row->hl, i, HL_NUMBER);
                 prev_separator = 0;
             }
         }
@@ -269,10 +294,267 @@ int8_t editor_update_syntax(struct EditorConfig* conf, struct Row* row) {
         i++;
     }
 
-    int32_t changed = (row->hl_open_comment != in_comment);
+    return in_comment;
+}
+
+/*
+ * Built-in languages get their own copy of the loop: highlight_lang is
+ * inlined with a constant HighlightLang, so flags and delimiters fold away
+ * and keywords are matched by length against a table instead of strlen and
+ * strncmp on every one of them
+ */
+struct HighlightKeyword {
+    const char* word;
+    int8_t len;
+    uint8_t cls;
+};
+
+struct HighlightLang {
+    int8_t flags;
+    const char* scs;
+    int8_t scs_len;
+    const char* mcs;
+    int8_t mcs_len;
+    const char* mce;
+    int8_t mce_len;
+    const struct HighlightKeyword* keywords;
+    int32_t nkeywords;
+};
+
+#define HL_KEYWORD_ENTRY1(word) {word, sizeof(word) - 1, HL_KEYWORD1},
+#define HL_KEYWORD_ENTRY2(word) {word, sizeof(word) - 1, HL_KEYWORD2},
+
+static const struct HighlightKeyword highlight_c_keywords[] = {
+    C_KEYWORDS(HL_KEYWORD_ENTRY1, HL_KEYWORD_ENTRY2)};
+static const struct HighlightKeyword highlight_py_keywords[] = {
+    PY_KEYWORDS(HL_KEYWORD_ENTRY1, HL_KEYWORD_ENTRY2)};
+static const struct HighlightKeyword highlight_js_keywords[] = {
+    JS_KEYWORDS(HL_KEYWORD_ENTRY1, HL_KEYWORD_ENTRY2)};
+
+#define HL_KEYWORDS(table) table, sizeof(table) / sizeof(table[0])
+
+static const struct HighlightLang highlight_c_lang = {
+    HL_HIGHLIGHT_NUMBERS | HL_HIGHLIGHT_STRINGS | HL_HIGHLIGHT_COMMENTS |
+        HL_HIGHLIGHT_MCOMMENTS,
+    "//", 2, "/*", 2, "*/", 2, HL_KEYWORDS(highlight_c_keywords)};
+static const struct HighlightLang highlight_py_lang = {
+    HL_HIGHLIGHT_NUMBERS | HL_HIGHLIGHT_STRINGS | HL_HIGHLIGHT_COMMENTS,
+    "#", 1, NULL, 0, NULL, 0, HL_KEYWORDS(highlight_py_keywords)};
+static const struct HighlightLang highlight_js_lang = {
+    HL_HIGHLIGHT_NUMBERS | HL_HIGHLIGHT_STRINGS | HL_HIGHLIGHT_COMMENTS |
+        HL_HIGHLIGHT_MCOMMENTS,
+    "//", 2, "/*", 2, "*/", 2, HL_KEYWORDS(highlight_js_keywords)};
+
+// check_seperator as a table: whitespace, NUL and ",.()+-/*=~%<>[];"
+static const uint8_t highlight_separators[256] = {
+    ['\0'] = 1, [' '] = 1, ['\t'] = 1, ['\n'] = 1, ['\v'] = 1, ['\f'] = 1,
+    ['\r'] = 1, [','] = 1, ['.'] = 1,  ['('] = 1,  [')'] = 1,  ['+'] = 1,
+    ['-'] = 1,  ['/'] = 1, ['*'] = 1,  ['='] = 1,  ['~'] = 1,  ['%'] = 1,
+    ['<'] = 1,  ['>'] = 1, ['['] = 1,  [']'] = 1,  [';'] = 1};
+
+static inline int8_t highlight_is_word(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '_';
+}
+
+// same classes as highlight_generic, which stays the reference for it
+static inline __attribute__((always_inline)) int8_t highlight_lang(
+    const struct HighlightLang* lang, struct Row* row, int8_t in_comment) {
+    const char* render = row->render;
+    unsigned char* hl = row->hl;
+    int32_t rsize = row->rsize;
+
+    int32_t i = 0;
+    int8_t prev_separator = 1;
+    int8_t after_number = 0;  // render[i - 1] is HL_NUMBER
+    char in_string = 0;
+
+    while (i < rsize) {
+        char c = render[i];
+
+        if (lang->mcs_len && in_comment) {
+            if (i + lang->mce_len <= rsize &&
+                memcmp(&render[i], lang->mce, lang->mce_len) == 0) {
+                highlight_fill(hl, i, lang->mce_len, HL_MCOMMENT);
+                i += lang->mce_len;
+                in_comment = 0;
+            } else {
+                highlight_set(hl, i++, HL_MCOMMENT);
+            }
+            prev_separator = 1;
+            after_number = 0;
+            continue;
+        }
+
+        if (in_string) {
+            highlight_set(hl, i, HL_STRING);
+            if (c == '\\' && i + 1 < rsize) {
+                highlight_set(hl, i + 1, HL_STRING);
+                i += 2;
+            } else {
+                if (c == in_string) in_string = 0;
+                i++;
+            }
+            prev_separator = 1;
+            after_number = 0;
+            continue;
+        }
+
+        if (lang->scs_len && !in_comment && i + lang->scs_len <= rsize &&
+            memcmp(&render[i], lang->scs, lang->scs_len) == 0) {
+            highlight_fill(hl, i, rsize - i, HL_COMMENT);
+            break;
+        }
+
+        if (lang->mcs_len && i + lang->mcs_len <= rsize &&
+            memcmp(&render[i], lang->mcs, lang->mcs_len) == 0) {
+            i += lang->mcs_len;
+            in_comment = 1;
+            after_number = 0;
+            continue;
+        }
+
+        if ((lang->flags & HL_HIGHLIGHT_STRINGS) && (c == '"' || c == '\'')) {
+            in_string = c;
+            highlight_set(hl, i++, HL_STRING);
+            after_number = 0;
+            continue;
+        }
+
+        int8_t number = 0;
+        if ((lang->flags & HL_HIGHLIGHT_NUMBERS) &&
+            ((c >= '0' && c <= '9' && (prev_separator || after_number)) ||
+             (c == '.' && after_number))) {
+            highlight_set(hl, i, HL_NUMBER);
+            number = 1;
+            prev_separator = 0;
+        }
+
+        if (prev_separator) {
+            // keywords are whole words, only those of its length can match
+            int32_t len = 0;
+            while (i + len < rsize &&
+                   !highlight_separators[(unsigned char)render[i + len]])
+                len++;
+
+            int32_t k = 0;
+            for (; k < lang->nkeywords; k++) {
+                const struct HighlightKeyword* kw = &lang->keywords[k];
+                if (kw->len == len && kw->word[0] == c &&
+                    memcmp(kw->word, &render[i], len) == 0)
+                    break;
+            }
+            if (k < lang->nkeywords) {
+                highlight_fill(hl, i, len, lang->keywords[k].cls);
+                i += len;
+                after_number = 0;
+                continue;
+            }
+
+            // the rest of an identifier can't start anything, skip it
+            if (highlight_is_word(c) && !(c >= '0' && c <= '9')) {
+                i++;
+                while (i < rsize && highlight_is_word(render[i])) i++;
+                prev_separator = 0;
+                after_number = 0;
+                continue;
+            }
+        }
+
+        prev_separator = highlight_separators[(unsigned char)c];
+        after_number = number;
+        i++;
+    }
+
+    return in_comment;
+}
+
+static int8_t highlight_c(struct Row* row, int8_t in_comment) {
+    return highlight_lang(&highlight_c_lang, row, in_comment);
+}
+
+static int8_t highlight_python(struct Row* row, int8_t in_comment) {
+    return highlight_lang(&highlight_py_lang, row, in_comment);
+}
+
+static int8_t highlight_js(struct Row* row, int8_t in_comment) {
+    return highlight_lang(&highlight_js_lang, row, in_comment);
+}
+
+// highlights a single row, returns 1 if its open comment state changed
+static int8_t highlight_row(struct EditorConfig* conf, struct Row* row) {
+    if (!row->chars) return 0;
+
+    // without a syntax every row stays HL_NORMAL, which needs no buffer
+    if (!conf->syntax) {
+        arena_free(conf->arena, row->hl);
+        row->hl = NULL;
+        return 0;
+    }
+
+    int32_t hl_size = (row->rsize >> 1) + 1;
+    row->hl = arena_realloc(conf->arena, row->hl, hl_size);
+    memset(row->hl, 0, hl_size);
+
+    int8_t in_comment = (row > conf->rows && row[-1].hl_open_comment);
+    if (conf->syntax->highlight)
+        in_comment = conf->syntax->highlight(row, in_comment);
+    else
+        in_comment = highlight_generic(conf->syntax, row, in_comment);
+
+    // plain rows drop their buffer again, most rows of prose and data
+    int32_t b = 0;
+    while (b < hl_size && !row->hl[b]) b++;
+    if (b == hl_size) {
+        arena_free(conf->arena, row->hl);
+        row->hl = NULL;
+    }
+
+    int8_t changed = (row->hl_open_comment != in_comment);
     row->hl_open_comment = in_comment;
-    if (changed && row->idx + 1 < conf->numrows) {
-        editor_update_syntax(conf, row + 1);
+    return changed;
+}
+
+int8_t editor_highlight_paint(struct EditorConfig* conf, struct Row* row,
+                              int32_t from, int32_t len,
+                              enum EditorHighlight hl) {
+    if (from < 0 || len < 0 || from + len > row->rsize) return EXIT_FAILURE;
+
+    if (!row->hl) {
+        row->hl = arena_alloc(conf->arena, (row->rsize >> 1) + 1);
+        memset(row->hl, 0, (row->rsize >> 1) + 1);
     }
+    highlight_fill(row->hl, from, len, hl);
+    return EXIT_SUCCESS;
+}
+
+int8_t editor_update_syntax(struct EditorConfig* conf, struct Row* row) {
+    if (!row->chars) return EXIT_FAILURE;
+
+    PROFILE_BEGIN(PROFILE_HIGHLIGHT);
+    // keep going down only while the open comment state keeps changing
+    struct Row* last = &conf->rows[conf->numrows - 1];
+    while (highlight_row(conf, row) && row < last) row++;
+    PROFILE_END(PROFILE_HIGHLIGHT);
+
+    return EXIT_SUCCESS;
+}
+
+int8_t editor_update_syntax_range(struct EditorConfig* conf, int32_t from,
+                                  int32_t to) {
+    if (from < 0 || to > conf->numrows || from >= to) return EXIT_FAILURE;
+
+    PROFILE_BEGIN(PROFILE_HIGHLIGHT);
+    int8_t changed = 0;
+    for (int32_t i = from; i < to; i++) {
+        changed = highlight_row(conf, &conf->rows[i]);
+    }
+    PROFILE_END(PROFILE_HIGHLIGHT);
+
+    // rows after the block only need work if the last one leaked a comment
+    if (changed && to < conf->numrows) {
+        editor_update_syntax(conf, &conf->rows[to]);
+    }
+
     return EXIT_SUCCESS;
 }
@@ -1,81 +1,65 @@
 #include "input.h"
 
 #include <errno.h>
+#include <poll.h>
+#include <signal.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
+#include "alloc.h"
 #include "config.h"
+#include "block.h"
+#include "buflist.h"
 #include "core.h"
+#include "cursors.h"
 #include "file.h"
+#include "filewatch.h"
+#include "folds.h"
+#include "hexview.h"
+#include "gutter.h"
+#include "loop.h"
+#include "profile.h"
 #include "render.h"
+#include "replay.h"
 #include "rows.h"
 #include "terminal.h"
+#include "utf8.h"
+#include "views.h"
+#include "wrap.h"
 
-static void skip_word_forward(struct EditorConfig *conf, struct Row *row,
-                              int32_t numline_offset) {
-    int32_t cursor_offset = conf->cx - numline_offset;
-    while (conf->cx < row->size + numline_offset &&
-           !ISCHAR(row->chars[cursor_offset]) &&
-           (row->chars[cursor_offset] != '_'))
-        conf->cx++;
-    while (conf->cx < row->size + numline_offset &&
-           (ISCHAR(row->chars[cursor_offset]) ||
-            (row->chars[cursor_offset] == '_')))
-        conf->cx++;
-}
-
-static void skip_word_backward(struct EditorConfig *conf, struct Row *row,
-                               int32_t numline_offset) {
-    if (conf->cx == numline_offset) return;
-
-    if (!conf->cx) conf->cx--;
+#define ISWORD(c) (ISCHAR(c) || (c) == '_')
 
-    int32_t cursor_offset = conf->cx - numline_offset;
-
-    while (conf->cx > numline_offset && !ISCHAR(row->chars[cursor_offset]) &&
-           (row->chars[cursor_offset] != '_'))
-        if (!conf->cx) conf->cx--;
-
-    while (conf->cx > numline_offset && (ISCHAR(row->chars[cursor_offset]) ||
-                                         (row->chars[cursor_offset] == '_')))
-        if (!conf->cx) conf->cx--;
+static void skip_word_forward(struct EditorConfig *conf, struct Row *row) {
+    while (conf->cx < row->size && !ISWORD(row->chars[conf->cx])) conf->cx++;
+    while (conf->cx < row->size && ISWORD(row->chars[conf->cx])) conf->cx++;
+}
 
-    if (!ISCHAR(row->chars[cursor_offset]) &&
-        (row->chars[cursor_offset] != '_')) {
-        conf->cx++;
-    }
+static void skip_word_backward(struct EditorConfig *conf, struct Row *row) {
+    while (conf->cx > 0 && !ISWORD(row->chars[conf->cx - 1])) conf->cx--;
+    while (conf->cx > 0 && ISWORD(row->chars[conf->cx - 1])) conf->cx--;
 }
 
 int8_t editor_cursor_ctrl(struct EditorConfig *conf, int32_t key) {
     if (conf->cy < 0 || conf->cy >= conf->numrows) return EXIT_FAILURE;
     struct Row *row = &conf->rows[conf->cy];
-    int32_t numline_offset = editor_row_numline_calculate(row);
 
     if (key == CTRL_ARROW_RIGHT) {
-        if (conf->cx == row->size + numline_offset) {
-            conf->cy++;
-            if (conf->cy >= conf->numrows - 1) {
-                conf->cy--;
-                return EXIT_FAILURE;
-            }
-            row = &conf->rows[conf->cy];
-            conf->cx = numline_offset;
+        if (conf->cx == row->size) {
+            if (conf->cy + 1 >= conf->numrows) return EXIT_FAILURE;
+            row = &conf->rows[++conf->cy];
+            conf->cx = 0;
         }
-        skip_word_forward(conf, row, numline_offset);
+        skip_word_forward(conf, row);
     } else {
-        if (conf->cx == numline_offset) {
-            conf->cy--;
-            if (conf->cy < 0) {
-                conf->cy = 0;
-                return EXIT_FAILURE;
-            }
-            row = &conf->rows[conf->cy];
-            conf->cx = row->size != 0 ? row->size - 1 : numline_offset;
+        if (conf->cx == 0) {
+            if (conf->cy == 0) return EXIT_FAILURE;
+            row = &conf->rows[--conf->cy];
+            conf->cx = row->size;
         }
-        skip_word_backward(conf, row, numline_offset);
+        skip_word_backward(conf, row);
     }
     return EXIT_SUCCESS;
 }
@@ -84,91 +68,82 @@ int8_t editor_cursor_move(struct EditorConfig *conf, int32_t key) {
     struct Row *row =
         (conf->cy >= conf->numrows) ? NULL : &conf->rows[conf->cy];
 
-    int32_t numline_offset = 0;
-    if (row) {
-        numline_offset = editor_row_numline_calculate(row);
-    }
-
-    int32_t desired_cx_logical = conf->cx - numline_offset;
+    // cx is a plain index into row->chars, the gutter is not part of it.
+    // Up and down keep the screen column so cx lands on a glyph start
+    int32_t desired_rx = editor_update_cx_rx(row, conf->cx);
 
     switch (key) {
         case ARROW_LEFT:
-            if (conf->cx != numline_offset) {
-                if (conf->coloff != 0 &&
-                    conf->cx == numline_offset + conf->coloff) {
-                    conf->coloff--;
-                }
-                if (!conf->cx) conf->cx--;
-
+            if (conf->cx > 0) {
+                conf->cx = editor_row_prev_cx(row, conf->cx);
             } else if (conf->cy > 0) {
-                conf->cy--;
-                row =
-                    (conf->cy >= conf->numrows) ? NULL : &conf->rows[conf->cy];
-                numline_offset = editor_row_numline_calculate(row);
-                conf->cx = row->size + numline_offset;
+                conf->cy = folds_next(conf, conf->cy, -1);
+                conf->cx = conf->rows[conf->cy].size;
             }
             break;
         case ARROW_RIGHT:
-            if (row && conf->cx < row->size + numline_offset) {
-                conf->cx++;
-            } else if (row && conf->cy < conf->numrows - 1) {
-                row = &conf->rows[++conf->cy];
-                numline_offset =
-                    editor_row_numline_calculate(row);  // recalculate it
-                conf->cx = numline_offset;
+            if (row && conf->cx < row->size) {
+                conf->cx = editor_row_next_cx(row, conf->cx);
+            } else if (row && folds_next(conf, conf->cy, 1) < conf->numrows) {
+                conf->cy = folds_next(conf, conf->cy, 1);
+                conf->cx = 0;
             }
             break;
         case ARROW_UP:
-            if (conf->cy > 0) {
-                conf->cy--;
-                row = &conf->rows[conf->cy];
-                numline_offset = editor_row_numline_calculate(row);
-                if (desired_cx_logical > row->size)
-                    desired_cx_logical = row->size;
-                conf->cx = numline_offset + desired_cx_logical;
+            // wrapped rows are walked one visual line at a time
+            if (conf->flags.soft_wrap) {
+                wrap_move(conf, -1);
+            } else if (conf->cy > 0) {
+                conf->cy = folds_next(conf, conf->cy, -1);
+                conf->cx =
+                    editor_update_rx_cx(&conf->rows[conf->cy], desired_rx);
             }
             break;
         case ARROW_DOWN:
-            if (conf->cy < conf->numrows - 1) {
-                conf->cy++;
-                row = &conf->rows[conf->cy];
-                numline_offset = editor_row_numline_calculate(row);
-                if (desired_cx_logical > row->size)
-                    desired_cx_logical = row->size;
-                conf->cx = numline_offset + desired_cx_logical;
+            // folded rows are jumped over in one step
+            if (conf->flags.soft_wrap) {
+                wrap_move(conf, 1);
+            } else if (folds_next(conf, conf->cy, 1) < conf->numrows) {
+                conf->cy = folds_next(conf, conf->cy, 1);
+                conf->cx =
+                    editor_update_rx_cx(&conf->rows[conf->cy], desired_rx);
             }
             break;
+        case HOME_KEY:
+            conf->cx = 0;
+            break;
+        case END_KEY:
+            if (row) conf->cx = row->size;
+            break;
         default:
             die("invalid input...");
     }
     row = (conf->cy >= conf->numrows) ? NULL : &conf->rows[conf->cy];
-    if (row && conf->cx > row->size + numline_offset) {
+    if (row && conf->cx > row->size) {
         conf->cx = row->size;
     }
 
-    conf->rx =
-        editor_update_cx_rx(row, conf->cx - numline_offset) + numline_offset;
+    conf->rx = editor_update_cx_rx(row, conf->cx);
 
     return EXIT_SUCCESS;
 }
 
 int8_t editor_shift_select(struct EditorConfig *conf, int32_t key) {
     struct Row *row = &conf->rows[conf->cy];
-    int32_t numline_offset = editor_row_numline_calculate(row);
     struct EditorCursorSelect *sel = &conf->sel;
 
-    // basically taking into account numline offset
-    const int32_t real_rx = conf->rx - numline_offset;
+    // selection columns are render columns, like conf->rx
+    const int32_t real_rx = conf->rx;
 
     if (sel->start_col == -1 || sel->end_col == -1 || sel->start_row == -1 ||
         sel->end_row == -1) {
-        conf_select_update(conf, conf->cy, conf->cy, conf->cx, conf->cx);
+        conf_select_update(conf, conf->cy, conf->cy, conf->rx, conf->rx);
     }
 
     switch (key) {
         case SHIFT_ARROW_LEFT:
             // at beginning of first line
-            if (conf->cy <= 0 && conf->rx == numline_offset) break;
+            if (conf->cy <= 0 && conf->rx == 0) break;
             editor_cursor_move(conf, ARROW_LEFT);
 
             if (!sel->active || conf_check_cursor_anchor(conf, sel->start_row,
@@ -202,7 +177,7 @@ int8_t editor_shift_select(struct EditorConfig *conf, int32_t key) {
 
         case SHIFT_ARROW_RIGHT:
             // at end of last line
-            if (conf->cy >= conf->numrows - 1 && real_rx == row->rsize) break;
+            if (conf->cy >= conf->numrows - 1 && real_rx == row->rwidth) break;
             editor_cursor_move(conf, ARROW_RIGHT);
 
             // if we are not selecting and didn't already move the cursor
@@ -242,103 +217,306 @@ int8_t editor_shift_select(struct EditorConfig *conf, int32_t key) {
     return EXIT_SUCCESS;
 }
 
-int32_t editor_read_key(struct EditorConfig *conf) {
-    int32_t c;
-    int32_t nread;
-    while ((nread = read(STDIN_FILENO, &c, 1)) != 1) {
-        if (conf->flags.resize_needed) return INTERRUPT_ENCOUNTERED;
+/***  Buffered input section ***/
+
+/*
+    Bytes are read from stdin in chunks into this buffer and keys are decoded
+    from it, so a burst of typed ahead or pasted input costs one syscall
+    instead of one per byte.
+*/
+static struct InputBuffer {
+    unsigned char buf[INPUT_BUF_SIZE];
+    int32_t start;
+    int32_t len;
+    int8_t hangup;  // stdin is closed, nothing more will ever arrive
+} input = {{0}, 0, 0, 0};
 
-        if (nread == -1 && errno != EAGAIN && errno != EINTR) {
-            die("editor failed to read key to input");
+/*
+    returns bytes read, 0 on timeout or hangup or -1 if interrupted by a
+    signal
+*/
+static int32_t input_fill(int32_t timeout_ms) {
+    if (input.start + input.len == INPUT_BUF_SIZE) {
+        memmove(input.buf, &input.buf[input.start], input.len);
+        input.start = 0;
+    }
+    if (input.len == INPUT_BUF_SIZE) return 0;
+
+    int32_t offset = input.start + input.len;
+    if (replay_active()) {
+        int32_t nread = replay_read(&input.buf[offset],
+                                    INPUT_BUF_SIZE - offset, timeout_ms);
+        // the end of the recording is where its terminal went away
+        if (nread == -1) {
+            input.hangup = 1;
+            return 0;
         }
+        input.len += nread;
+        return nread;
     }
 
-    if (c == '\x1b') {
-        char seq[32];
-
-        if (read(STDIN_FILENO, &seq[0], 1) != 1) return '\x1b';
-        if (read(STDIN_FILENO, &seq[1], 1) != 1) return '\x1b';
-        if (seq[0] == '[') {
-            if ('0' <= seq[1] && seq[1] <= '9') {
-                if (read(STDIN_FILENO, &seq[2], 1) != 1) return '\x1b';
-                if (seq[2] == '~') {
-                    switch (seq[1]) {
-                        case '1':
-                        case '7':
-                            return HOME_KEY;
-                        case '3':
-                            return DEL_KEY;
-                        case '4':
-                        case '8':
-                            return END_KEY;
-                        case '5':
-                            return PAGE_UP;
-                        case '6':
-                            return PAGE_DOWN;
-                    }
-                } else if (seq[2] == ';') {
-                    if (read(STDIN_FILENO, &seq[3], 1) != 1) return '\x1b';
-                    if (read(STDIN_FILENO, &seq[4], 1) != 1) return '\x1b';
-                    if (seq[1] == '1' && seq[3] == '5') {
-                        switch (seq[4]) {
-                            case 'A':
-                                return CTRL_ARROW_UP;
-                                break;
-                            case 'B':
-                                return CTRL_ARROW_DOWN;
-                                break;
-                            case 'C':
-                                return CTRL_ARROW_RIGHT;
-                                break;
-                            case 'D':
-                                return CTRL_ARROW_LEFT;
-                                break;
-                        }
-                    } else if (seq[1] == '1' && seq[3] == '2') {
-                        switch (seq[4]) {
-                            case 'A':
-                                return SHIFT_ARROW_UP;
-                            case 'B':
-                                return SHIFT_ARROW_DOWN;
-                            case 'C':
-                                return SHIFT_ARROW_RIGHT;
-                            case 'D':
-                                return SHIFT_ARROW_LEFT;
-                        }
-                    }
-                }
-            }
-            switch (seq[1]) {
-                case 'A':
-                    return ARROW_UP;
-                case 'B':
-                    return ARROW_DOWN;
-                case 'C':
-                    return ARROW_RIGHT;
-                case 'D':
-                    return ARROW_LEFT;
-                case 'H':
-                    return HOME_KEY;
-                case 'F':
-                    return END_KEY;
+    struct pollfd pfd = {STDIN_FILENO, POLLIN, 0};
+    int32_t ready = poll(&pfd, 1, timeout_ms);
+    if (ready == -1) {
+        if (errno == EINTR) return -1;
+        die("poll on stdin failed");
+    }
+    if (ready == 0) return 0;
+
+    // a closed terminal polls as POLLHUP and reads as EOF or EIO
+    if (!(pfd.revents & POLLIN)) {
+        input.hangup = 1;
+        return 0;
+    }
+
+    int32_t nread = read(STDIN_FILENO, &input.buf[offset],
+                         INPUT_BUF_SIZE - offset);
+    if (nread == -1) {
+        if (errno == EAGAIN || errno == EINTR) return -1;
+        if (errno != EIO) die("editor failed to read key to input");
+        nread = 0;
+    }
+    if (nread == 0) {
+        input.hangup = 1;
+        return 0;
+    }
+
+    replay_record(&input.buf[offset], nread);
+    input.len += nread;
+    return nread;
+}
+
+/*
+    returns the byte at offset i of the pending input, waiting a little for
+    the rest of an escape sequence, or -1 if it never arrived
+*/
+static int32_t input_peek(int32_t i) {
+    while (i >= input.len) {
+        if (input_fill(ESC_SEQ_TIMEOUT_MS) == 0) return -1;
+    }
+    return input.buf[input.start + i];
+}
+
+static void input_consume(int32_t n) {
+    input.start += n;
+    input.len -= n;
+    if (input.len == 0) input.start = 0;
+}
+
+// maps the parameters and final byte of a CSI sequence to a key
+static int32_t decode_csi(int32_t param1, int32_t param2, int32_t final) {
+    if (final == '~') {
+        switch (param1) {
+            case 1:
+            case 7:
+                return HOME_KEY;
+            case 3:
+                return DEL_KEY;
+            case 4:
+            case 8:
+                return END_KEY;
+            case 5:
+                return PAGE_UP;
+            case 6:
+                return PAGE_DOWN;
+            case 11:
+            case 12:
+            case 13:
+            case 14:
+                return F1 + param1 - 11;
+            case 15:
+                return F5;
+            case 17:
+            case 18:
+            case 19:
+            case 20:
+            case 21:
+                return F6 + param1 - 17;
+            case 23:
+            case 24:
+                return F11 + param1 - 23;
+            case 200:
+                return PASTE_START;
+        }
+        return '\x1b';
+    }
+
+    int32_t arrow = -1;
+    switch (final) {
+        case 'A':
+            arrow = 0;
+            break;
+        case 'B':
+            arrow = 1;
+            break;
+        case 'C':
+            arrow = 2;
+            break;
+        case 'D':
+            arrow = 3;
+            break;
+        case 'H':
+            return HOME_KEY;
+        case 'F':
+            return END_KEY;
+        default:
+            return '\x1b';
+    }
+
+    // modifiers: <esc>[1;2X shift, 3 alt, 4 alt+shift and 5 ctrl
+    if (param2 == 2) return SHIFT_ARROW_UP + arrow;
+    if (param2 == 3) return ALT_ARROW_UP + arrow;
+    if (param2 == 4) return ALT_SHIFT_ARROW_UP + arrow;
+    if (param2 == 5) return CTRL_ARROW_UP + arrow;
+    return ARROW_UP + arrow;
+}
+
+int32_t editor_read_glyph(struct EditorConfig *conf, int32_t c, char *glyph) {
+    (void)conf;
+    int32_t len = 0;
+    glyph[len++] = c;
+    if (c < 0xC0 || c >= 0x100) return len;
+
+    int32_t b;
+    while (len < UTF8_MAX_BYTES && (b = input_peek(0)) != -1 &&
+           utf8_is_continuation(b)) {
+        glyph[len++] = b;
+        input_consume(1);
+    }
+    return len;
+}
+
+int32_t editor_read_key(struct EditorConfig *conf) {
+    while (input.len == 0) {
+        if (conf->flags.resize_needed) return INTERRUPT_ENCOUNTERED;
+        if (input.hangup) {
+            // leaves the way SIGHUP does, unsaved changes stay in the journal
+            if (conf->loop) {
+                conf->loop->exit_signal = SIGHUP;
+                conf->loop->running = 0;
             }
-        } else if (seq[0] == 'O') {
-            switch (seq[1]) {
-                case 'H':
-                    return HOME_KEY;
-                    break;
-                case 'F':
-                    return END_KEY;
-                    break;
+            return HANGUP;
+        }
+        input_fill(-1);
+    }
+
+    int32_t c = input.buf[input.start];
+    if (c != '\x1b') {
+        input_consume(1);
+        return c;
+    }
+
+    int32_t seq0 = input_peek(1);
+    if (seq0 == '[') {
+        int32_t params[2] = {0, 0};
+        int32_t nparams = 0;
+        int32_t i = 2;
+        int32_t b;
+
+        // <esc>[<param>;<param><final>
+        while ((b = input_peek(i)) != -1) {
+            if ('0' <= b && b <= '9') {
+                // saturates, no key takes a parameter anywhere near the cap
+                if (nparams < 2)
+                    params[nparams] = min(params[nparams] * 10 + (b - '0'),
+                                          CSI_PARAM_MAX);
+            } else if (b == ';') {
+                nparams++;
+            } else {
+                break;
             }
-        } else {
+            i++;
+        }
+
+        if (b == -1) {
+            input_consume(1);
             return '\x1b';
         }
-    } else {
-        return c;
+
+        input_consume(i + 1);
+        return decode_csi(params[0], params[1], b);
+    } else if (seq0 == 'O') {
+        int32_t seq1 = input_peek(2);
+        if (seq1 == -1) {
+            input_consume(1);
+            return '\x1b';
+        }
+
+        input_consume(3);
+        switch (seq1) {
+            case 'H':
+                return HOME_KEY;
+            case 'F':
+                return END_KEY;
+            case 'P':
+            case 'Q':
+            case 'R':
+            case 'S':
+                return F1 + seq1 - 'P';
+        }
+        return '\x1b';
     }
 
-    return EXIT_FAILURE;
+    input_consume(1);
+    return '\x1b';
+}
+
+int8_t editor_key_pending(struct EditorConfig *conf) {
+    if (conf->flags.resize_needed) return 0;
+    if (input.len == 0 && !input.hangup) input_fill(0);
+    return input.len > 0 || input.hangup;
+}
+
+int8_t editor_read_paste(struct EditorConfig *conf, char **text,
+                         int32_t *len) {
+    (void)conf;
+    static const char paste_end[] = "\x1b[201~";
+    const int32_t paste_end_len = sizeof(paste_end) - 1;
+
+    int32_t cap = INPUT_BUF_SIZE;
+    int32_t buflen = 0;
+    char *buf = malloc(cap);
+    if (!buf) die("paste buf malloc failed");
+
+    while (1) {
+        while (input.len == 0 && !input.hangup) input_fill(-1);
+        // cut off by a hangup, whatever arrived is still pasted
+        if (input.len == 0) break;
+
+        if (buflen + input.len > cap) {
+            while (buflen + input.len > cap) cap *= 2;
+            buf = realloc(buf, cap);
+            if (!buf) die("paste buf realloc failed");
+        }
+
+        // drain everything buffered, the terminator may straddle two reads
+        int32_t scan_from = buflen > paste_end_len ? buflen - paste_end_len : 0;
+        memcpy(&buf[buflen], &input.buf[input.start], input.len);
+        buflen += input.len;
+
+        int32_t paste_len = -1;
+        for (int32_t i = scan_from; i + paste_end_len <= buflen; i++) {
+            if (buf[i] == '\x1b' &&
+                memcmp(&buf[i], paste_end, paste_end_len) == 0) {
+                paste_len = i;
+                break;
+            }
+        }
+
+        if (paste_len != -1) {
+            // whatever came after the terminator goes back to the reader
+            int32_t leftover = buflen - paste_len - paste_end_len;
+            input_consume(input.len - leftover);
+            buflen = paste_len;
+            break;
+        }
+        input_consume(input.len);
+    }
+
+    *text = buf;
+    *len = buflen;
+
+    return EXIT_SUCCESS;
 }
 
 /*
@@ -350,41 +528,98 @@ int8_t editor_process_key_press(struct EditorConfig *conf) {
     static int8_t quit_times = QUIT_TIMES;
 
     struct Snapshot *s = NULL;
-    struct Row *row =
-        (conf->cy >= conf->numrows) ? NULL : &conf->rows[conf->cy];
+    PROFILE_BEGIN(PROFILE_INPUT);
     int32_t c = editor_read_key(conf);
+    PROFILE_END(PROFILE_INPUT);
 
     // times var will be needed to page up or down
     int8_t times = conf->screen_rows;
 
     time_t current_time = time(NULL);
     int64_t time_elapsed = difftime(current_time, conf->last_time_modified);
-    conf->sel.active = 0;
+    // binary buffers have no rows, the hex view takes every edit and move
+    if (conf->hex.active && hexview_process_key(conf, c) == EXIT_SUCCESS) {
+        quit_times = QUIT_TIMES;
+        return EXIT_SUCCESS;
+    }
+
+    // copying has to see the selection made by the previous keys
+    if (c != CTRL_KEY('c')) conf->sel.active = 0;
+
+    if (conf->block.active && c != CTRL_KEY('c') &&
+        (c < ALT_SHIFT_ARROW_UP || c > ALT_SHIFT_ARROW_LEFT)) {
+        int8_t res = editor_block_process_key(conf, c);
+        editor_block_clear(conf);
+        if (res == EXIT_SUCCESS) {
+            quit_times = QUIT_TIMES;
+            return EXIT_SUCCESS;
+        }
+    }
+
+    // with extra cursors, edits and moves are applied to all of them at once
+    if (conf->cursors.count) {
+        if (editor_cursors_process_key(conf, c) == EXIT_SUCCESS) {
+            quit_times = QUIT_TIMES;
+            return EXIT_SUCCESS;
+        }
+        if (c != ALT_ARROW_UP && c != ALT_ARROW_DOWN &&
+            c != INTERRUPT_ENCOUNTERED && c != HANGUP)
+            cursors_clear(conf);
+    }
 
     switch (c) {
-        case F1:
         case F2:
+            gutter_toggle(conf, GUTTER_RELATIVE);
+            break;
         case F3:
-        case F4:
+            gutter_toggle(conf, GUTTER_MARKERS);
+            break;
+
         case F5:
+            views_split(conf, VIEW_NODE_HSPLIT);
+            break;
         case F6:
+            views_split(conf, VIEW_NODE_VSPLIT);
+            break;
         case F7:
+            views_cycle(conf, 1);
+            break;
         case F8:
+            views_close(conf);
+            break;
+
         case F9:
+            filewatch_toggle_follow(conf);
+            break;
+
         case F10:
+            folds_toggle(conf, conf->cy);
+            break;
+        case F4:
+            folds_clear(conf);
+            break;
+
         case F11:
+            editor_toggle_hex(conf);
+            break;
+
         case F12:
+            wrap_toggle(conf);
+            break;
+
+        case F1:
+            profile_toggle(conf);
             break;
 
             // TODO: do something about this commented code
 
         case INTERRUPT_ENCOUNTERED:
-            conf->flags.resize_needed = 0;
-            term_get_window_size(conf, &conf->screen_rows, &conf->screen_cols);
-            conf->screen_rows -= 2;  // for prompt and message rows
+            term_resize(conf);
             break;
+        case HANGUP:
+            return EXIT_LOOP_CODE;
         case '\r':
-            s = malloc(sizeof(struct Snapshot));
+            s = alloc_malloc(sizeof(struct Snapshot));
             snapshot_create(conf, s);
             stack_push(conf->stack_undo, s);
 
@@ -409,15 +644,15 @@ int8_t editor_process_key_press(struct EditorConfig *conf) {
 
         case CTRL_ARROW_UP:
             if (conf->rowoff > 0) {
-                conf->cy--;
-                conf->rowoff--;
+                conf->cy = folds_next(conf, conf->cy, -1);
+                conf->rowoff = folds_next(conf, conf->rowoff, -1);
             }
             break;
 
         case CTRL_ARROW_DOWN:
             if (conf->rowoff < conf->numrows - 6) {
-                conf->rowoff++;
-                conf->cy++;
+                conf->rowoff = folds_next(conf, conf->rowoff, 1);
+                conf->cy = min(folds_next(conf, conf->cy, 1), conf->numrows);
             }
             break;
 
@@ -426,12 +661,30 @@ int8_t editor_process_key_press(struct EditorConfig *conf) {
             editor_cursor_ctrl(conf, c);
             break;
 
+        case ALT_ARROW_UP:
+        case ALT_ARROW_DOWN:
+            cursors_add_vertical(conf, c == ALT_ARROW_UP ? -1 : 1);
+            break;
+
+        case ALT_SHIFT_ARROW_UP:
+        case ALT_SHIFT_ARROW_DOWN:
+        case ALT_SHIFT_ARROW_RIGHT:
+        case ALT_SHIFT_ARROW_LEFT:
+            editor_block_extend(conf, c);
+            break;
+
         case PAGE_UP:
         case PAGE_DOWN:
-            if (c == PAGE_UP) {
+            if (conf->flags.soft_wrap) {
+                int32_t top = wrap_screen_top(conf);
+                wrap_cursor_to_line(
+                    conf, c == PAGE_UP ? top : top + conf->screen_rows - 1);
+            } else if (c == PAGE_UP) {
                 conf->cy = conf->rowoff;
             } else if (c == PAGE_DOWN) {
-                conf->cy = conf->rowoff + conf->screen_rows - 1;
+                conf->cy = folds_file_row(
+                    conf, folds_visible_index(conf, conf->rowoff) +
+                              conf->screen_rows - 1);
                 if (conf->cy > conf->numrows) conf->cy = conf->numrows;
             }
             while (times--) {
@@ -440,13 +693,8 @@ int8_t editor_process_key_press(struct EditorConfig *conf) {
             break;
 
         case HOME_KEY:
-            conf->cx = 0;
-            break;
-
         case END_KEY:
-            if (row) {
-                conf->cx = row->size;
-            }
+            editor_cursor_move(conf, c);
             break;
 
         case BACKSPACE:
@@ -457,7 +705,7 @@ int8_t editor_process_key_press(struct EditorConfig *conf) {
             }
 
             if (time_elapsed > 0.5) {
-                s = malloc(sizeof(struct Snapshot));
+                s = alloc_malloc(sizeof(struct Snapshot));
                 if (!s) die("snapshot malloc failed");
                 snapshot_create(conf, s);
                 stack_push(conf->stack_undo, s);
@@ -466,21 +714,52 @@ int8_t editor_process_key_press(struct EditorConfig *conf) {
             conf->last_time_modified = current_time;
             break;
 
-        case CTRL_KEY('q'):
-            if (quit_times != 0 && conf->flags.is_dirty) {
+        case CTRL_KEY('q'): {
+            // parked buffers are lost on quit just like the current one
+            const char *name;
+            if (quit_times != 0 && buflist_dirty(conf, &name) != -1) {
                 editor_set_status_message(conf,
-                                          "WARNING!!! file has unsaved changes."
-                                          "Press CTRL-Q %d time(s) to leave",
-                                          quit_times);
+                                          "WARNING!!! %.40s has unsaved "
+                                          "changes. Press CTRL-Q %d time(s) "
+                                          "to leave",
+                                          name, quit_times);
                 quit_times--;
                 return EXIT_FAILURE;
             }
             return EXIT_LOOP_CODE;
-            break;
+        }
         case CTRL_KEY('l'):
         case '\x1b':
             break;
 
+        case ALT_ARROW_LEFT:
+            buflist_cycle(conf, -1);
+            break;
+        case ALT_ARROW_RIGHT:
+            buflist_cycle(conf, 1);
+            break;
+
+        case CTRL_KEY('o'): {
+            char *path = editor_prompt(conf, "Open: %s", NULL);
+            if (path) {
+                buflist_open(conf, path);
+                free(path);
+            }
+            break;
+        }
+        case CTRL_KEY('w'):
+            if (quit_times != 0 && conf->flags.is_dirty) {
+                editor_set_status_message(conf,
+                                          "WARNING!!! buffer has unsaved "
+                                          "changes. Press CTRL-W %d time(s) "
+                                          "to close it",
+                                          quit_times);
+                quit_times--;
+                return EXIT_FAILURE;
+            }
+            buflist_close(conf);
+            break;
+
         case CTRL_KEY('s'):
             editor_save(conf);
             break;
@@ -489,7 +768,7 @@ int8_t editor_process_key_press(struct EditorConfig *conf) {
             editor_copy(conf);
             break;
         case CTRL_KEY('v'):
-            s = malloc(sizeof(struct Snapshot));
+            s = alloc_malloc(sizeof(struct Snapshot));
             if (!s) die("snapshot malloc failed");
             snapshot_create(conf, s);
             stack_push(conf->stack_undo, s);
@@ -497,8 +776,30 @@ int8_t editor_process_key_press(struct EditorConfig *conf) {
 
             editor_paste(conf);
             break;
+        case PASTE_START: {
+            // pasted text skips the per key pipeline (no auto indent/parens)
+            char *text;
+            int32_t text_len;
+            editor_read_paste(conf, &text, &text_len);
+
+            if (text_len) {
+                s = alloc_malloc(sizeof(struct Snapshot));
+                if (!s) die("snapshot malloc failed");
+                snapshot_create(conf, s);
+                stack_push(conf->stack_undo, s);
+                conf->last_time_modified = current_time;
+
+                if (!conf->flags.program_state) conf->flags.program_state = 1;
+
+                int32_t pasted = editor_paste_text(conf, text, text_len);
+                if (pasted > -1)
+                    editor_set_status_message(conf, "pasted %d bytes", pasted);
+            }
+            free(text);
+            break;
+        }
         case CTRL_KEY('x'):
-            s = malloc(sizeof(struct Snapshot));
+            s = alloc_malloc(sizeof(struct Snapshot));
             if (!s) die("snapshot malloc failed");
             snapshot_create(conf, s);
             stack_push(conf->stack_undo, s);
@@ -520,19 +821,24 @@ int8_t editor_process_key_press(struct EditorConfig *conf) {
             if (!conf->flags.program_state) conf->flags.program_state = 1;
 
             if (time_elapsed > 0.5) {
-                s = malloc(sizeof(struct Snapshot));
+                s = alloc_malloc(sizeof(struct Snapshot));
                 if (!s) die("snapshot malloc failed");
                 snapshot_create(conf, s);
                 stack_push(conf->stack_undo, s);
             }
 
-            editor_insert_char(conf, c);
+            // the rest of a UTF-8 sequence goes in with its lead byte, so no
+            // frame ever shows half a character
+            char glyph[UTF8_MAX_BYTES];
+            int32_t glyph_len = editor_read_glyph(conf, c, glyph);
+            for (int32_t i = 0; i < glyph_len; i++)
+                editor_insert_char(conf, (unsigned char)glyph[i]);
 
             if (check_is_paranthesis(c)) {
                 char extra_appended = closing_paren(c);
                 if (c) {
                     editor_insert_char(conf, extra_appended);
-                    if (!conf->cx) conf->cx--;
+                    if (conf->cx > 0) conf->cx--;
                 }
             }
 
@@ -547,6 +853,24 @@ int8_t editor_process_key_press(struct EditorConfig *conf) {
     return EXIT_SUCCESS;
 }
 
+void editor_on_input(struct EditorConfig *conf, void *data) {
+    (void)data;
+
+    // every key already queued is handled before the next frame
+    do {
+        PROFILE_BEGIN(PROFILE_EDIT);
+        int8_t result = editor_process_key_press(conf);
+        PROFILE_END(PROFILE_EDIT);
+
+        if (result == EXIT_LOOP_CODE) {
+            conf->loop->running = 0;
+            return;
+        }
+    } while (editor_key_pending(conf));
+
+    loop_request_frame(conf->loop);
+}
+
 int8_t editor_insert_newline(struct EditorConfig *conf) {
     struct Row *current_row;
     if (conf->numrows) {
@@ -557,19 +881,18 @@ int8_t editor_insert_newline(struct EditorConfig *conf) {
         return EXIT_SUCCESS;
     }
 
-    int32_t numline_prefix_width = editor_row_numline_calculate(current_row);
-    int32_t original_indent = current_row->indentation;
-    int32_t new_indent = current_row->indentation;
+    int32_t original_indent = editor_row_indentation(current_row);
+    int32_t new_indent = original_indent;
     int8_t result;
 
-    if (conf->cx == numline_prefix_width) {
+    if (conf->cx == 0) {
         result = editor_insert_row(conf, conf->cy, "", 0);
     } else {
         int8_t is_compound_block =
             check_compound_statement(current_row->chars, current_row->size);
         int8_t cursor_inside_brackets =
             check_is_in_brackets(current_row->chars, current_row->size,
-                                 conf->cx - numline_prefix_width);
+                                 conf->cx);
 
         // cursor inside {} basically
         if (is_compound_block && cursor_inside_brackets) {
@@ -586,7 +909,6 @@ int8_t editor_insert_newline(struct EditorConfig *conf) {
                    remainder_length);
             indented_remainder[indented_remainder_len] = '\0';
 
-            current_row->chars = realloc(current_row->chars, bracket_pos + 1);
             current_row->chars[bracket_pos] = '\0';
 
             char *truncated_line = strdup(current_row->chars);
@@ -620,10 +942,7 @@ int8_t editor_insert_newline(struct EditorConfig *conf) {
             free(newline);
 
             current_row = &conf->rows[conf->cy];
-            current_row->size = conf->cx - numline_prefix_width;
-
-            current_row->chars =
-                realloc(current_row->chars, current_row->size + 1);
+            current_row->size = conf->cx;
             current_row->chars[current_row->size] = '\0';
             editor_update_row(conf, current_row);
         }
@@ -631,28 +950,17 @@ int8_t editor_insert_newline(struct EditorConfig *conf) {
 
     current_row = &conf->rows[conf->cy];
 
-    int32_t updated_prefix_width = count_digits(current_row->idx + 2) + 1;
-    numline_prefix_width =
-        updated_prefix_width;  // could have been updated, so we check
-
     // moving cursor and rowoff
-    if (result == EXIT_SUCCESS && numline_prefix_width) {
-        conf->cx = numline_prefix_width + current_row->indentation;
+    if (result == EXIT_SUCCESS) {
+        conf->cx = editor_row_indentation(current_row);
         conf->cy++;
         if (conf->cy >= conf->rowoff + conf->screen_rows) {
             conf->rowoff++;
         }
         if (new_indent > original_indent) {
             conf->cx++;
-        } else if (new_indent < original_indent) {
-            if (!conf->cx) conf->cx--;
-            if (conf->cx < numline_prefix_width) {
-                conf->cx = numline_prefix_width;
-            }
-        }
-
-        if (conf->cx < numline_prefix_width) {
-            conf->cx = numline_prefix_width;
+        } else if (new_indent < original_indent && conf->cx > 0) {
+            conf->cx--;
         }
     }
 
@@ -0,0 +1,557 @@
+#include "journal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "arena.h"
+#include "buflist.h"
+#include "config.h"
+#include "core.h"
+#include "gutter.h"
+#include "input.h"
+#include "loop.h"
+#include "rows.h"
+
+#define JOURNAL_MAGIC "SCOOMJ1\n"
+#define JOURNAL_MAGIC_LEN 8
+
+enum JournalJobKind {
+    JOURNAL_JOB_APPEND,
+    JOURNAL_JOB_REPLACE,  // compaction, written aside and renamed over
+    JOURNAL_JOB_REMOVE
+};
+
+struct JournalJob {
+    int8_t kind;
+    char* path;
+    char* data;
+    int32_t len;
+    struct JournalJob* next;
+};
+
+/*
+ * Jobs run in the order they were pushed, so a compaction queued after
+ * some appends replaces them and a remove always comes last.
+ */
+struct JournalWriter {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct JournalJob* head;
+    struct JournalJob* tail;
+    int8_t stop;
+    int8_t keep;  // journal_forget flushes instead of removing
+};
+
+// in front of every operation, check covers the other fields and the text
+struct JournalRecord {
+    uint32_t check;
+    int32_t at;
+    int32_t len;
+    uint8_t op;
+    uint8_t pad[3];
+};
+
+// FNV-1a, enough to spot a record torn by a crash mid write
+static uint32_t journal_hash(uint32_t hash, const void* data, int32_t len) {
+    const unsigned char* p = data;
+    for (int32_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// only inserts and sets carry text, a delete keeps its row count in len
+static int32_t record_payload(const struct JournalRecord* record) {
+    if (record->op == JOURNAL_OP_INSERT || record->op == JOURNAL_OP_SET)
+        return record->len;
+    return 0;
+}
+
+static uint32_t record_check(const struct JournalRecord* record,
+                             const char* chars) {
+    uint32_t hash = 2166136261u;
+    hash = journal_hash(hash, &record->at, sizeof(record->at));
+    hash = journal_hash(hash, &record->len, sizeof(record->len));
+    hash = journal_hash(hash, &record->op, sizeof(record->op));
+    return journal_hash(hash, chars, record_payload(record));
+}
+
+static void buf_append(char** buf, int32_t* len, int32_t* cap,
+                       const void* data, int32_t size) {
+    if (*len + size > *cap) {
+        if (!*cap) *cap = 256;
+        while (*len + size > *cap) *cap *= 2;
+        *buf = realloc(*buf, *cap);
+        if (!*buf) die("journal buffer realloc failed");
+    }
+    if (size) memcpy(&(*buf)[*len], data, size);
+    *len += size;
+}
+
+static void record_append(char** buf, int32_t* len, int32_t* cap,
+                          uint8_t op, int32_t at, const char* chars,
+                          int32_t count) {
+    struct JournalRecord record;
+    memset(&record, 0, sizeof(record));
+    record.at = at;
+    record.len = count;
+    record.op = op;
+    record.check = record_check(&record, chars);
+
+    buf_append(buf, len, cap, &record, sizeof(record));
+    buf_append(buf, len, cap, chars, record_payload(&record));
+}
+
+// .name.journal next to the file, NULL for unnamed buffers
+static char* journal_path(const char* filepath) {
+    if (!filepath) return NULL;
+
+    const char* name = strrchr(filepath, '/');
+    int32_t dir = name ? name - filepath + 1 : 0;
+    name = name ? name + 1 : filepath;
+
+    int32_t len = dir + strlen(name) + sizeof(".journal") + 1;
+    char* path = malloc(len);
+    if (!path) die("journal path malloc failed");
+    snprintf(path, len, "%.*s.%s.journal", dir, filepath, name);
+
+    return path;
+}
+
+// takes ownership of data, path is copied since the buffer may close first
+static void writer_push(struct EditorConfig* conf, int8_t kind,
+                        const char* path, char* data, int32_t len) {
+    struct JournalWriter* writer = conf->journal_writer;
+    if (!writer) {
+        free(data);
+        return;
+    }
+
+    struct JournalJob* job = malloc(sizeof(struct JournalJob));
+    if (!job) die("journal job malloc failed");
+    job->kind = kind;
+    job->path = strdup(path);
+    if (!job->path) die("journal job strdup failed");
+    job->data = data;
+    job->len = len;
+    job->next = NULL;
+
+    pthread_mutex_lock(&writer->lock);
+    if (writer->tail)
+        writer->tail->next = job;
+    else
+        writer->head = job;
+    writer->tail = job;
+    pthread_cond_signal(&writer->cond);
+    pthread_mutex_unlock(&writer->lock);
+}
+
+static void writer_run(const struct JournalJob* job) {
+    if (job->kind == JOURNAL_JOB_REMOVE) {
+        unlink(job->path);
+        return;
+    }
+
+    // a compaction is written aside and renamed, the old journal stays
+    // valid until the new one is complete
+    char* tmp = NULL;
+    const char* target = job->path;
+    int32_t flags = O_WRONLY | O_CREAT | O_CLOEXEC;
+    if (job->kind == JOURNAL_JOB_REPLACE) {
+        int32_t len = strlen(job->path) + sizeof(".tmp");
+        tmp = malloc(len);
+        if (!tmp) die("journal tmp path malloc failed");
+        snprintf(tmp, len, "%s.tmp", job->path);
+        target = tmp;
+        flags |= O_TRUNC;
+    } else {
+        flags |= O_APPEND;
+    }
+
+    int32_t fd = open(target, flags, 0600);
+    if (fd == -1) {
+        free(tmp);
+        return;
+    }
+
+    int32_t done = 0;
+    while (done < job->len) {
+        ssize_t n = write(fd, &job->data[done], job->len - done);
+        if (n == -1 && errno == EINTR) continue;
+        if (n <= 0) break;
+        done += n;
+    }
+    fdatasync(fd);
+    close(fd);
+
+    if (tmp && done == job->len) rename(tmp, job->path);
+    free(tmp);
+}
+
+static void* writer_main(void* arg) {
+    struct JournalWriter* writer = arg;
+
+    pthread_mutex_lock(&writer->lock);
+    while (1) {
+        while (!writer->head && !writer->stop)
+            pthread_cond_wait(&writer->cond, &writer->lock);
+        if (!writer->head) break;
+
+        // take the whole batch, pushes don't wait on the disk
+        struct JournalJob* job = writer->head;
+        writer->head = NULL;
+        writer->tail = NULL;
+        pthread_mutex_unlock(&writer->lock);
+
+        while (job) {
+            struct JournalJob* next = job->next;
+            writer_run(job);
+            free(job->path);
+            free(job->data);
+            free(job);
+            job = next;
+        }
+
+        pthread_mutex_lock(&writer->lock);
+    }
+    pthread_mutex_unlock(&writer->lock);
+
+    return NULL;
+}
+
+static void journal_record(struct EditorConfig* conf, uint8_t op, int32_t at,
+                           const char* chars, int32_t count) {
+    struct Journal* journal = &conf->journal;
+    if (!journal->path || journal->snapshot) return;
+
+    // the first change after a clean state starts a new journal
+    if (!journal->on_disk) {
+        journal->snapshot = 1;
+        return;
+    }
+
+    record_append(&journal->log, &journal->len, &journal->cap, op, at, chars,
+                  count);
+}
+
+void journal_log_reset(struct EditorConfig* conf) {
+    if (conf->journal.path) conf->journal.snapshot = 1;
+}
+
+void journal_log_insert(struct EditorConfig* conf, int32_t at,
+                        const char* chars, int32_t len) {
+    journal_record(conf, JOURNAL_OP_INSERT, at, chars, len);
+}
+
+void journal_log_set(struct EditorConfig* conf, int32_t at, const char* chars,
+                     int32_t len) {
+    journal_record(conf, JOURNAL_OP_SET, at, chars, len);
+}
+
+void journal_log_delete(struct EditorConfig* conf, int32_t at, int32_t count) {
+    journal_record(conf, JOURNAL_OP_DELETE, at, NULL, count);
+}
+
+// hands the log of the current buffer to the writer
+static void journal_flush(struct EditorConfig* conf) {
+    struct Journal* journal = &conf->journal;
+    if (!journal->path) return;
+
+    // replaying a long log costs more than rewriting the rows
+    if (journal->on_disk &&
+        journal->logged + journal->len > journal->base + JOURNAL_COMPACT_SLACK)
+        journal->snapshot = 1;
+
+    if (journal->snapshot) {
+        char* data = NULL;
+        int32_t len = 0, cap = 0;
+        buf_append(&data, &len, &cap, JOURNAL_MAGIC, JOURNAL_MAGIC_LEN);
+        record_append(&data, &len, &cap, JOURNAL_OP_RESET, 0, NULL, 0);
+        for (int32_t i = 0; i < conf->numrows; i++) {
+            record_append(&data, &len, &cap, JOURNAL_OP_INSERT, i,
+                          conf->rows[i].chars, conf->rows[i].size);
+        }
+
+        writer_push(conf, JOURNAL_JOB_REPLACE, journal->path, data, len);
+        journal->len = 0;
+        journal->base = len;
+        journal->logged = 0;
+        journal->snapshot = 0;
+        journal->on_disk = 1;
+    } else if (journal->len) {
+        // the log itself becomes the job, no copy
+        writer_push(conf, JOURNAL_JOB_APPEND, journal->path, journal->log,
+                    journal->len);
+        journal->logged += journal->len;
+        journal->log = NULL;
+        journal->len = 0;
+        journal->cap = 0;
+    }
+}
+
+static void on_flush(struct EditorConfig* conf, void* data) {
+    (void)data;
+    struct EditorBufList* buffers = &conf->buffers;
+    int32_t current = buffers->current;
+
+    journal_flush(conf);
+
+    for (int32_t i = 0; i < buffers->count; i++) {
+        const struct Journal* journal = &buffers->items[i].journal;
+        if (i == current || (!journal->len && !journal->snapshot)) continue;
+        buflist_select(conf, i);
+        journal_flush(conf);
+    }
+    buflist_select(conf, current);
+}
+
+int8_t journal_create(struct EditorConfig* conf) {
+    conf->journal_timer = -1;
+
+    struct JournalWriter* writer = malloc(sizeof(struct JournalWriter));
+    if (!writer) die("journal writer malloc failed");
+
+    pthread_mutex_init(&writer->lock, NULL);
+    pthread_cond_init(&writer->cond, NULL);
+    writer->head = NULL;
+    writer->tail = NULL;
+    writer->stop = 0;
+    writer->keep = 0;
+
+    // signals are left to the main thread and its signalfd
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    if (pthread_create(&writer->thread, NULL, writer_main, writer) != 0)
+        die("couldn't start the journal writer");
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    conf->journal_writer = writer;
+
+    return EXIT_SUCCESS;
+}
+
+// pending jobs are finished before the writer exits
+int8_t journal_destroy(struct EditorConfig* conf) {
+    struct JournalWriter* writer = conf->journal_writer;
+    if (!writer) return EXIT_FAILURE;
+
+    pthread_mutex_lock(&writer->lock);
+    writer->stop = 1;
+    pthread_cond_signal(&writer->cond);
+    pthread_mutex_unlock(&writer->lock);
+    pthread_join(writer->thread, NULL);
+
+    pthread_mutex_destroy(&writer->lock);
+    pthread_cond_destroy(&writer->cond);
+    free(writer);
+    conf->journal_writer = NULL;
+
+    return EXIT_SUCCESS;
+}
+
+int8_t journal_start(struct EditorConfig* conf) {
+    conf->journal_timer = loop_timer_add(conf->loop, on_flush, NULL);
+    if (conf->journal_timer == -1) return EXIT_FAILURE;
+    loop_timer_arm(conf->loop, conf->journal_timer, JOURNAL_FLUSH_MS, 1);
+
+    // files from the command line were opened before the terminal was raw
+    struct EditorBufList* buffers = &conf->buffers;
+    int32_t current = buffers->current;
+    for (int32_t i = 0; i < buffers->count; i++) {
+        const struct Journal* journal = i == buffers->current
+                                            ? &conf->journal
+                                            : &buffers->items[i].journal;
+        if (!journal->recover) continue;
+        buflist_select(conf, i);
+        journal_recover(conf);
+    }
+    buflist_select(conf, current);
+
+    return EXIT_SUCCESS;
+}
+
+int8_t journal_preserve(struct EditorConfig* conf) {
+    if (!conf->journal_writer) return EXIT_FAILURE;
+    conf->journal_writer->keep = 1;
+    return EXIT_SUCCESS;
+}
+
+int8_t journal_clean(struct EditorConfig* conf) {
+    struct Journal* journal = &conf->journal;
+    if (journal->on_disk)
+        writer_push(conf, JOURNAL_JOB_REMOVE, journal->path, NULL, 0);
+
+    // save as may have given the buffer a new name
+    free(journal->path);
+    journal->path = journal_path(conf->filepath);
+
+    journal->len = 0;
+    journal->base = 0;
+    journal->logged = 0;
+    journal->snapshot = 0;
+    journal->on_disk = 0;
+    journal->recover = 0;
+
+    return EXIT_SUCCESS;
+}
+
+int8_t journal_attach(struct EditorConfig* conf) {
+    journal_clean(conf);
+
+    struct Journal* journal = &conf->journal;
+    struct stat st;
+    if (!journal->path || stat(journal->path, &st) == -1 ||
+        st.st_size <= JOURNAL_MAGIC_LEN)
+        return EXIT_SUCCESS;
+
+    journal->recover = 1;
+
+    // before editor_run there is no terminal to ask on, journal_start does
+    if (conf->loop) return journal_recover(conf);
+    return EXIT_SUCCESS;
+}
+
+int8_t journal_forget(struct EditorConfig* conf) {
+    struct Journal* journal = &conf->journal;
+    struct JournalWriter* writer = conf->journal_writer;
+
+    if (writer && writer->keep && conf->flags.is_dirty)
+        journal_flush(conf);
+    else if (journal->on_disk)
+        writer_push(conf, JOURNAL_JOB_REMOVE, journal->path, NULL, 0);
+
+    free(journal->path);
+    free(journal->log);
+    journal->path = NULL;
+    journal->log = NULL;
+    journal->len = 0;
+    journal->cap = 0;
+    journal->on_disk = 0;
+    journal->snapshot = 0;
+    journal->recover = 0;
+
+    return EXIT_SUCCESS;
+}
+
+static int8_t journal_apply(struct EditorConfig* conf,
+                            const struct JournalRecord* record,
+                            const char* chars) {
+    switch (record->op) {
+        case JOURNAL_OP_RESET:
+            return conf_destroy_rows(conf);
+        case JOURNAL_OP_INSERT:
+            return editor_insert_row(conf, record->at, chars, record->len);
+        case JOURNAL_OP_SET: {
+            if (record->at < 0 || record->at >= conf->numrows)
+                return EXIT_FAILURE;
+            struct Row* row = &conf->rows[record->at];
+            row->chars =
+                arena_realloc(conf->arena, row->chars, record->len + 1);
+            memcpy(row->chars, chars, record->len);
+            row->size = record->len;
+            row->chars[row->size] = '\0';
+            return editor_update_row(conf, row);
+        }
+        case JOURNAL_OP_DELETE:
+            return editor_delete_rows(conf, record->at, record->len);
+    }
+    return EXIT_FAILURE;
+}
+
+// applies records until the first torn or invalid one
+static int8_t journal_replay(struct EditorConfig* conf) {
+    int32_t fd = open(conf->journal.path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) return EXIT_FAILURE;
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size <= JOURNAL_MAGIC_LEN) {
+        close(fd);
+        return EXIT_FAILURE;
+    }
+
+    int64_t len = st.st_size;
+    char* data = malloc(len);
+    if (!data) die("journal read malloc failed");
+
+    int64_t got = 0;
+    while (got < len) {
+        ssize_t n = read(fd, &data[got], len - got);
+        if (n == -1 && errno == EINTR) continue;
+        if (n <= 0) break;
+        got += n;
+    }
+    close(fd);
+
+    if (got < JOURNAL_MAGIC_LEN ||
+        memcmp(data, JOURNAL_MAGIC, JOURNAL_MAGIC_LEN) != 0) {
+        free(data);
+        return EXIT_FAILURE;
+    }
+
+    int64_t pos = JOURNAL_MAGIC_LEN;
+    while (got - pos >= (int64_t)sizeof(struct JournalRecord)) {
+        struct JournalRecord record;
+        memcpy(&record, &data[pos], sizeof(record));
+        const char* chars = &data[pos + sizeof(record)];
+
+        int32_t payload = record_payload(&record);
+        if (record.len < 0 ||
+            payload > got - pos - (int64_t)sizeof(record) ||
+            record_check(&record, chars) != record.check)
+            break;
+        if (journal_apply(conf, &record, chars) == EXIT_FAILURE) break;
+
+        pos += sizeof(record) + payload;
+    }
+    free(data);
+
+    conf->cy = min(conf->cy, conf->numrows);
+    conf->cx = 0;
+    gutter_clear_markers(conf);
+    conf->flags.is_dirty = 1;
+
+    return EXIT_SUCCESS;
+}
+
+int8_t journal_recover(struct EditorConfig* conf) {
+    struct Journal* journal = &conf->journal;
+    journal->recover = 0;
+
+    char* answer = editor_prompt(
+        conf, "Unsaved changes of a crashed session found, recover? (y/n) %s",
+        NULL);
+    int8_t replay = answer && (answer[0] == 'y' || answer[0] == 'Y');
+    free(answer);
+
+    // hung up before an answer, the journal is left for the next session
+    if (!answer && conf->loop->exit_signal) return EXIT_SUCCESS;
+
+    if (!replay) {
+        writer_push(conf, JOURNAL_JOB_REMOVE, journal->path, NULL, 0);
+        editor_set_status_message(conf, "recovery journal discarded");
+        return EXIT_SUCCESS;
+    }
+
+    if (journal_replay(conf) == EXIT_FAILURE) {
+        editor_set_status_message(conf, "recovery journal is unreadable");
+        return EXIT_FAILURE;
+    }
+
+    // the next flush rewrites the journal from the recovered rows
+    journal->snapshot = 1;
+    journal->len = 0;
+    editor_set_status_message(conf, "recovered unsaved changes of %.40s",
+                              conf->filepath);
+
+    return EXIT_SUCCESS;
+}
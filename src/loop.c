@@ -0,0 +1,258 @@
+#include "loop.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "alloc.h"
+#include "config.h"
+#include "core.h"
+#include "input.h"
+#include "render.h"
+#include "terminal.h"
+
+static int64_t elapsed_ms(const struct timespec* since) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - since->tv_sec) * 1000 +
+           (now.tv_nsec - since->tv_nsec) / 1000000;
+}
+
+// signals the loop takes through its signalfd instead of a handler
+static void loop_signal_mask(sigset_t* mask) {
+    sigemptyset(mask);
+    sigaddset(mask, SIGWINCH);
+    sigaddset(mask, SIGTERM);
+    sigaddset(mask, SIGHUP);
+    sigaddset(mask, SIGINT);
+    sigaddset(mask, SIGUSR1);  // allocation report on demand
+}
+
+static void on_signal(struct EditorConfig* conf, void* data) {
+    (void)data;
+    struct EditorLoop* loop = conf->loop;
+    int8_t resized = 0;
+
+    struct signalfd_siginfo info;
+    while (read(loop->sigfd, &info, sizeof(info)) == sizeof(info)) {
+        if (info.ssi_signo == SIGWINCH) {
+            resized = 1;
+        } else if (info.ssi_signo == SIGUSR1) {
+            editor_set_status_message(conf, alloc_report_write() == EXIT_SUCCESS
+                                                ? "Allocation report written"
+                                                : "Allocation report failed");
+        } else {
+            // leave through editor_run so buffers get torn down properly
+            loop->exit_signal = info.ssi_signo;
+            loop->running = 0;
+        }
+    }
+
+    if (resized) {
+        term_resize(conf);
+        loop_request_frame(loop);
+    }
+}
+
+// the frame itself is drawn by loop_run once the interval has passed
+static void on_frame_timer(struct EditorConfig* conf, void* data) {
+    (void)conf;
+    (void)data;
+}
+
+static int32_t loop_slot_add(struct EditorLoop* loop, int32_t fd,
+                             enum LoopWatchKind kind, LoopCallback callback,
+                             void* data) {
+    int32_t id = 0;
+    while (id < LOOP_MAX_WATCHES && loop->watches[id].fd != -1) id++;
+    if (id == LOOP_MAX_WATCHES) return -1;
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u32 = id;
+    if (epoll_ctl(loop->epfd, EPOLL_CTL_ADD, fd, &ev) == -1) return -1;
+
+    loop->watches[id].fd = fd;
+    loop->watches[id].kind = kind;
+    loop->watches[id].callback = callback;
+    loop->watches[id].data = data;
+
+    return id;
+}
+
+int8_t loop_create(struct EditorLoop* loop) {
+    loop->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (loop->epfd == -1) die("epoll_create1 failed");
+
+    for (int32_t i = 0; i < LOOP_MAX_WATCHES; i++) loop->watches[i].fd = -1;
+
+    loop->frame_pending = 1;
+    loop->running = 0;
+    loop->exit_signal = 0;
+    loop->last_frame.tv_sec = 0;
+    loop->last_frame.tv_nsec = 0;
+
+    // SIGWINCH is delivered through a fd instead of interrupting reads,
+    // termination signals too so the loop can stop cleanly
+    sigset_t mask;
+    loop_signal_mask(&mask);
+    if (sigprocmask(SIG_BLOCK, &mask, NULL) == -1) die("sigprocmask failed");
+
+    loop->sigfd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (loop->sigfd == -1) die("signalfd failed");
+    if (loop_slot_add(loop, loop->sigfd, WATCH_FD, on_signal, NULL) == -1)
+        die("couldn't watch signalfd");
+
+    loop->frame_timer = loop_timer_add(loop, on_frame_timer, NULL);
+    if (loop->frame_timer == -1) die("couldn't create frame timer");
+
+    return EXIT_SUCCESS;
+}
+
+int8_t loop_destroy(struct EditorLoop* loop) {
+    // signals that came in while stopping would kill us once unblocked
+    struct signalfd_siginfo info;
+    while (read(loop->sigfd, &info, sizeof(info)) == sizeof(info)) continue;
+
+    for (int32_t i = 0; i < LOOP_MAX_WATCHES; i++) {
+        if (loop->watches[i].fd != -1) loop_watch_remove(loop, i);
+    }
+
+    close(loop->epfd);
+    loop->epfd = -1;
+    loop->sigfd = -1;
+
+    sigset_t mask;
+    loop_signal_mask(&mask);
+    sigprocmask(SIG_UNBLOCK, &mask, NULL);
+
+    return EXIT_SUCCESS;
+}
+
+int32_t loop_watch_add(struct EditorLoop* loop, int32_t fd,
+                       LoopCallback callback, void* data) {
+    return loop_slot_add(loop, fd, WATCH_FD, callback, data);
+}
+
+int8_t loop_watch_remove(struct EditorLoop* loop, int32_t id) {
+    if (id < 0 || id >= LOOP_MAX_WATCHES) return EXIT_FAILURE;
+
+    struct LoopWatch* watch = &loop->watches[id];
+    if (watch->fd == -1) return EXIT_FAILURE;
+
+    epoll_ctl(loop->epfd, EPOLL_CTL_DEL, watch->fd, NULL);
+
+    // timers, wakeups and the signalfd are created by the loop itself
+    if (watch->kind != WATCH_FD || watch->fd == loop->sigfd) close(watch->fd);
+    watch->fd = -1;
+
+    return EXIT_SUCCESS;
+}
+
+int32_t loop_timer_add(struct EditorLoop* loop, LoopCallback callback,
+                       void* data) {
+    int32_t fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd == -1) return -1;
+
+    int32_t id = loop_slot_add(loop, fd, WATCH_TIMER, callback, data);
+    if (id == -1) close(fd);
+    return id;
+}
+
+int8_t loop_timer_arm(struct EditorLoop* loop, int32_t id, int32_t ms,
+                      int8_t periodic) {
+    if (id < 0 || id >= LOOP_MAX_WATCHES) return EXIT_FAILURE;
+    if (loop->watches[id].kind != WATCH_TIMER) return EXIT_FAILURE;
+
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = ms / 1000;
+    spec.it_value.tv_nsec = (ms % 1000) * 1000000L;
+    if (periodic) spec.it_interval = spec.it_value;
+
+    if (timerfd_settime(loop->watches[id].fd, 0, &spec, NULL) == -1)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
+
+int32_t loop_wakeup_add(struct EditorLoop* loop, LoopCallback callback,
+                        void* data) {
+    int32_t fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd == -1) return -1;
+
+    int32_t id = loop_slot_add(loop, fd, WATCH_WAKEUP, callback, data);
+    if (id == -1) close(fd);
+    return id;
+}
+
+int8_t loop_wakeup_signal(struct EditorLoop* loop, int32_t id) {
+    if (id < 0 || id >= LOOP_MAX_WATCHES) return EXIT_FAILURE;
+
+    uint64_t one = 1;
+    if (write(loop->watches[id].fd, &one, sizeof(one)) != sizeof(one))
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
+
+void loop_request_frame(struct EditorLoop* loop) { loop->frame_pending = 1; }
+
+/*
+    Draws a pending frame if the last one is at least FRAME_INTERVAL_MS old,
+    otherwise the frame timer is armed for whatever is left of the interval
+*/
+static void loop_schedule_frame(struct EditorConfig* conf) {
+    struct EditorLoop* loop = conf->loop;
+    if (!loop->frame_pending) return;
+
+    int64_t since_last = elapsed_ms(&loop->last_frame);
+    if (since_last < FRAME_INTERVAL_MS) {
+        loop_timer_arm(loop, loop->frame_timer,
+                       FRAME_INTERVAL_MS - since_last, 0);
+        return;
+    }
+
+    editor_refresh_screen(conf);
+    clock_gettime(CLOCK_MONOTONIC, &loop->last_frame);
+    loop->frame_pending = 0;
+}
+
+int8_t loop_run(struct EditorConfig* conf) {
+    struct EditorLoop* loop = conf->loop;
+    struct epoll_event events[LOOP_MAX_WATCHES];
+
+    loop->running = 1;
+    while (loop->running) {
+        loop_schedule_frame(conf);
+
+        int32_t n = epoll_wait(loop->epfd, events, LOOP_MAX_WATCHES, -1);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            die("epoll_wait failed");
+        }
+
+        for (int32_t i = 0; i < n && loop->running; i++) {
+            struct LoopWatch* watch = &loop->watches[events[i].data.u32];
+            if (watch->fd == -1) continue;
+
+            // timers and wakeups have to be drained or they stay readable
+            if (watch->kind != WATCH_FD) {
+                uint64_t count;
+                if (read(watch->fd, &count, sizeof(count)) != sizeof(count))
+                    continue;
+            }
+
+            watch->callback(conf, watch->data);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
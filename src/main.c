@@ -1,24 +1,40 @@
 #include <stdlib.h>
 
+#include "alloc.h"
+#include "buflist.h"
 #include "config.h"
 #include "core.h"
 #include "file.h"
 #include "input.h"
 #include "render.h"
+#include "replay.h"
 #include "terminal.h"
 
 int main(int argc, char* argv[]) {
+    // a recorded session plays back headless, sized like the recording
+    const char* replay = getenv("SCOOM_REPLAY");
+    if (replay && replay_open(replay) == EXIT_FAILURE)
+        die("couldn't open SCOOM_REPLAY");
+
     struct EditorConfig* conf = malloc(sizeof(struct EditorConfig));
     if (!conf) die("conf malloc failed");
 
-    if (argc >= 2 && editor_open(conf, argv[1]) != EXIT_SUCCESS) {
-        exit(EXIT_FAILURE);
+    g_conf = conf;
+    conf_create(conf);
+
+    // every file on the command line gets its own buffer
+    for (int32_t i = 1; i < argc; i++) {
+        if (buflist_open(conf, argv[i]) != EXIT_SUCCESS) exit(EXIT_FAILURE);
     }
+    buflist_switch(conf, 0);
 
     editor_run(conf);
 
     editor_destroy(conf);
     free(conf);
 
+    // only written when the build tracks allocations
+    alloc_report_write();
+
     exit(EXIT_SUCCESS);
 }
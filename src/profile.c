@@ -0,0 +1,107 @@
+#include "profile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "buffer.h"
+#include "config.h"
+#include "input.h"
+
+#if PROFILE_ENABLED
+
+#define PROFILE_WIDTH 31  // columns the overlay takes
+
+struct Profile g_profile = {.active = -1};
+
+static const char* profile_names[PROFILE_METRICS] = {
+    "input", "edit", "highlight", "draw", "write", "bytes", "allocs"};
+
+static int profile_compare(const void* a, const void* b) {
+    int64_t x = *(const int64_t*)a, y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// p50 and p99 of the frames in history
+static void profile_percentiles(enum ProfileMetric metric, int64_t* p50,
+                                int64_t* p99) {
+    int32_t n = g_profile.frames < PROFILE_FRAMES ? g_profile.frames
+                                                  : PROFILE_FRAMES;
+    int64_t sorted[PROFILE_FRAMES];
+    memcpy(sorted, g_profile.history[metric], sizeof(int64_t) * n);
+    qsort(sorted, n, sizeof(int64_t), profile_compare);
+
+    *p50 = n ? sorted[(n - 1) * 50 / 100] : 0;
+    *p99 = n ? sorted[(n - 1) * 99 / 100] : 0;
+}
+
+int8_t profile_toggle(struct EditorConfig* conf) {
+    g_profile.visible = !g_profile.visible;
+    editor_set_status_message(conf, "Profiler %s",
+                              g_profile.visible ? "shown" : "hidden");
+    return EXIT_SUCCESS;
+}
+
+int8_t profile_frame_end(void) {
+    int32_t slot = g_profile.frames % PROFILE_FRAMES;
+    for (int32_t m = 0; m < PROFILE_METRICS; m++) {
+        g_profile.history[m][slot] = g_profile.current[m];
+        g_profile.current[m] = 0;
+    }
+    g_profile.frames++;
+    return EXIT_SUCCESS;
+}
+
+int8_t profile_draw(struct EditorConfig* conf, struct ABuf* ab) {
+    if (!g_profile.visible) return EXIT_SUCCESS;
+
+    int32_t left = conf->views.cols - PROFILE_WIDTH + 1;
+    if (left < 1 || conf->views.rows < PROFILE_METRICS + 1)
+        return EXIT_SUCCESS;
+
+    char line[64];
+    int32_t len = snprintf(line, sizeof(line), "\x1b[1;%dH\x1b[7m", left);
+    ab_append(ab, line, len);
+    len = snprintf(line, sizeof(line), " %-9s %8s %8s   ", "per frame",
+                   "p50", "p99");
+    ab_append(ab, line, len);
+
+    for (int32_t m = 0; m < PROFILE_METRICS; m++) {
+        int64_t p50, p99;
+        profile_percentiles(m, &p50, &p99);
+
+        len = snprintf(line, sizeof(line), "\x1b[%d;%dH", m + 2, left);
+        ab_append(ab, line, len);
+
+        // timings in microseconds, counters as they are
+        if (m < PROFILE_TIMERS)
+            len = snprintf(line, sizeof(line), " %-9s %8.1f %8.1f us",
+                           profile_names[m], p50 / 1000.0, p99 / 1000.0);
+        else
+            len = snprintf(line, sizeof(line), " %-9s %8lld %8lld   ",
+                           profile_names[m], (long long)p50, (long long)p99);
+        ab_append(ab, line, len);
+    }
+
+    ab_append(ab, "\x1b[m", 3);
+    return EXIT_SUCCESS;
+}
+
+#else
+
+int8_t profile_toggle(struct EditorConfig* conf) {
+    editor_set_status_message(conf,
+                              "Profiler not built, configure with "
+                              "-DSCOOM_PROFILE=ON");
+    return EXIT_SUCCESS;
+}
+
+int8_t profile_frame_end(void) { return EXIT_SUCCESS; }
+
+int8_t profile_draw(struct EditorConfig* conf, struct ABuf* ab) {
+    (void)conf;
+    (void)ab;
+    return EXIT_SUCCESS;
+}
+
+#endif
@@ -9,14 +9,24 @@
 #include <time.h>
 #include <unistd.h>
 
+#include "block.h"
 #include "buffer.h"
 #include "config.h"
 #include "core.h"
+#include "cursors.h"
 #include "file.h"
+#include "folds.h"
+#include "gutter.h"
+#include "hexview.h"
 #include "highlight.h"
 #include "input.h"
+#include "loop.h"
+#include "profile.h"
 #include "rows.h"
 #include "terminal.h"
+#include "utf8.h"
+#include "views.h"
+#include "wrap.h"
 /***  Appending buffer section ***/
 
 char *editor_prompt(struct EditorConfig *conf, const char *prompt,
@@ -41,14 +51,14 @@ char *editor_prompt(struct EditorConfig *conf, const char *prompt,
                 return buf;
             }
 
-        } else if (c == '\x1b') {
+        } else if (c == '\x1b' || c == HANGUP) {
             editor_set_status_message(conf, "");
-            if (callback) callback(conf, buf, c);
+            if (callback) callback(conf, buf, '\x1b');
             free(buf);
             return NULL;
-        } else if (!iscntrl(c) && c < 128) {
+        } else if (!iscntrl(c) && c < 256) {
             // if the character is not a control character and not one of the
-            // mapped Keys from objects.h
+            // mapped Keys from objects.h, UTF-8 bytes are kept as they are
             if (buflen == bufsize - 1) {
                 // resize buf essentially
                 bufsize *= 2;
@@ -57,9 +67,26 @@ char *editor_prompt(struct EditorConfig *conf, const char *prompt,
             buf[buflen++] = c;
             buf[buflen] = '\0';
         } else if (c == DEL_KEY || c == CTRL_KEY('h') || c == BACKSPACE) {
-            if (buflen != 0) {
-                buf[--buflen] = '\0';
+            // a multibyte character is removed as a whole
+            while (buflen != 0 && utf8_is_continuation(buf[buflen - 1]))
+                buflen--;
+            if (buflen != 0) buflen--;
+            buf[buflen] = '\0';
+        } else if (c == PASTE_START) {
+            // prompts are single line, so only printable bytes are kept
+            char *text;
+            int32_t text_len;
+            editor_read_paste(conf, &text, &text_len);
+            for (int32_t i = 0; i < text_len; i++) {
+                if (iscntrl((unsigned char)text[i])) continue;
+                if (buflen == bufsize - 1) {
+                    bufsize *= 2;
+                    buf = realloc(buf, bufsize);
+                }
+                buf[buflen++] = text[i];
             }
+            buf[buflen] = '\0';
+            free(text);
         }
 
         if (callback) callback(conf, buf, c);
@@ -73,26 +100,36 @@ int8_t editor_set_status_message(struct EditorConfig *conf, const char *fmt,
     va_start(ap, fmt);
     vsnprintf(conf->status_msg, sizeof(conf->status_msg), fmt, ap);
     va_end(ap);
-    conf->sbuf_time = time(NULL);
+    if (conf->loop) {
+        loop_timer_arm(conf->loop, conf->status_timer, STATUS_MSG_TIMEOUT_MS,
+                       0);
+        loop_request_frame(conf->loop);
+    }
 
     return EXIT_SUCCESS;
 }
 
+void editor_on_status_expire(struct EditorConfig *conf, void *data) {
+    (void)data;
+    conf->status_msg[0] = '\0';
+    loop_request_frame(conf->loop);
+}
+
 /***  Screen display and rendering section ***/
 
 int8_t editor_refresh_screen(struct EditorConfig *conf) {
-    editor_scroll(conf);
+    if (conf->flags.resize_needed) term_resize(conf);
 
+    PROFILE_BEGIN(PROFILE_DRAW);
     struct ABuf ab = ABUF_INIT;
     ab_append(&ab, "\x1b[6 q", 5);   // Steady bar (vertical)
     ab_append(&ab, "\x1b[?25l", 6);  // Hide cursor
-    ab_append(&ab, "\x1b[H", 3);     // Move top left
 
-    editor_draw_rows(conf, &ab);
-    editor_draw_statusbar(conf, &ab);
+    // every view is composed into the same frame, it goes out in one write
+    views_draw(conf, &ab);
+    profile_draw(conf, &ab);
     editor_draw_messagebar(conf, &ab);
 
-    ab_append(&ab, "\x1b[H", 3);
     ab_append(&ab, "\x1b[?25h", 6);  // display cursor again
 
     /*
@@ -102,29 +139,70 @@ int8_t editor_refresh_screen(struct EditorConfig *conf) {
 
     char buf[32];
     // <esc>[<row>;<col>H
-    snprintf(buf, sizeof(buf), "\x1B[%d;%dH", conf->cy - conf->rowoff + 1,
-             conf->rx - conf->coloff + 1);
+    if (conf->hex.active) {
+        int32_t row, col;
+        hexview_cursor_position(conf, &row, &col);
+        snprintf(buf, sizeof(buf), "\x1B[%d;%dH", conf->screen_top + row + 1,
+                 conf->screen_left + col + 1);
+    } else if (conf->flags.soft_wrap) {
+        int32_t start = 0;
+        if (conf->cy < conf->numrows) {
+            struct Row *row = &conf->rows[conf->cy];
+            start = wrap_segment_start(
+                row, wrap_row_segment(conf, row, conf->rx));
+        }
+        snprintf(buf, sizeof(buf), "\x1B[%d;%dH",
+                 conf->screen_top + wrap_visual_line(conf, conf->cy, conf->rx) -
+                     wrap_screen_top(conf) + 1,
+                 conf->screen_left + conf->rx - start + conf->gutter.width + 1);
+    } else {
+        snprintf(buf, sizeof(buf), "\x1B[%d;%dH",
+                 conf->screen_top + folds_visible_index(conf, conf->cy) -
+                     folds_visible_index(conf, conf->rowoff) + 1,
+                 conf->screen_left + conf->rx - conf->coloff +
+                     conf->gutter.width + 1);
+    }
     ab_append(&ab, buf, strlen(buf));
+    PROFILE_END(PROFILE_DRAW);
 
-    if (write(STDOUT_FILENO, ab.buf, ab.len) == 0)
+    PROFILE_BEGIN(PROFILE_WRITE);
+    if (term_write(ab.buf, ab.len) == 0)
         die("couldn't write to stdout");
+    PROFILE_END(PROFILE_WRITE);
+    PROFILE_COUNT(PROFILE_BYTES, ab.len);
 
     ab_free(&ab);
+    profile_frame_end();
     return EXIT_SUCCESS;
 }
 
 int8_t editor_draw_messagebar(struct EditorConfig *conf, struct ABuf *ab) {
+    // the message bar spans the whole terminal below every view
+    char buf[32];
+    int32_t len =
+        snprintf(buf, sizeof(buf), "\x1b[%d;1H", conf->views.rows + 1);
+    ab_append(ab, buf, len);
+
     ab_append(ab, "\x1b[K", 3);  // we clear current line in terminal
     int32_t message_len = strlen(conf->status_msg);
-    if (message_len > conf->screen_cols) message_len = conf->screen_cols;
+    if (message_len > conf->views.cols) message_len = conf->views.cols;
 
-    if (message_len && time(NULL) - conf->sbuf_time < 5)
-        ab_append(ab, conf->status_msg, message_len);
+    // expiry is handled by conf->status_timer
+    if (message_len) ab_append(ab, conf->status_msg, message_len);
 
     return EXIT_SUCCESS;
 }
 
-int8_t editor_draw_statusbar(struct EditorConfig *conf, struct ABuf *ab) {
+int8_t editor_draw_statusbar(struct EditorConfig *conf, struct ABuf *ab,
+                             int8_t active) {
+    // status bar sits right below the text rows of its view
+    char pos[32];
+    int32_t pos_len =
+        snprintf(pos, sizeof(pos), "\x1b[%d;%dH",
+                 conf->screen_top + conf->screen_rows + 1,
+                 conf->screen_left + 1);
+    ab_append(ab, pos, pos_len);
+
     /*
     you could specify all of these attributes using the command <esc>[1;4;5;7m.
     An argument of 0 clears all attributes, and is the default argument, so we
@@ -132,18 +210,30 @@ int8_t editor_draw_statusbar(struct EditorConfig *conf, struct ABuf *ab) {
     */
 
     ab_append(ab, "\x1b[7m", 4);  // invert colors
+    if (active) ab_append(ab, "\x1b[1m", 4);  // bold for the focused view
 
     // text to write inside statusbar
     char status[80], rstatus[80];
-    int32_t status_len =
-        snprintf(status, sizeof(status), "%.20s - %d lines %s",
-                 conf->filepath ? conf->filepath : "[No Name]", conf->numrows,
-                 conf->flags.is_dirty ? "(modified)" : "");
-
-    int32_t rstatus_len =
-        snprintf(rstatus, sizeof(rstatus), "%s | %d/%d",
-                 conf->syntax ? conf->syntax->filetype : "no ft", conf->cy + 1,
-                 conf->numrows);
+    int32_t status_len, rstatus_len;
+    if (conf->hex.active) {
+        status_len = snprintf(
+            status, sizeof(status), "%.20s - %lld bytes %s%s", conf->filepath,
+            (long long)conf->hex.size, conf->hex.writable ? "" : "(ro) ",
+            conf->flags.is_dirty ? "(modified)" : "");
+        rstatus_len =
+            snprintf(rstatus, sizeof(rstatus), "[%d/%d] hex | 0x%llx",
+                     conf->buffers.current + 1, conf->buffers.count,
+                     (unsigned long long)conf->hex.cursor);
+    } else {
+        status_len =
+            snprintf(status, sizeof(status), "%.20s - %d lines %s",
+                     conf->filepath ? conf->filepath : "[No Name]",
+                     conf->numrows, conf->flags.is_dirty ? "(modified)" : "");
+        rstatus_len = snprintf(rstatus, sizeof(rstatus), "[%d/%d] %s | %d/%d",
+                               conf->buffers.current + 1, conf->buffers.count,
+                               conf->syntax ? conf->syntax->filetype : "no ft",
+                               conf->cy + 1, conf->numrows);
+    }
 
     if (status_len > conf->screen_cols) status_len = conf->screen_cols;
     ab_append(ab, status, status_len);
@@ -158,7 +248,6 @@ int8_t editor_draw_statusbar(struct EditorConfig *conf, struct ABuf *ab) {
         }
     }
 
-    ab_append(ab, "\r\n", 2);
     ab_append(ab, "\x1b[m", 3);  // returns to normal
 
     return EXIT_SUCCESS;
@@ -185,176 +274,289 @@ static int32_t helper_welcome_screen(struct EditorConfig *conf,
     return EXIT_SUCCESS;
 }
 
-int8_t editor_draw_rows(struct EditorConfig *conf, struct ABuf *ab) {
-    int8_t currently_selecting = 0;
+/*
+    draws screen columns [from, from + cols) of filerow, the gutter is left to
+    the caller. Returns the columns drawn
+*/
+static int32_t editor_draw_text(struct EditorConfig *conf, struct ABuf *ab,
+                                int32_t filerow, int32_t from, int32_t cols,
+                                int8_t *currently_selecting) {
+    struct EditorCursorSelect *sel = &conf->sel;
+    struct Row *row = &conf->rows[filerow];
 
-    for (int32_t y = 0; y < conf->screen_rows; y++) {
-        int32_t filerow = y + conf->rowoff;
+    int32_t rowlen = row->rwidth - from;
+    if (rowlen < 0) rowlen = 0;
+    if (rowlen > cols) rowlen = cols;
+
+    /*
+    s and the hl classes are indexed by render byte i while j counts columns,
+    j + from is the rx. They only drift apart on rows holding glyphs
+    */
+    char *s = row->render;
+    int32_t i = editor_row_rx_ri(row, from);
+
+    // highlighting and control section
+    int32_t current_color = -1;
+    int8_t inverted_color = *currently_selecting;
+
+    // extra cursors on this row, they are sorted by column
+    struct EditorCursorSelect *caret = cursors_find_row(conf, filerow);
+    struct EditorCursorSelect *carets_end =
+        conf->cursors.items + conf->cursors.count;
+    int32_t caret_rx = caret ? editor_update_cx_rx(row, caret->end_col) : -1;
+
+    // int32_t and not int32_t because sel members can be negative
+    int32_t j = 0;
+
+    if (*currently_selecting) {
+        ab_append(ab, "\x1b[7m", 4);  // invert colors
+    }
+
+    // from cut a wide character in half, its visible half stays blank
+    for (; j < editor_row_ri_rx(row, i) - from && j < rowlen; j++)
+        ab_append(ab, " ", 1);
+    int32_t first = j;
+
+    while (j < rowlen && i < row->rsize) {
+        int32_t col = j + from;
+
+        // bytes and columns of the glyph at i
+        int32_t len = 1, width = 1;
+        uint32_t cp;
+        if ((unsigned char)s[i] >= 0x80 &&
+            (len = utf8_decode(&s[i], row->rsize - i, &cp)))
+            width = utf8_width(cp);
+        else
+            len = 1;
+        if (j + width > rowlen) break;
 
         /*
-                if there are no rows then we can safely assume we are in
-                welcome screen
+        if we are encountering selected line OR we are
+        already selecting
         */
-        if (filerow >= conf->numrows) {
-            if (!conf->flags.program_state && conf->numrows == 0 &&
-                y == conf->screen_rows / 3) {
-                helper_welcome_screen(conf, ab);
-            } else {
-                ab_append(ab, "~", 1);
-            }
-        } else {
-            struct EditorCursorSelect *sel = &conf->sel;
-            struct Row *row = &conf->rows[filerow];
+        if ((col == sel->start_col && filerow == sel->start_row) ||
+            (*currently_selecting && j == first)) {
+            ab_append(ab, "\x1b[7m", 4);  // invert colors
+            *currently_selecting = inverted_color = 1;
+        }
 
-            // numline section
-            int32_t filerow_num = row->idx + 1;
-            char offset[16];
-            int32_t offset_size =
-                snprintf(offset, sizeof(offset), "%d ", filerow_num);
+        if (col == sel->end_col && filerow == sel->end_row) {
+            ab_append(ab, "\x1b[m", 3);
+            *currently_selecting = inverted_color = 0;
+        }
 
-            int32_t rowlen = row->rsize - conf->coloff;
-            if (rowlen < 0) rowlen = 0;
-            if (rowlen > conf->screen_cols - offset_size) {
-                rowlen = conf->screen_cols - offset_size;
+        int8_t at_caret = 0;
+        while (caret && caret_rx < col) {
+            caret++;
+            if (caret == carets_end || caret->end_row != filerow) {
+                caret = NULL;
+                break;
             }
+            caret_rx = editor_update_cx_rx(row, caret->end_col);
+        }
+        if ((caret && caret_rx == col) || block_contains(conf, filerow, col)) {
+            ab_append(ab, "\x1b[7m", 4);
+            at_caret = 1;
+        }
 
-            // appending numline to buff
-            char *s = calloc(offset_size + rowlen, sizeof(char));
-            memcpy(s, offset, offset_size);
-            memcpy(s + offset_size, &row->render[conf->coloff], rowlen);
+        if (iscntrl((unsigned char)s[i])) {
+            char sym = (s[i] <= 26) ? '@' + s[i] : '?';
+            ab_append(ab, "\x1b[7m", 4);
+            ab_append(ab, &sym, 1);
 
-            // highlighting and control section
-            unsigned char *hl = &row->hl[conf->coloff];
-            int32_t current_color = -1;
-            int8_t inverted_color = currently_selecting;
+            if (!inverted_color) {
+                ab_append(ab, "\x1b[m", 3);
+            }
 
-            // int32_t and not int32_t because sel members can be negative
-            int32_t j = 0;
+            if (current_color != -1 && !inverted_color) {
+                char buf[16];
+                int32_t clen = snprintf(buf, sizeof(buf), "\x1b[%dm",
+                                        current_color);
+                ab_append(ab, buf, clen);
+            }
 
-            while (j < offset_size) {
-                ab_append(ab, &s[j], 1);
-                j++;
+        } else if (editor_row_hl(row, i) == HL_NORMAL) {
+            if (current_color != -1) {
+                ab_append(ab, "\x1b[39m", 5);  // white color
+                current_color = -1;
             }
+            ab_append(ab, &s[i], len);
 
-            if (currently_selecting) {
-                ab_append(ab, "\x1b[7m", 4);  // invert colors
+        } else {
+            int32_t color =
+                editor_syntax_to_color_row(editor_row_hl(row, i));
+            if (color != current_color && !inverted_color) {
+                current_color = color;
+                char buf[16];
+                int32_t clen = snprintf(buf, sizeof(buf), "\x1b[%dm", color);
+                ab_append(ab, buf, clen);
             }
+            ab_append(ab, &s[i], len);
+        }
 
-            for (; j < rowlen + offset_size; j++) {
-                /*
-                if we are encountering selected line OR we are
-                already selecting
-                */
-                if ((j == sel->start_col && filerow == sel->start_row) ||
-                    (currently_selecting && j == 0)) {
-                    ab_append(ab, "\x1b[7m", 4);  // invert colors
-                    currently_selecting = inverted_color = 1;
-                }
+        if (at_caret && !inverted_color) ab_append(ab, "\x1b[27m", 5);
+        i += len;
+        j += width;
+    }
 
-                if (j == sel->end_col && filerow == sel->end_row) {
-                    ab_append(ab, "\x1b[m", 3);
-                    currently_selecting = inverted_color = 0;
-                }
+    // extra cursor sitting right after the last char
+    if (caret && caret_rx == j + from && j + from == row->rwidth && j < cols) {
+        ab_append(ab, "\x1b[7m \x1b[27m", 10);
+    }
 
-                if (iscntrl(s[j])) {
-                    char sym = (s[j] <= 26) ? '@' + s[j] : '?';
-                    ab_append(ab, "\x1b[7m", 4);
-                    ab_append(ab, &sym, 1);
-
-                    if (!inverted_color) {
-                        ab_append(ab, "\x1b[m", 3);
-                    }
-
-                    if (current_color != -1 && !inverted_color) {
-                        char buf[16];
-                        int32_t clen = snprintf(buf, sizeof(buf), "\x1b[%dm",
-                                                current_color);
-                        ab_append(ab, buf, clen);
-                    }
-
-                } else if (hl[j - offset_size] == HL_NORMAL) {
-                    if (current_color != -1) {
-                        ab_append(ab, "\x1b[39m", 5);  // white color
-                        current_color = -1;
-                    }
-                    ab_append(ab, &s[j], 1);
-
-                } else {
-                    int32_t color =
-                        editor_syntax_to_color_row(hl[j - offset_size]);
-                    if (color != current_color && !inverted_color) {
-                        current_color = color;
-                        char buf[16];
-                        int32_t clen =
-                            snprintf(buf, sizeof(buf), "\x1b[%dm", color);
-                        ab_append(ab, buf, clen);
-                    }
-                    ab_append(ab, &s[j], 1);
-                }
-            }
+    // handle edge case where user is going up/down
+    if ((sel->start_col == j + from && filerow == sel->start_row)) {
+        ab_append(ab, "\x1b[7m", 4);  // invert colors
+        *currently_selecting = inverted_color = 1;
+        ab_append(ab, "\x1b[m", 3);
+    }
 
-            // handle edge case where user is going up/down
-            if ((sel->start_col == rowlen + offset_size &&
-                 filerow == sel->start_row)) {
-                ab_append(ab, "\x1b[7m", 4);  // invert colors
-                currently_selecting = inverted_color = 1;
-                ab_append(ab, "\x1b[m", 3);
-            }
+    /*
+    remove inverted_color in case it is applied because of
+    text selection
+    */
+
+    if (inverted_color) {
+        inverted_color = 0;
+        ab_append(ab, "\x1b[m", 3);
+    }
+    if (j + from == sel->end_col && filerow == sel->end_row) {
+        ab_append(ab, "\x1b[m", 3);
+        *currently_selecting = inverted_color = 0;
+    }
+    return j;
+}
+
+int8_t editor_draw_rows(struct EditorConfig *conf, struct ABuf *ab) {
+    if (conf->hex.active) return hexview_draw_rows(conf, ab);
 
-            free(s);
+    int8_t currently_selecting = 0;
 
-            /*
-            remove inverted_color in case it is applied because of
-            text selection
-            */
+    // views that stop before the right edge can't use erase in line
+    int8_t full_width =
+        conf->screen_left + conf->screen_cols == conf->views.cols;
 
-            if (inverted_color) {
-                inverted_color = 0;
-                ab_append(ab, "\x1b[m", 3);
+    // screen lines are visible lines, folded rows don't take any
+    int32_t top = folds_visible_index(conf, conf->rowoff);
+
+    // when wrapping, rows are walked one segment per screen line instead
+    int8_t wrapping = conf->flags.soft_wrap;
+    int32_t segment = 0;
+    int32_t next = wrapping ? wrap_locate(conf, wrap_screen_top(conf), &segment)
+                            : 0;
+
+    for (int32_t y = 0; y < conf->screen_rows; y++) {
+        int32_t filerow = wrapping ? next : folds_file_row(conf, top + y);
+
+        char pos[32];
+        int32_t pos_len =
+            snprintf(pos, sizeof(pos), "\x1b[%d;%dH",
+                     conf->screen_top + y + 1, conf->screen_left + 1);
+        ab_append(ab, pos, pos_len);
+        if (!full_width) {
+            // erase character, clears the row without moving the cursor
+            pos_len = snprintf(pos, sizeof(pos), "\x1b[%dX", conf->screen_cols);
+            ab_append(ab, pos, pos_len);
+        }
+
+        /*
+                if there are no rows then we can safely assume we are in
+                welcome screen
+        */
+        if (filerow >= conf->numrows) {
+            if (!conf->flags.program_state && conf->numrows == 0 &&
+                y == conf->screen_rows / 3) {
+                helper_welcome_screen(conf, ab);
+            } else {
+                ab_append(ab, "~", 1);
             }
-            if (j == sel->end_col && filerow == sel->end_row) {
-                ab_append(ab, "\x1b[m", 3);
-                currently_selecting = inverted_color = 0;
+        } else if (wrapping) {
+            struct Row *row = &conf->rows[filerow];
+            int32_t start = wrap_segment_start(row, segment);
+
+            // continuation lines leave the gutter blank
+            if (segment == 0) {
+                gutter_draw_row(conf, ab, filerow);
+            } else {
+                for (int32_t i = 0; i < conf->gutter.width; i++)
+                    ab_append(ab, " ", 1);
+            }
+
+            int32_t rowlen =
+                editor_draw_text(conf, ab, filerow, start,
+                                 wrap_segment_end(row, segment) - start,
+                                 &currently_selecting);
+
+            if (segment == row->nbreaks) {
+                folds_draw_header(conf, ab, filerow,
+                                  gutter_text_cols(conf) - rowlen);
+                next = folds_next(conf, filerow, 1);
+                segment = 0;
+            } else {
+                segment++;
             }
             ab_append(ab, "\x1b[39m", 5);  // reset to default color
+        } else {
+            gutter_draw_row(conf, ab, filerow);
+
+            int32_t text_cols = gutter_text_cols(conf);
+            int32_t rowlen = editor_draw_text(conf, ab, filerow, conf->coloff,
+                                              text_cols, &currently_selecting);
+            folds_draw_header(conf, ab, filerow, text_cols - rowlen);
+            ab_append(ab, "\x1b[39m", 5);  // reset to default color
         }
-        ab_append(ab, "\x1b[K", 4);  // erase in line command
-        ab_append(ab, "\r\n", 2);
+        if (full_width) ab_append(ab, "\x1b[K", 3);  // erase in line command
     }
 
     return EXIT_SUCCESS;
 }
 
 int8_t editor_scroll(struct EditorConfig *conf) {
+    if (conf->hex.active) return hexview_scroll(conf);
     if (conf->numrows == 0) return EXIT_FAILURE;
 
-    if (conf->flags.resize_needed) {
-        term_get_window_size(conf, &conf->screen_rows, &conf->screen_cols);
-        conf->flags.resize_needed = 0;
+    // a fold closed from another view may have swallowed the cursor
+    int32_t fold = folds_hidden(conf, conf->cy);
+    if (fold != -1) {
+        conf->cy = conf->folds.items[fold].start;
+        conf->cx = min(conf->cx, conf->rows[conf->cy].size);
     }
 
-    struct Row *row = &conf->rows[conf->cy];
-    int32_t numline_offset = editor_row_numline_calculate(row);
-
-    conf->rx = conf->cx;
+    conf->rx = 0;
     if (conf->cy < conf->numrows) {
-        conf->rx = editor_update_cx_rx(&conf->rows[conf->cy],
-                                       conf->cx - numline_offset) +
-                   numline_offset;
+        conf->rx = editor_update_cx_rx(&conf->rows[conf->cy], conf->cx);
+    }
+
+    // rows never scroll sideways when wrapped, coloff is the first segment
+    // of rowoff on screen instead
+    if (conf->flags.soft_wrap) {
+        int32_t cy = wrap_visual_line(conf, conf->cy, conf->rx);
+        int32_t top = wrap_screen_top(conf);
+        if (cy < top) {
+            top = cy;
+        } else if (cy >= top + conf->screen_rows) {
+            top = cy - conf->screen_rows + 1;
+        }
+        conf->rowoff = wrap_locate(conf, top, &conf->coloff);
+        return EXIT_SUCCESS;
     }
 
-    // Horizontal scrolling
-    if (conf->rx < conf->coloff + numline_offset) {
-        conf->coloff = conf->rx - numline_offset;
-    } else if (conf->rx >= conf->screen_cols + conf->coloff) {
-        conf->coloff = conf->rx - conf->screen_cols + 1;
+    // Horizontal scrolling, the gutter is not part of the text columns
+    int32_t text_cols = gutter_text_cols(conf);
+    if (conf->rx < conf->coloff) {
+        conf->coloff = conf->rx;
+    } else if (conf->rx >= text_cols + conf->coloff) {
+        conf->coloff = conf->rx - text_cols + 1;
     }
 
-    // Vertical scrolling
-    if (conf->cy < conf->rowoff) {
-        conf->rowoff = conf->cy;
-    } else if (conf->cy >= conf->rowoff + conf->screen_rows) {
-        conf->rowoff = conf->cy - conf->screen_rows + 1;
+    // Vertical scrolling counts visible lines, folded rows are skipped
+    int32_t cy = folds_visible_index(conf, conf->cy);
+    int32_t top = folds_visible_index(conf, conf->rowoff);
+    if (cy < top) {
+        top = cy;
+    } else if (cy >= top + conf->screen_rows) {
+        top = cy - conf->screen_rows + 1;
     }
+    conf->rowoff = folds_file_row(conf, top);
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include "replay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "config.h"
+#include "core.h"
+#include "input.h"
+#include "render.h"
+#include "terminal.h"
+#include "views.h"
+#include "vterm.h"
+
+// latencies of keys or frames, in nanoseconds
+struct ReplaySamples {
+    int64_t* items;
+    int32_t count;
+    int32_t cap;
+};
+
+static struct Replay {
+    FILE* record;  // SCOOM_RECORD target, NULL when not recording
+    struct timespec record_start;
+
+    FILE* source;     // SCOOM_REPLAY recording, NULL when not replaying
+    int64_t clock;    // usec the last chunk arrived at
+    int64_t next_at;  // usec of the next chunk, -1 once there is none
+    int32_t next_len;  // bytes of it not handed out yet
+
+    struct ReplaySamples keys;
+    struct ReplaySamples frames;
+    struct timespec started;
+} replay = {NULL, {0, 0}, NULL, 0, -1, 0, {NULL, 0, 0}, {NULL, 0, 0}, {0, 0}};
+
+static int64_t replay_since_ns(const struct timespec* since) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)(now.tv_sec - since->tv_sec) * 1000000000 +
+           (now.tv_nsec - since->tv_nsec);
+}
+
+static void replay_sample(struct ReplaySamples* samples, int64_t ns) {
+    if (samples->count == samples->cap) {
+        samples->cap = samples->cap ? samples->cap * 2 : 1024;
+        samples->items =
+            realloc(samples->items, sizeof(int64_t) * samples->cap);
+        if (!samples->items) die("replay samples realloc failed");
+    }
+    samples->items[samples->count++] = ns;
+}
+
+int8_t replay_record_start(struct EditorConfig* conf, const char* path) {
+    replay.record = fopen(path, "w");
+    if (!replay.record) return EXIT_FAILURE;
+
+    // the message bar row is part of the terminal
+    fprintf(replay.record, "%s %d %d\n", REPLAY_MAGIC, conf->views.rows + 1,
+            conf->views.cols);
+    clock_gettime(CLOCK_MONOTONIC, &replay.record_start);
+    return EXIT_SUCCESS;
+}
+
+int8_t replay_record_stop(void) {
+    if (!replay.record) return EXIT_FAILURE;
+    fclose(replay.record);
+    replay.record = NULL;
+    return EXIT_SUCCESS;
+}
+
+void replay_record(const unsigned char* bytes, int32_t len) {
+    if (!replay.record || len <= 0) return;
+
+    fprintf(replay.record, "%lld %d\n",
+            (long long)(replay_since_ns(&replay.record_start) / 1000), len);
+    fwrite(bytes, 1, len, replay.record);
+    fputc('\n', replay.record);
+}
+
+// reads the header of the next chunk, its bytes are read as they are asked
+static void replay_next(void) {
+    long long at;
+    replay.next_at = -1;
+    if (fscanf(replay.source, "%lld %d", &at, &replay.next_len) != 2) return;
+    // exactly one newline, the bytes may start with whitespace themselves
+    if (fgetc(replay.source) != '\n' || replay.next_len < 0) return;
+    replay.next_at = at;
+}
+
+int8_t replay_open(const char* path) {
+    replay.source = fopen(path, "r");
+    if (!replay.source) return EXIT_FAILURE;
+
+    char magic[32];
+    int32_t rows, cols;
+    if (!fgets(magic, sizeof(magic), replay.source) ||
+        strncmp(magic, REPLAY_MAGIC, strlen(REPLAY_MAGIC)) != 0 ||
+        sscanf(magic + strlen(REPLAY_MAGIC), "%d %d", &rows, &cols) != 2) {
+        fclose(replay.source);
+        replay.source = NULL;
+        return EXIT_FAILURE;
+    }
+
+    if (vterm_create(rows, cols) == EXIT_FAILURE) {
+        fclose(replay.source);
+        replay.source = NULL;
+        return EXIT_FAILURE;
+    }
+    term_set_backend(&term_vterm);
+    replay_next();
+    return EXIT_SUCCESS;
+}
+
+int8_t replay_active(void) { return replay.source != NULL; }
+
+static int replay_compare(const void* a, const void* b) {
+    int64_t x = *(const int64_t*)a, y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void replay_print(const char* name, struct ReplaySamples* samples) {
+    if (!samples->count) return;
+
+    qsort(samples->items, samples->count, sizeof(int64_t), replay_compare);
+    int32_t n = samples->count;
+    printf("%-6s %8d  p50 %9.1fus  p99 %9.1fus  max %9.1fus\n", name, n,
+           samples->items[(n - 1) * 50 / 100] / 1000.0,
+           samples->items[(n - 1) * 99 / 100] / 1000.0,
+           samples->items[n - 1] / 1000.0);
+}
+
+static void replay_finish(void) {
+    double seconds = replay_since_ns(&replay.started) / 1e9;
+
+    printf("replay: %d keys and %d frames in %.3fs, %.0f keys/s\n",
+           replay.keys.count, replay.frames.count, seconds,
+           seconds > 0 ? replay.keys.count / seconds : 0);
+    replay_print("keys", &replay.keys);
+    replay_print("frames", &replay.frames);
+
+    const struct VTermStats* stats = vterm_stats();
+    printf("terminal: %lld bytes, %lld sequences, %lld unknown\n",
+           (long long)stats->bytes, (long long)stats->sequences,
+           (long long)stats->unknown);
+
+    // the screen the replay ended on, to diff against a known good one
+    const char* screen = getenv("SCOOM_REPLAY_SCREEN");
+    if (screen && vterm_dump(screen) == EXIT_FAILURE)
+        printf("couldn't write the screen to %s\n", screen);
+
+    free(replay.keys.items);
+    free(replay.frames.items);
+    fclose(replay.source);
+    replay.source = NULL;
+    vterm_destroy();
+}
+
+int32_t replay_read(unsigned char* buf, int32_t cap, int32_t timeout_ms) {
+    if (replay.next_at == -1) return -1;
+
+    // a real poll would have given up before the chunk arrived
+    if (timeout_ms != -1 && replay.next_at - replay.clock > timeout_ms * 1000) {
+        replay.clock += timeout_ms * 1000;
+        return 0;
+    }
+    if (replay.next_at > replay.clock) replay.clock = replay.next_at;
+
+    int32_t n = replay.next_len < cap ? replay.next_len : cap;
+    if (fread(buf, 1, n, replay.source) != (size_t)n)
+        die("replay chunk is truncated");
+
+    replay.next_len -= n;
+    if (replay.next_len == 0) {
+        fgetc(replay.source);  // newline closing the chunk
+        replay_next();
+    }
+    return n;
+}
+
+int8_t replay_run(struct EditorConfig* conf) {
+    clock_gettime(CLOCK_MONOTONIC, &replay.started);
+    struct timespec start;
+
+    // same batching as editor_on_input and loop_run, the first frame included
+    int8_t running = 1;
+    while (running) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        editor_refresh_screen(conf);
+        replay_sample(&replay.frames, replay_since_ns(&start));
+
+        do {
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            int8_t result = editor_process_key_press(conf);
+            replay_sample(&replay.keys, replay_since_ns(&start));
+
+            // quitting or running out of input, which reads as a hangup
+            if (result == EXIT_LOOP_CODE) running = 0;
+        } while (running && editor_key_pending(conf));
+    }
+
+    replay_finish();
+    return EXIT_SUCCESS;
+}
@@ -4,16 +4,27 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "alloc.h"
+#include "arena.h"
 #include "config.h"
 #include "core.h"
 #include "file.h"
+#include "folds.h"
+#include "gutter.h"
 #include "highlight.h"
+#include "journal.h"
 #include "terminal.h"
+#include "utf8.h"
+#include "wrap.h"
 
-int8_t editor_free_row(struct Row* row) {
-    free(row->chars);
-    free(row->render);
-    free(row->hl);
+_Static_assert(sizeof(struct Row) <= 64, "struct Row outgrew a cache line");
+
+int8_t editor_free_row(struct EditorConfig* conf, struct Row* row) {
+    arena_free(conf->arena, row->chars);
+    if (!row->render_shared) arena_free(conf->arena, row->render);
+    arena_free(conf->arena, row->hl);
+    arena_free(conf->arena, row->glyphs);
+    arena_free(conf->arena, row->breaks);
     return EXIT_SUCCESS;
 }
 
@@ -21,9 +32,7 @@ int8_t editor_insert_row_char(struct EditorConfig* conf, struct Row* row,
                               int32_t at, int32_t c) {
     if (at < 0 || at > row->size) return EXIT_FAILURE;
     // n stands for new for now
-    char* new_chars = realloc(row->chars, row->size + 2);
-    if (!new_chars) die("new_chars realloc failed");
-    row->chars = new_chars;
+    row->chars = arena_realloc(conf->arena, row->chars, row->size + 2);
 
     memmove(row->chars + at + 1, row->chars + at, row->size - at);
     row->chars[at] = c;
@@ -43,7 +52,6 @@ int8_t editor_delete_row_char(struct EditorConfig* conf, struct Row* row,
     memmove(&row->chars[at], &row->chars[at + 1], row->size - at - 1);
     row->size--;
 
-    row->chars = realloc(row->chars, row->size + 1);
     row->chars[row->size] = '\0';
 
     if (editor_update_row(conf, row) == EXIT_FAILURE)
@@ -59,44 +67,55 @@ int8_t editor_insert_row(struct EditorConfig* conf, int32_t at,
                          const char* content, int32_t content_len) {
     if (at < 0 || at > conf->numrows) return EXIT_FAILURE;
 
-    conf->rows = realloc(conf->rows, sizeof(struct Row) * (conf->numrows + 1));
+    conf->rows = arena_realloc(conf->arena, conf->rows,
+                               sizeof(struct Row) * (conf->numrows + 1));
 
     memmove(&conf->rows[at + 1], &conf->rows[at],
             sizeof(struct Row) * (conf->numrows - at));
 
-    for (int32_t j = at + 1; j <= conf->numrows; j++) {
-        conf->rows[j].idx++;
-    }
-
     struct Row* row = &conf->rows[at];
 
-    row->idx = at;
     row->size = content_len;
-    row->chars = calloc(content_len + 1, sizeof(char));
+    row->chars = arena_alloc(conf->arena, content_len + 1);
 
-    // copy spaces if any
     // copy the content
     memcpy(row->chars, content, content_len);
 
     row->chars[content_len] = '\0';
     row->render = NULL;
+    row->render_shared = 0;
     row->rsize = 0;
     row->hl = NULL;
+    row->glyphs = NULL;
+    row->breaks = NULL;
+    row->nbreaks = 0;
+    row->wrap_width = 0;
     row->hl_open_comment = 0;
+    row->marker = GUTTER_MARK_ADDED;
 
     conf->numrows++;
+    folds_shift(conf, at, 1);
+    wrap_invalidate(conf);
 
     conf->flags.is_dirty = 1;
-    if (editor_update_row(conf, &conf->rows[at]) == EXIT_FAILURE)
-        die("editor update row failed");
+    journal_log_insert(conf, at, content, content_len);
+    if (editor_retab_row(conf, row) == EXIT_FAILURE)
+        die("editor retab row failed");
 
     return EXIT_SUCCESS;
 }
 
-int8_t editor_update_row(struct EditorConfig* conf, struct Row* row) {
-    free(row->render);
+// rebuilds row->render and row->glyphs from row->chars, highlighting is left
+// to the caller. chars may have been reallocated already, so a shared render
+// is never touched
+static int8_t editor_render_row(struct EditorConfig* conf, struct Row* row) {
+    if (!row->render_shared) arena_free(conf->arena, row->render);
+    arena_free(conf->arena, row->glyphs);
+    row->glyphs = NULL;
+    row->render_shared = 0;
+
+    int32_t tab_size = conf->tab_size;
     int32_t tabs = 0;
-    int32_t n = 0;
 
     // first we need to check how much memory to allocate for the renderer
     for (int32_t j = 0; j < row->size; j++) {
@@ -106,46 +125,219 @@ int8_t editor_update_row(struct EditorConfig* conf, struct Row* row) {
         }
     }
 
-    row->indentation = tabs;
+    // plain ASCII rows, by far the common case, skip decoding altogether
+    int8_t ascii = utf8_is_ascii(row->chars, row->size);
+    int32_t glyphs = tabs;
+    if (!ascii) {
+        for (int32_t j = 0; j < row->size; j++) {
+            if ((unsigned char)row->chars[j] >= 0xC0) glyphs++;
+        }
+    }
+
+    // nothing to expand, render is chars byte for byte
+    if (ascii && !tabs) {
+        row->render = row->chars;
+        row->render_shared = 1;
+        row->rsize = row->rwidth = row->size;
+        row->nglyphs = 0;
+        row->wrap_width = 0;
+        return EXIT_SUCCESS;
+    }
 
-    /* TAB_SIZE - 1:
+    /* tab_size - 1:
         Because the tab is already counted as 1 character in row->size
     */
-    row->render = malloc(row->size + tabs * (TAB_SIZE - 1) + 1);
-    if (!row->render) die("row render malloc failed");
+    row->render =
+        arena_alloc(conf->arena, row->size + tabs * (tab_size - 1) + 1);
+
+    if (glyphs)
+        row->glyphs =
+            arena_alloc(conf->arena, sizeof(struct RowGlyph) * glyphs);
+
+    int32_t n = 0, col = 0, k = 0;
+    for (int32_t j = 0; j < row->size;) {
+        char c = row->chars[j];
+        uint32_t cp;
+        int32_t len;
 
-    for (int32_t j = 0; j < row->size; j++) {
         /*
                 If a tab is encountered:
-                - keep adding spaces until n is divisible by TAB_SIZE macro
+                - keep adding spaces until the column is divisible by
+                  tab_size
         */
-        if (row->chars[j] == '\t') {
-            row->render[n++] = ' ';
-            while (n % TAB_SIZE != 0) {
-                row->render[n++] = ' ';
-            }
+        if (c == '\t') {
+            struct RowGlyph* glyph = &row->glyphs[k++];
+            int32_t width = tab_size - col % tab_size;
+            glyph->cx = j;
+            glyph->ri = n;
+            glyph->rx = col;
+            glyph->len = 1;
+            glyph->rlen = glyph->width = width;
+
+            memset(&row->render[n], ' ', width);
+            n += width;
+            col += width;
+            j++;
+        } else if (ascii || (unsigned char)c < 0x80 ||
+                   !(len = utf8_decode(&row->chars[j], row->size - j, &cp))) {
+            // malformed bytes show up as one '?' each
+            row->render[n++] = (unsigned char)c < 0x80 ? c : '?';
+            col++;
+            j++;
         } else {
-            row->render[n++] = row->chars[j];
+            struct RowGlyph* glyph = &row->glyphs[k++];
+            glyph->cx = j;
+            glyph->ri = n;
+            glyph->rx = col;
+            glyph->len = glyph->rlen = len;
+            glyph->width = utf8_width(cp);
+
+            memcpy(&row->render[n], &row->chars[j], len);
+            n += len;
+            col += glyph->width;
+            j += len;
         }
     }
 
+    row->nglyphs = k;
     row->rsize = n;
+    row->rwidth = col;
     row->render[n] = '\0';
+    row->wrap_width = 0;
+
+    return EXIT_SUCCESS;
+}
+
+int8_t editor_insert_rows(struct EditorConfig* conf, int32_t at,
+                          const char** lines, const int32_t* lens,
+                          int32_t count) {
+    if (at < 0 || at > conf->numrows || count < 0) return EXIT_FAILURE;
+    if (count == 0) return EXIT_SUCCESS;
+
+    conf->rows = arena_realloc(conf->arena, conf->rows,
+                               sizeof(struct Row) * (conf->numrows + count));
+
+    // one shift for the whole block instead of one per inserted line
+    memmove(&conf->rows[at + count], &conf->rows[at],
+            sizeof(struct Row) * (conf->numrows - at));
+
+    for (int32_t i = 0; i < count; i++) {
+        struct Row* row = &conf->rows[at + i];
+
+        row->size = lens[i];
+        row->chars = arena_alloc(conf->arena, lens[i] + 1);
+
+        memcpy(row->chars, lines[i], lens[i]);
+        row->chars[lens[i]] = '\0';
+
+        row->render = NULL;
+        row->render_shared = 0;
+        row->rsize = 0;
+        row->hl = NULL;
+        row->glyphs = NULL;
+        row->breaks = NULL;
+        row->nbreaks = 0;
+        row->wrap_width = 0;
+        row->hl_open_comment = 0;
+        row->marker = GUTTER_MARK_ADDED;
 
+        journal_log_insert(conf, at + i, lines[i], lens[i]);
+        editor_render_row(conf, row);
+    }
+
+    conf->numrows += count;
+    folds_shift(conf, at, count);
+    wrap_invalidate(conf);
+    conf->flags.is_dirty = 1;
+
+    // highlighting is deferred until the whole block is in place
+    if (editor_update_syntax_range(conf, at, at + count) == EXIT_FAILURE)
+        die("editor update syntax range failed");
+
+    return EXIT_SUCCESS;
+}
+
+int32_t editor_split_lines(const char* text, int64_t len, const char*** lines,
+                           int32_t** lens) {
+    int32_t count = 0;
+    for (int64_t i = 0; i < len; i++) {
+        if (text[i] == '\n') count++;
+    }
+    if (len > 0 && text[len - 1] != '\n') count++;
+
+    *lines = malloc(sizeof(char*) * max(count, 1));
+    *lens = malloc(sizeof(int32_t) * max(count, 1));
+    if (!*lines || !*lens) die("lines malloc failed");
+
+    int32_t n = 0;
+    const char* start = text;
+    for (int64_t i = 0; i <= len; i++) {
+        if (i < len && text[i] != '\n') continue;
+        if (i == len && &text[i] == start) break;
+
+        int32_t line_len = &text[i] - start;
+        while (line_len > 0 && start[line_len - 1] == '\r') line_len--;
+
+        (*lines)[n] = start;
+        (*lens)[n++] = line_len;
+        start = &text[i + 1];
+    }
+
+    return n;
+}
+
+int8_t editor_update_row(struct EditorConfig* conf, struct Row* row) {
+    if (row->marker == GUTTER_MARK_NONE) row->marker = GUTTER_MARK_CHANGED;
+    journal_log_set(conf, row - conf->rows, row->chars, row->size);
+    editor_render_row(conf, row);
     editor_update_syntax(conf, row);
+    wrap_update_row(conf, row);
+    return EXIT_SUCCESS;
+}
+
+int8_t editor_retab_row(struct EditorConfig* conf, struct Row* row) {
+    editor_render_row(conf, row);
+    editor_update_syntax(conf, row);
+    wrap_update_row(conf, row);
     return EXIT_SUCCESS;
 }
 
 int8_t editor_delete_row(struct EditorConfig* conf, int32_t at) {
-    if (at < 0 || at > conf->numrows) return EXIT_FAILURE;
-    if (editor_free_row(&conf->rows[at]) == EXIT_FAILURE)
+    if (at < 0 || at >= conf->numrows) return EXIT_FAILURE;
+    journal_log_delete(conf, at, 1);
+    if (editor_free_row(conf, &conf->rows[at]) == EXIT_FAILURE)
         die("editor free row failed");
     memmove(&conf->rows[at], &conf->rows[at + 1],
             sizeof(struct Row) * (conf->numrows - at - 1));
-    for (int32_t j = at; j < conf->numrows - 1; j++) conf->rows[j].idx--;
 
     if (conf->numrows != 0) conf->numrows--;
-    conf->rows = realloc(conf->rows, sizeof(struct Row) * conf->numrows);
+    folds_shift(conf, at, -1);
+    wrap_invalidate(conf);
+    conf->flags.is_dirty = 1;
+    return EXIT_SUCCESS;
+}
+
+int8_t editor_delete_rows(struct EditorConfig* conf, int32_t at,
+                          int32_t count) {
+    if (at < 0 || count < 0 || at + count > conf->numrows) return EXIT_FAILURE;
+    if (count == 0) return EXIT_SUCCESS;
+
+    journal_log_delete(conf, at, count);
+    for (int32_t i = at; i < at + count; i++) {
+        if (editor_free_row(conf, &conf->rows[i]) == EXIT_FAILURE)
+            die("editor free row failed");
+    }
+
+    // one shift for the whole block, like editor_insert_rows
+    memmove(&conf->rows[at], &conf->rows[at + count],
+            sizeof(struct Row) * (conf->numrows - at - count));
+    conf->numrows -= count;
+    folds_shift(conf, at, -count);
+    wrap_invalidate(conf);
+
+    // the row now at `at` follows a different one, its comment state may too
+    if (at < conf->numrows) editor_update_syntax(conf, &conf->rows[at]);
+
     conf->flags.is_dirty = 1;
     return EXIT_SUCCESS;
 }
@@ -154,14 +346,9 @@ int8_t editor_insert_char(struct EditorConfig* conf, int32_t c) {
     if (conf->cy == conf->numrows)
         editor_insert_row(conf, conf->numrows, "", 0);
 
-    int32_t numline_offset =
-        editor_row_numline_calculate(&conf->rows[conf->cy]);
-
     conf->flags.is_dirty = 1;
-    // got to make sure res is correctly calculated because cx could
-    // accidentally touch the numbers part
-    int8_t res = editor_insert_row_char(conf, &conf->rows[conf->cy],
-                                        conf->cx - numline_offset, c);
+    int8_t res =
+        editor_insert_row_char(conf, &conf->rows[conf->cy], conf->cx, c);
     conf->cx++;
     return res;
 }
@@ -169,16 +356,12 @@ int8_t editor_insert_char(struct EditorConfig* conf, int32_t c) {
 int8_t editor_delete_char(struct EditorConfig* conf) {
     if (conf->numrows == 0) return EXIT_FAILURE;
 
-    int32_t numline_offset =
-        editor_row_numline_calculate(&conf->rows[conf->cy]);
-
     // make sure we're not at end of file or at beginning of first line
-    if (conf->cy == conf->numrows ||
-        (conf->cx == numline_offset && conf->cy == 0))
+    if (conf->cy == conf->numrows || (conf->cx == 0 && conf->cy == 0))
         return EXIT_FAILURE;
 
-    if (conf->cx > numline_offset) {
-        int32_t at = conf->cx - numline_offset;
+    if (conf->cx > 0) {
+        int32_t at = conf->cx;
         struct Row* row = &conf->rows[conf->cy];
         char currchar = row->chars[at - 1];
         // handle automated paranthesis removal
@@ -191,13 +374,17 @@ int8_t editor_delete_char(struct EditorConfig* conf) {
             }
         }
 
-        int32_t res =
-            editor_delete_row_char(conf, &conf->rows[conf->cy], at - 1);
-        if (conf->cx != numline_offset) conf->cx--;
+        // a multibyte character and its combining marks go as a whole
+        int32_t prev = editor_row_prev_cx(row, at);
+        int32_t res = EXIT_SUCCESS;
+        while (at > prev && res == EXIT_SUCCESS) {
+            res = editor_delete_row_char(conf, &conf->rows[conf->cy], --at);
+            conf->cx--;
+        }
 
         return res;
     } else {
-        conf->cx = conf->rows[conf->cy - 1].size + numline_offset;
+        conf->cx = conf->rows[conf->cy - 1].size;
         if (editor_row_append_string(conf, &conf->rows[conf->cy - 1],
                                      conf->rows[conf->cy].chars,
                                      conf->rows[conf->cy].size) == EXIT_FAILURE)
@@ -206,7 +393,7 @@ int8_t editor_delete_char(struct EditorConfig* conf) {
             die("editor delete row operation failed");
         conf->cy--;
     }
-    return EXIT_FAILURE;
+    return EXIT_SUCCESS;
 }
 
 int8_t editor_rows_to_string(struct EditorConfig* conf, char** result,
@@ -224,7 +411,7 @@ int8_t editor_rows_to_string(struct EditorConfig* conf, char** result,
     if (total_size == 0) return EXIT_FAILURE;
 
     *result_size = total_size;
-    char* file_data = malloc(total_size + 1);
+    char* file_data = alloc_malloc(total_size + 1);
     if (!file_data) return -1;
 
     char* curr_ptr = file_data;
@@ -248,6 +435,8 @@ int8_t editor_rows_to_string(struct EditorConfig* conf, char** result,
 }
 
 int8_t editor_string_to_rows(struct EditorConfig* conf, char* buffer) {
+    // rebuilding every row is cheaper to journal as a fresh snapshot
+    journal_log_reset(conf);
     if (conf_destroy_rows(conf) == EXIT_FAILURE)
         die("conf destroy rows operation failed");
 
@@ -273,13 +462,14 @@ int8_t editor_string_to_rows(struct EditorConfig* conf, char* buffer) {
     }
 
     conf->numrows = index;
+    gutter_clear_markers(conf);
 
     return EXIT_SUCCESS;
 }
 
 int8_t editor_row_append_string(struct EditorConfig* conf, struct Row* row,
                                 char* s, int32_t slen) {
-    row->chars = realloc(row->chars, row->size + slen + 1);
+    row->chars = arena_realloc(conf->arena, row->chars, row->size + slen + 1);
     memcpy(&row->chars[row->size], s, slen);
     row->size += slen;
     row->chars[row->size] = '\0';
@@ -290,23 +480,135 @@ int8_t editor_row_append_string(struct EditorConfig* conf, struct Row* row,
 }
 
 int32_t editor_update_cx_rx(struct Row* row, int32_t cx) {
-    int32_t rx = 0;
+    if (!row) return 0;
+    if (cx > row->size) cx = row->size;
+    if (cx <= 0) return 0;
+
+    // k = number of glyphs starting before cx
+    int32_t lo = 0, hi = row->nglyphs;
+    while (lo < hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if (row->glyphs[mid].cx < cx)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
 
-    for (int32_t j = 0; j < cx; j++) {
-        if (j < row->size) {
-            if (row->chars[j] == '\t') {
-                rx += (TAB_SIZE - 1) - (rx % TAB_SIZE);
-            }
-            rx++;
-        }
+    if (lo == 0) return cx;
+
+    struct RowGlyph* glyph = &row->glyphs[lo - 1];
+    if (cx < glyph->cx + glyph->len) return glyph->rx;
+    return glyph->rx + glyph->width + (cx - glyph->cx - glyph->len);
+}
+
+// number of glyphs ending at or before column rx
+static int32_t editor_glyphs_before_rx(const struct Row* row, int32_t rx) {
+    int32_t lo = 0, hi = row->nglyphs;
+    while (lo < hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if (row->glyphs[mid].rx + row->glyphs[mid].width <= rx)
+            lo = mid + 1;
+        else
+            hi = mid;
     }
-    return rx;
+    return lo;
+}
+
+int32_t editor_row_ri_rx(struct Row* row, int32_t ri) {
+    if (ri <= 0) return 0;
+
+    int32_t lo = 0, hi = row->nglyphs;
+    while (lo < hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if (row->glyphs[mid].ri < ri)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo == 0) return ri;
+
+    // tab expansions are plain spaces, one byte per column
+    struct RowGlyph* glyph = &row->glyphs[lo - 1];
+    if (ri < glyph->ri + glyph->rlen) {
+        if (row->chars[glyph->cx] == '\t') return glyph->rx + ri - glyph->ri;
+        return glyph->rx;
+    }
+    return glyph->rx + glyph->width + (ri - glyph->ri - glyph->rlen);
+}
+
+int32_t editor_row_rx_ri(struct Row* row, int32_t rx) {
+    if (rx <= 0) return 0;
+
+    int32_t k = editor_glyphs_before_rx(row, rx);
+    struct RowGlyph* glyph = k ? &row->glyphs[k - 1] : NULL;
+    int32_t ri = glyph ? glyph->ri + glyph->rlen +
+                             (rx - glyph->rx - glyph->width)
+                       : rx;
+
+    // rx landed inside the next glyph, only a tab can be split
+    glyph = k < row->nglyphs ? &row->glyphs[k] : NULL;
+    if (glyph && ri > glyph->ri && row->chars[glyph->cx] != '\t')
+        ri = glyph->ri + glyph->rlen;
+
+    return ri > row->rsize ? row->rsize : ri;
+}
+
+// zero width code points stick to the character before them
+static int8_t editor_row_combining(struct Row* row, int32_t cx) {
+    uint32_t cp;
+    if ((unsigned char)row->chars[cx] < 0x80) return 0;
+    return utf8_decode(&row->chars[cx], row->size - cx, &cp) &&
+           utf8_width(cp) == 0;
+}
+
+int32_t editor_row_next_cx(struct Row* row, int32_t cx) {
+    if (cx >= row->size) return row->size;
+
+    do {
+        uint32_t cp;
+        int32_t len = utf8_decode(&row->chars[cx], row->size - cx, &cp);
+        cx += len ? len : 1;
+    } while (cx < row->size && editor_row_combining(row, cx));
+
+    return cx;
+}
+
+int32_t editor_row_prev_cx(struct Row* row, int32_t cx) {
+    if (cx > row->size) cx = row->size;
+
+    while (cx > 0) {
+        int32_t start = cx - 1;
+        while (start > 0 && cx - start < UTF8_MAX_BYTES &&
+               utf8_is_continuation(row->chars[start]))
+            start--;
+
+        // a lead byte that doesn't reach cx leaves a stray byte behind it
+        uint32_t cp;
+        if (utf8_decode(&row->chars[start], row->size - start, &cp) !=
+            cx - start)
+            start = cx - 1;
+
+        cx = start;
+        if (!editor_row_combining(row, cx)) break;
+    }
+    return cx;
+}
+
+int32_t editor_row_indentation(const struct Row* row) {
+    if (!row->glyphs) return 0;
+
+    // every tab is a glyph, so only glyphs need a look
+    int32_t tabs = 0;
+    for (int32_t k = 0; k < row->nglyphs; k++)
+        if (row->chars[row->glyphs[k].cx] == '\t') tabs++;
+    return tabs;
 }
 
 int8_t editor_row_indent(struct EditorConfig* conf, struct Row* row,
                          char** data, int32_t* len) {
-    int32_t numline_offset = editor_row_numline_calculate(row);
-    int32_t indent = row->indentation;  // modified indentation (if needed)
+    // modified indentation (if needed)
+    int32_t indent = editor_row_indentation(row);
 
     if (conf->syntax) {
         char language_indent_start = conf->syntax->indent_start;
@@ -319,10 +621,10 @@ int8_t editor_row_indent(struct EditorConfig* conf, struct Row* row,
 
         // stack will work great to know if an indentation is essential
 
-        Stack* s = malloc(sizeof(Stack));
-        stack_create(s, NULL, free);
+        Stack* s = alloc_malloc(sizeof(Stack));
+        stack_create(s, NULL, alloc_free);
 
-        for (int32_t i = 0; i < conf->cx - numline_offset; i++) {
+        for (int32_t i = 0; i < conf->cx; i++) {
             int32_t c = row->chars[i];
 
             if (c == '"' && (i == 0 || row->chars[i - 1] != '\\')) {
@@ -334,22 +636,22 @@ int8_t editor_row_indent(struct EditorConfig* conf, struct Row* row,
                 // handle languages who indent with closing brackets
                 if (language_indent_end) {
                     if (c == language_indent_start) {
-                        data = strdup(buf_indent_start);
+                        data = alloc_strdup(buf_indent_start);
                         stack_push(s, data);
                     } else if (c == language_indent_end) {
                         char* peaked = stack_peek(s);
-                        void* ptr;
+                        void* ptr = NULL;
                         if (peaked && strcmp(peaked, buf_indent_start) == 0) {
                             stack_pop(s, &ptr);
-                            free(ptr);
+                            alloc_free(ptr);
                         } else {
-                            data = strdup(buf_indent_end);
+                            data = alloc_strdup(buf_indent_end);
                             stack_push(s, data);
                         }
                     }
                 } else {
                     if (c == language_indent_start) {
-                        data = strdup(buf_indent_start);
+                        data = alloc_strdup(buf_indent_start);
                         stack_push(s, data);
                     }
                 }
@@ -369,13 +671,13 @@ int8_t editor_row_indent(struct EditorConfig* conf, struct Row* row,
         }
 
         stack_destroy(s);
-        free(s);
+        alloc_free(s);
     }
 
     indent = indent < 0 ? 0 : indent;  // verify it's not less than 0
 
-    int32_t remainder_len = row->size - conf->cx + numline_offset;
-    char* remainder = &row->chars[conf->cx - numline_offset];
+    int32_t remainder_len = row->size - conf->cx;
+    char* remainder = &row->chars[conf->cx];
 
     char* newline = malloc(remainder_len + indent + 1);
     if (!newline) die("malloc for newline failed");
@@ -391,23 +693,16 @@ int8_t editor_row_indent(struct EditorConfig* conf, struct Row* row,
 }
 
 int32_t editor_update_rx_cx(struct Row* row, int32_t rx) {
-    int32_t curr_rx = 0;
-    int32_t cx = 0;
+    if (rx <= 0) return 0;
 
-    for (; cx < row->size; cx++) {
-        if (row->chars[cx] == '\t') {
-            curr_rx += (TAB_SIZE - 1) - (curr_rx % TAB_SIZE);
-        }
-
-        curr_rx++;
-
-        if (curr_rx > rx) return cx;
-    }
+    int32_t k = editor_glyphs_before_rx(row, rx);
+    struct RowGlyph* glyph = k ? &row->glyphs[k - 1] : NULL;
+    int32_t cx = glyph ? glyph->cx + glyph->len +
+                             (rx - glyph->rx - glyph->width)
+                       : rx;
 
-    return cx;
-}
+    // rx landed inside the next tab or wide character
+    if (k < row->nglyphs && cx >= row->glyphs[k].cx) cx = row->glyphs[k].cx;
 
-// numline has a variable length so we need a respective function for it
-int32_t editor_row_numline_calculate(const struct Row* row) {
-    return count_digits(row->idx + 1) + 1;
+    return cx > row->size ? row->size : cx;
 }
@@ -1,5 +1,7 @@
 #include "terminal.h"
 
+#include <errno.h>
+#include <poll.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -11,20 +13,26 @@
 #include "config.h"
 #include "core.h"
 #include "file.h"
+#include "views.h"
 
 // Any needed info can be found on termios.h
 // TCSAFLUSH: flushes before leaving the program
 
 struct termios orig_termios;
 
+static const struct TermBackend* term_backend = &term_tty;
+
 static void term_size_flag_update(int32_t sig) {
     (void)sig;
     if (g_conf) g_conf->flags.resize_needed = 1;
 }
 
-static void cleanup(void) {
-    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &orig_termios) == -1)
+static void term_tty_destroy(void) {
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &orig_termios) == -1) {
+        // the terminal hung up, there is nothing left to restore
+        if (errno == EIO) return;
         die("tcsetattr");
+    }
 
 #if SCROLL_DISABLE
     // Show terminal scrollbar
@@ -33,6 +41,11 @@ static void cleanup(void) {
 
 #endif
 
+#if BRACKETED_PASTE
+    if (write(STDOUT_FILENO, "\x1b[?2004l", 8) == -1)
+        die("couldn't disable bracketed paste");
+#endif
+
 #if MOUSE_REPORTING
     if (write(STDOUT_FILENO, "\x1b[?1000l", 9) <= 0)
         die("couldn't disable mouse click");  // Disable mouse click
@@ -44,8 +57,8 @@ static void cleanup(void) {
 #endif
 }
 
-void term_create(void) {
-    atexit(cleanup);
+static int8_t term_tty_create(void) {
+    atexit(term_tty_destroy);
 
     struct termios raw;
     if (tcgetattr(STDIN_FILENO, &orig_termios) == -1) die("tcgetattr");
@@ -55,8 +68,9 @@ void term_create(void) {
     raw.c_oflag &= ~(OPOST);
     raw.c_cflag |= (CS8);
     raw.c_lflag &= ~(ECHO | ICANON | ISIG | IEXTEN);
+    // reads never wait on their own, blocking is left to poll()
     raw.c_cc[VMIN] = 0;
-    raw.c_cc[VTIME] = 1;
+    raw.c_cc[VTIME] = 0;
 
     if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) == -1) {
         die("tcsetattr");
@@ -69,6 +83,13 @@ void term_create(void) {
     }
 #endif
 
+#if BRACKETED_PASTE
+    // pasted text gets wrapped between <esc>[200~ and <esc>[201~
+    if (write(STDOUT_FILENO, "\x1b[?2004h", 8) < 0) {
+        die("couldn't enable bracketed paste");
+    }
+#endif
+
     // signal(interrupt) handling
     struct sigaction sa;
     sa.sa_handler = term_size_flag_update;
@@ -98,15 +119,10 @@ void term_create(void) {
     }  // Enable mouse click tracking
     // Enable SGR (1006) mode for xterm
 #endif
+    return EXIT_SUCCESS;
 }
 
-void term_exit(int32_t sig __attribute__((unused))) {
-    cleanup();
-    exit(EXIT_SUCCESS);
-}
-
-int8_t term_get_window_size(struct EditorConfig* conf, int32_t* rows,
-                            int32_t* cols) {
+static int8_t term_tty_get_size(int32_t* rows, int32_t* cols) {
     struct winsize ws;
     if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == -1 || ws.ws_col == 0) {
         // idea:
@@ -120,12 +136,57 @@ int8_t term_get_window_size(struct EditorConfig* conf, int32_t* rows,
         if (write(STDOUT_FILENO, "\x1b[999C\x1b[999B", 12) != 12) return -1;
         return term_get_cursor_position(rows, cols);
     } else {
-        conf->screen_cols = ws.ws_col;
-        conf->screen_rows = ws.ws_row;
+        *cols = ws.ws_col;
+        *rows = ws.ws_row;
         return EXIT_SUCCESS;
     }
 }
 
+static int32_t term_tty_write(const char* buf, int32_t len) {
+    return write(STDOUT_FILENO, buf, len);
+}
+
+const struct TermBackend term_tty = {"tty", term_tty_create,
+                                     term_tty_destroy, term_tty_get_size,
+                                     term_tty_write};
+
+int8_t term_set_backend(const struct TermBackend* backend) {
+    if (!backend) return EXIT_FAILURE;
+    term_backend = backend;
+    return EXIT_SUCCESS;
+}
+
+const struct TermBackend* term_get_backend(void) { return term_backend; }
+
+void term_create(void) {
+    if (term_backend->create() != EXIT_SUCCESS)
+        die("couldn't set the terminal up");
+}
+
+void term_exit(int32_t sig __attribute__((unused))) {
+    term_backend->destroy();
+    exit(EXIT_SUCCESS);
+}
+
+int8_t term_get_window_size(struct EditorConfig* conf __attribute__((unused)),
+                            int32_t* rows, int32_t* cols) {
+    return term_backend->get_size(rows, cols);
+}
+
+int32_t term_write(const char* buf, int32_t len) {
+    return term_backend->write(buf, len);
+}
+
+int8_t term_resize(struct EditorConfig* conf) {
+    conf->flags.resize_needed = 0;
+    int32_t rows, cols;
+    if (term_get_window_size(conf, &rows, &cols) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    // one row for the message bar, each view draws its own status bar
+    return views_layout(conf, rows - 1, cols);
+}
+
 int8_t term_get_cursor_position(int32_t* rows, int32_t* cols) {
     size_t i = 0;
     char buf[32];
@@ -134,7 +195,9 @@ int8_t term_get_cursor_position(int32_t* rows, int32_t* cols) {
     if (write(STDOUT_FILENO, "\x1b[6n", 4) != 4) return -1;
 
     // result example: <esc>[rows;colsR
+    struct pollfd pfd = {STDIN_FILENO, POLLIN, 0};
     while (i < sizeof(buf) - 1) {
+        if (poll(&pfd, 1, 100) != 1) break;
         if (read(STDIN_FILENO, &buf[i], 1) != 1) break;
         if (buf[i] == 'R') break;
         i++;
@@ -144,4 +207,4 @@ int8_t term_get_cursor_position(int32_t* rows, int32_t* cols) {
     if (sscanf(&buf[2], "%d;%d", rows, cols) != 2) return -1;
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -0,0 +1,114 @@
+#include "utf8.h"
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+int8_t utf8_is_ascii(const char* s, int32_t len) {
+    int32_t i = 0;
+
+#if defined(__SSE2__)
+    // movemask gathers the high bit of every byte
+    for (; i + 16 <= len; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(s + i));
+        if (_mm_movemask_epi8(chunk)) return 0;
+    }
+#endif
+
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        memcpy(&word, s + i, sizeof(word));
+        if (word & 0x8080808080808080ULL) return 0;
+    }
+    for (; i < len; i++) {
+        if ((unsigned char)s[i] >= 0x80) return 0;
+    }
+    return 1;
+}
+
+int32_t utf8_decode(const char* s, int32_t len, uint32_t* cp) {
+    const unsigned char* u = (const unsigned char*)s;
+    if (len <= 0) return 0;
+
+    if (u[0] < 0x80) {
+        *cp = u[0];
+        return 1;
+    }
+
+    int32_t n;
+    uint32_t value;
+    uint8_t lo = 0x80, hi = 0xBF;  // range of the second byte
+    if (u[0] >= 0xC2 && u[0] <= 0xDF) {
+        n = 2;
+        value = u[0] & 0x1F;
+    } else if (u[0] >= 0xE0 && u[0] <= 0xEF) {
+        n = 3;
+        value = u[0] & 0x0F;
+        if (u[0] == 0xE0) lo = 0xA0;  // overlong
+        if (u[0] == 0xED) hi = 0x9F;  // surrogates
+    } else if (u[0] >= 0xF0 && u[0] <= 0xF4) {
+        n = 4;
+        value = u[0] & 0x07;
+        if (u[0] == 0xF0) lo = 0x90;  // overlong
+        if (u[0] == 0xF4) hi = 0x8F;  // past U+10FFFF
+    } else {
+        return 0;
+    }
+
+    if (len < n || u[1] < lo || u[1] > hi) return 0;
+    for (int32_t i = 1; i < n; i++) {
+        if (!utf8_is_continuation(s[i])) return 0;
+        value = (value << 6) | (u[i] & 0x3F);
+    }
+
+    *cp = value;
+    return n;
+}
+
+struct Utf8Range {
+    uint32_t first;
+    uint32_t last;
+};
+
+static const struct Utf8Range utf8_zero_width[] = {
+    {0x0300, 0x036F}, {0x0483, 0x0489}, {0x0591, 0x05BD}, {0x0610, 0x061A},
+    {0x064B, 0x065F}, {0x0E31, 0x0E31}, {0x0E34, 0x0E3A}, {0x0E47, 0x0E4E},
+    {0x1AB0, 0x1AFF}, {0x1DC0, 0x1DFF}, {0x200B, 0x200F}, {0x202A, 0x202E},
+    {0x2060, 0x2064}, {0x20D0, 0x20FF}, {0xFE00, 0xFE0F}, {0xFE20, 0xFE2F},
+    {0xFEFF, 0xFEFF}, {0xE0100, 0xE01EF},
+};
+
+static const struct Utf8Range utf8_wide[] = {
+    {0x1100, 0x115F},   {0x231A, 0x231B},   {0x2329, 0x232A},
+    {0x23E9, 0x23EC},   {0x2E80, 0x303E},   {0x3041, 0x33FF},
+    {0x3400, 0x4DBF},   {0x4E00, 0x9FFF},   {0xA000, 0xA4CF},
+    {0xAC00, 0xD7A3},   {0xF900, 0xFAFF},   {0xFE30, 0xFE4F},
+    {0xFF00, 0xFF60},   {0xFFE0, 0xFFE6},   {0x1F300, 0x1F64F},
+    {0x1F900, 0x1F9FF}, {0x20000, 0x2FFFD}, {0x30000, 0x3FFFD},
+};
+
+static int8_t utf8_in(const struct Utf8Range* ranges, int32_t count,
+                      uint32_t cp) {
+    int32_t lo = 0, hi = count;
+    while (lo < hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if (ranges[mid].last < cp)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo < count && ranges[lo].first <= cp;
+}
+
+int32_t utf8_width(uint32_t cp) {
+    if (cp < 0x300) return 1;
+
+    if (utf8_in(utf8_zero_width,
+                sizeof(utf8_zero_width) / sizeof(utf8_zero_width[0]), cp))
+        return 0;
+    if (utf8_in(utf8_wide, sizeof(utf8_wide) / sizeof(utf8_wide[0]), cp))
+        return 2;
+    return 1;
+}
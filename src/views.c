@@ -0,0 +1,310 @@
+#include "views.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "buffer.h"
+#include "buflist.h"
+#include "config.h"
+#include "core.h"
+#include "gutter.h"
+#include "input.h"
+#include "render.h"
+#include "rows.h"
+
+static void view_stash(struct EditorConfig* conf, struct EditorView* view) {
+    view->buffer = conf->buffers.current;
+
+    view->cx = conf->cx;
+    view->cy = conf->cy;
+    view->rx = conf->rx;
+    view->rowoff = conf->rowoff;
+    view->coloff = conf->coloff;
+    view->sel = conf->sel;
+}
+
+static void view_load(struct EditorConfig* conf,
+                      const struct EditorView* view) {
+    buflist_select(conf, view->buffer);
+
+    conf->cx = view->cx;
+    conf->cy = view->cy;
+    conf->rx = view->rx;
+    conf->rowoff = view->rowoff;
+    conf->coloff = view->coloff;
+    conf->sel = view->sel;
+
+    // another view on the same buffer may have removed rows since
+    if (conf->cy > conf->numrows) conf->cy = conf->numrows;
+    if (conf->cy < conf->numrows)
+        conf->cx = min(conf->cx, conf->rows[conf->cy].size);
+    else
+        conf->cx = 0;
+
+    conf->screen_top = view->top;
+    conf->screen_left = view->left;
+    conf->screen_rows = max(view->height - 1, 0);  // minus the status bar
+    conf->screen_cols = view->width;
+}
+
+static int32_t views_node_add(struct EditorViews* views, int8_t kind) {
+    int32_t id = 0;
+    while (id < views->nnodes && views->nodes[id].kind != VIEW_NODE_FREE)
+        id++;
+
+    if (id == views->nnodes) {
+        views->nodes =
+            realloc(views->nodes, sizeof(struct ViewNode) * (id + 1));
+        if (!views->nodes) die("view nodes realloc failed");
+        views->nnodes++;
+    }
+
+    memset(&views->nodes[id], 0, sizeof(struct ViewNode));
+    views->nodes[id].kind = kind;
+    views->nodes[id].parent = -1;
+    views->nodes[id].view = -1;
+
+    return id;
+}
+
+static void views_reserve(struct EditorViews* views) {
+    if (views->count < views->cap) return;
+
+    views->cap = views->cap ? views->cap * 2 : 4;
+    views->items =
+        realloc(views->items, sizeof(struct EditorView) * views->cap);
+    if (!views->items) die("views realloc failed");
+}
+
+static void views_layout_node(struct EditorViews* views, int32_t id,
+                              int32_t top, int32_t left, int32_t height,
+                              int32_t width) {
+    struct ViewNode* node = &views->nodes[id];
+    node->top = top;
+    node->left = left;
+    node->height = height;
+    node->width = width;
+
+    if (node->kind == VIEW_NODE_LEAF) {
+        struct EditorView* view = &views->items[node->view];
+        view->top = top;
+        view->left = left;
+        view->height = height;
+        view->width = width;
+        return;
+    }
+
+    if (node->kind == VIEW_NODE_HSPLIT) {
+        int32_t first = height / 2;
+        views_layout_node(views, node->child[0], top, left, first, width);
+        views_layout_node(views, node->child[1], top + first, left,
+                          height - first, width);
+    } else {
+        int32_t first = (width - 1) / 2;
+        views_layout_node(views, node->child[0], top, left, height, first);
+        views_layout_node(views, node->child[1], top, left + first + 1, height,
+                          width - first - 1);
+    }
+}
+
+int8_t views_create(struct EditorConfig* conf, int32_t rows, int32_t cols) {
+    struct EditorViews* views = &conf->views;
+    views->items = NULL;
+    views->nodes = NULL;
+    views->count = 0;
+    views->cap = 0;
+    views->nnodes = 0;
+
+    views_reserve(views);
+    views->root = views_node_add(views, VIEW_NODE_LEAF);
+    views->nodes[views->root].view = 0;
+    views->count = 1;
+    views->current = 0;
+
+    views->items[0].node = views->root;
+    view_stash(conf, &views->items[0]);
+
+    return views_layout(conf, rows, cols);
+}
+
+int8_t views_destroy(struct EditorConfig* conf) {
+    struct EditorViews* views = &conf->views;
+
+    free(views->items);
+    free(views->nodes);
+    views->items = NULL;
+    views->nodes = NULL;
+    views->count = 0;
+    views->cap = 0;
+    views->nnodes = 0;
+
+    return EXIT_SUCCESS;
+}
+
+int8_t views_layout(struct EditorConfig* conf, int32_t rows, int32_t cols) {
+    struct EditorViews* views = &conf->views;
+    views->rows = rows;
+    views->cols = cols;
+
+    struct EditorView* current = &views->items[views->current];
+    view_stash(conf, current);
+    views_layout_node(views, views->root, 0, 0, rows, cols);
+    view_load(conf, current);
+
+    return EXIT_SUCCESS;
+}
+
+int8_t views_split(struct EditorConfig* conf, int8_t kind) {
+    struct EditorViews* views = &conf->views;
+    struct EditorView* current = &views->items[views->current];
+
+    // both halves need at least one text row plus their status bar
+    if ((kind == VIEW_NODE_HSPLIT && current->height < 4) ||
+        (kind == VIEW_NODE_VSPLIT && current->width < 3)) {
+        editor_set_status_message(conf, "not enough room to split");
+        return EXIT_FAILURE;
+    }
+
+    view_stash(conf, current);
+    views_reserve(views);
+    current = &views->items[views->current];
+
+    int32_t leaf = current->node;
+    int32_t split = views_node_add(views, kind);
+    int32_t added = views_node_add(views, VIEW_NODE_LEAF);
+    struct ViewNode* nodes = views->nodes;
+
+    // the split node takes the place of the old leaf in the tree
+    int32_t parent = nodes[leaf].parent;
+    nodes[split].parent = parent;
+    if (parent == -1)
+        views->root = split;
+    else
+        nodes[parent].child[nodes[parent].child[1] == leaf] = split;
+
+    nodes[split].child[0] = leaf;
+    nodes[split].child[1] = added;
+    nodes[leaf].parent = split;
+    nodes[added].parent = split;
+    nodes[added].view = views->count;
+
+    struct EditorView* view = &views->items[views->count++];
+    *view = *current;
+    view->node = added;
+
+    views->current = views->count - 1;
+    return views_layout(conf, views->rows, views->cols);
+}
+
+int8_t views_close(struct EditorConfig* conf) {
+    struct EditorViews* views = &conf->views;
+    if (views->count == 1) {
+        editor_set_status_message(conf, "can't close the last view");
+        return EXIT_FAILURE;
+    }
+
+    struct ViewNode* nodes = views->nodes;
+    int32_t closed = views->current;
+    int32_t leaf = views->items[closed].node;
+    int32_t split = nodes[leaf].parent;
+    int32_t sibling = nodes[split].child[nodes[split].child[0] == leaf];
+
+    // the sibling subtree takes over the space of the split
+    int32_t parent = nodes[split].parent;
+    nodes[sibling].parent = parent;
+    if (parent == -1)
+        views->root = sibling;
+    else
+        nodes[parent].child[nodes[parent].child[1] == split] = sibling;
+    nodes[leaf].kind = VIEW_NODE_FREE;
+    nodes[split].kind = VIEW_NODE_FREE;
+
+    // last view moves into the freed slot
+    views->count--;
+    if (closed != views->count) {
+        views->items[closed] = views->items[views->count];
+        nodes[views->items[closed].node].view = closed;
+    }
+
+    // focus whichever view now covers the sibling's top left corner
+    while (nodes[sibling].kind != VIEW_NODE_LEAF)
+        sibling = nodes[sibling].child[0];
+    views->current = nodes[sibling].view;
+    view_load(conf, &views->items[views->current]);
+
+    return views_layout(conf, views->rows, views->cols);
+}
+
+int8_t views_cycle(struct EditorConfig* conf, int32_t direction) {
+    struct EditorViews* views = &conf->views;
+    if (views->count < 2) return EXIT_FAILURE;
+
+    view_stash(conf, &views->items[views->current]);
+    views->current =
+        (views->current + direction + views->count) % views->count;
+    view_load(conf, &views->items[views->current]);
+
+    return EXIT_SUCCESS;
+}
+
+int8_t views_buffer_closed(struct EditorConfig* conf, int32_t index) {
+    struct EditorViews* views = &conf->views;
+
+    for (int32_t i = 0; i < views->count; i++) {
+        struct EditorView* view = &views->items[i];
+        if (view->buffer == index) {
+            view->buffer = conf->buffers.current;
+            view->cx = view->cy = view->rx = 0;
+            view->rowoff = view->coloff = 0;
+            view->sel.active = 0;
+            view->sel.start_row = view->sel.end_row = -1;
+            view->sel.start_col = view->sel.end_col = -1;
+        } else if (view->buffer > index) {
+            view->buffer--;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static void views_draw_separators(struct EditorViews* views, struct ABuf* ab) {
+    for (int32_t i = 0; i < views->nnodes; i++) {
+        struct ViewNode* node = &views->nodes[i];
+        if (node->kind != VIEW_NODE_VSPLIT) continue;
+
+        int32_t col = node->left + (node->width - 1) / 2 + 1;
+        for (int32_t y = 0; y < node->height; y++) {
+            char buf[32];
+            int32_t len = snprintf(buf, sizeof(buf), "\x1b[%d;%dH|",
+                                   node->top + y + 1, col);
+            ab_append(ab, buf, len);
+        }
+    }
+}
+
+int8_t views_draw(struct EditorConfig* conf, struct ABuf* ab) {
+    struct EditorViews* views = &conf->views;
+    view_stash(conf, &views->items[views->current]);
+
+    for (int32_t i = 0; i < views->count; i++) {
+        struct EditorView* view = &views->items[i];
+        if (view->height < 2 || view->width < 1) continue;
+
+        view_load(conf, view);
+        gutter_update(conf);
+        editor_scroll(conf);
+
+        editor_draw_rows(conf, ab);
+        editor_draw_statusbar(conf, ab, i == views->current);
+
+        view_stash(conf, view);
+    }
+
+    views_draw_separators(views, ab);
+
+    view_load(conf, &views->items[views->current]);
+    gutter_update(conf);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,432 @@
+#include "vterm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "utf8.h"
+
+#define VTERM_TAB_STOP 8
+#define VTERM_REPLACEMENT 0xFFFD
+
+enum VTermState { VTERM_GROUND = 0, VTERM_ESCAPE, VTERM_CSI };
+
+static struct VTerm {
+    int32_t rows, cols;
+    struct VTermCell* cells;
+
+    int32_t cy, cx;        // 0 based cursor
+    int8_t pending_wrap;   // the last column was printed to, wrap on the next
+    int8_t cursor_shown;
+    uint8_t fg, attrs;     // pen the next glyph is printed with
+
+    int8_t state;
+    char seq[VTERM_SEQ_MAX];  // parameters and intermediates of a CSI
+    int32_t seq_len;
+    char utf8[UTF8_MAX_BYTES];  // a multibyte glyph split across writes
+    int32_t utf8_len, utf8_need;
+
+    struct VTermStats stats;
+} vterm;
+
+static struct VTermCell* vterm_at(int32_t row, int32_t col) {
+    return &vterm.cells[row * vterm.cols + col];
+}
+
+static void vterm_blank(int32_t row, int32_t from, int32_t to) {
+    if (from < 0) from = 0;
+    if (to > vterm.cols) to = vterm.cols;
+    // erased cells drop the pen, the editor only erases with the default one
+    for (int32_t col = from; col < to; col++)
+        *vterm_at(row, col) = (struct VTermCell){' ', 0, 0};
+}
+
+static void vterm_line_feed(void) {
+    if (vterm.cy < vterm.rows - 1) {
+        vterm.cy++;
+        return;
+    }
+
+    memmove(vterm.cells, vterm_at(1, 0),
+            sizeof(struct VTermCell) * (vterm.rows - 1) * vterm.cols);
+    vterm_blank(vterm.rows - 1, 0, vterm.cols);
+}
+
+static void vterm_move(int32_t row, int32_t col) {
+    vterm.cy = row < 0 ? 0 : row >= vterm.rows ? vterm.rows - 1 : row;
+    vterm.cx = col < 0 ? 0 : col >= vterm.cols ? vterm.cols - 1 : col;
+    vterm.pending_wrap = 0;
+}
+
+static void vterm_print(uint32_t cp) {
+    int32_t width = utf8_width(cp);
+    // combining marks would need cells holding more than one code point
+    if (width == 0) return;
+
+    if (vterm.pending_wrap || vterm.cx + width > vterm.cols) {
+        vterm.cx = 0;
+        vterm.pending_wrap = 0;
+        vterm_line_feed();
+    }
+
+    *vterm_at(vterm.cy, vterm.cx) = (struct VTermCell){cp, vterm.fg,
+                                                       vterm.attrs};
+    if (width == 2)
+        *vterm_at(vterm.cy, vterm.cx + 1) =
+            (struct VTermCell){0, vterm.fg, vterm.attrs};
+    vterm.stats.glyphs++;
+
+    if (vterm.cx + width == vterm.cols)
+        vterm.pending_wrap = 1;
+    else
+        vterm.cx += width;
+}
+
+static void vterm_control(char c) {
+    switch (c) {
+        case '\r':
+            vterm.cx = 0;
+            vterm.pending_wrap = 0;
+            break;
+        case '\n':
+            vterm_line_feed();
+            break;
+        case '\b':
+            if (vterm.cx > 0) vterm.cx--;
+            vterm.pending_wrap = 0;
+            break;
+        case '\t':
+            vterm_move(vterm.cy, (vterm.cx / VTERM_TAB_STOP + 1) *
+                                     VTERM_TAB_STOP);
+            break;
+        default:
+            break;
+    }
+}
+
+static void vterm_sgr(const int32_t* params, int32_t count) {
+    if (count == 0) {
+        vterm.fg = 0;
+        vterm.attrs = 0;
+        return;
+    }
+
+    for (int32_t i = 0; i < count; i++) {
+        int32_t p = params[i] < 0 ? 0 : params[i];
+        if (p == 0) {
+            vterm.fg = 0;
+            vterm.attrs = 0;
+        } else if (p == 1) {
+            vterm.attrs |= VTERM_ATTR_BOLD;
+        } else if (p == 2) {
+            vterm.attrs |= VTERM_ATTR_DIM;
+        } else if (p == 22) {
+            vterm.attrs &= ~(VTERM_ATTR_BOLD | VTERM_ATTR_DIM);
+        } else if (p == 7) {
+            vterm.attrs |= VTERM_ATTR_REVERSE;
+        } else if (p == 27) {
+            vterm.attrs &= ~VTERM_ATTR_REVERSE;
+        } else if ((p >= 30 && p <= 37) || (p >= 90 && p <= 97)) {
+            vterm.fg = p;
+        } else if (p == 39) {
+            vterm.fg = 0;
+        } else {
+            vterm.stats.unknown++;
+        }
+    }
+}
+
+// private modes, <esc>[?25h and <esc>[?25l are the only ones that show
+static void vterm_mode(const int32_t* params, int32_t count, int8_t set) {
+    for (int32_t i = 0; i < count; i++) {
+        switch (params[i]) {
+            case 25:
+                vterm.cursor_shown = set;
+                break;
+            case 1000:
+            case 1006:
+            case 1049:
+            case 2004:
+                break;
+            default:
+                vterm.stats.unknown++;
+        }
+    }
+}
+
+// seq holds what came between <esc>[ and the final byte
+static void vterm_csi(char final) {
+    int32_t params[16];
+    int32_t count = 0;
+    int8_t private = 0;
+    char intermediate = 0;
+
+    int32_t i = 0;
+    if (vterm.seq_len > 0 && vterm.seq[0] == '?') {
+        private = 1;
+        i++;
+    }
+
+    // ;-separated decimals, a missing one is left as -1 for its default
+    int32_t value = -1;
+    for (; i < vterm.seq_len; i++) {
+        char c = vterm.seq[i];
+        if (c >= '0' && c <= '9') {
+            value = (value == -1 ? 0 : value * 10) + (c - '0');
+        } else if (c == ';') {
+            if (count < 16) params[count++] = value;
+            value = -1;
+        } else if (c >= 0x20 && c <= 0x2F) {
+            intermediate = c;
+        }
+    }
+    if ((value != -1 || count > 0) && count < 16) params[count++] = value;
+
+#define VTERM_PARAM(n, def) \
+    ((n) < count && params[(n)] > 0 ? params[(n)] : (def))
+
+    vterm.stats.sequences++;
+    if (private) {
+        if (final == 'h' || final == 'l')
+            vterm_mode(params, count, final == 'h');
+        else
+            vterm.stats.unknown++;
+        return;
+    }
+    // <esc>[<n> q sets the cursor shape
+    if (intermediate == ' ' && final == 'q') return;
+
+    switch (final) {
+        case 'H':
+        case 'f':
+            vterm_move(VTERM_PARAM(0, 1) - 1, VTERM_PARAM(1, 1) - 1);
+            break;
+        case 'A':
+            vterm_move(vterm.cy - VTERM_PARAM(0, 1), vterm.cx);
+            break;
+        case 'B':
+            vterm_move(vterm.cy + VTERM_PARAM(0, 1), vterm.cx);
+            break;
+        case 'C':
+            vterm_move(vterm.cy, vterm.cx + VTERM_PARAM(0, 1));
+            break;
+        case 'D':
+            vterm_move(vterm.cy, vterm.cx - VTERM_PARAM(0, 1));
+            break;
+        case 'K': {
+            int32_t mode = count ? params[0] : 0;
+            if (mode <= 0)
+                vterm_blank(vterm.cy, vterm.cx, vterm.cols);
+            else if (mode == 1)
+                vterm_blank(vterm.cy, 0, vterm.cx + 1);
+            else
+                vterm_blank(vterm.cy, 0, vterm.cols);
+            break;
+        }
+        case 'J': {
+            int32_t mode = count ? params[0] : 0;
+            int32_t from = mode <= 0 ? vterm.cy + 1 : 0;
+            int32_t to = mode == 1 ? vterm.cy : vterm.rows;
+            if (mode <= 0) vterm_blank(vterm.cy, vterm.cx, vterm.cols);
+            if (mode == 1) vterm_blank(vterm.cy, 0, vterm.cx + 1);
+            for (int32_t row = from; row < to; row++)
+                vterm_blank(row, 0, vterm.cols);
+            break;
+        }
+        case 'X':
+            vterm_blank(vterm.cy, vterm.cx, vterm.cx + VTERM_PARAM(0, 1));
+            break;
+        case 'm':
+            vterm_sgr(params, count);
+            break;
+        case 'n':  // status reports, nobody reads the answer
+            break;
+        default:
+            vterm.stats.unknown++;
+    }
+#undef VTERM_PARAM
+}
+
+// bytes a UTF-8 sequence takes going by its lead byte, 0 for an invalid one
+static int32_t vterm_utf8_need(unsigned char c) {
+    if (c >= 0xC2 && c <= 0xDF) return 2;
+    if (c >= 0xE0 && c <= 0xEF) return 3;
+    if (c >= 0xF0 && c <= 0xF4) return 4;
+    return 0;
+}
+
+static void vterm_byte(unsigned char c) {
+    switch (vterm.state) {
+        case VTERM_ESCAPE:
+            if (c == '[') {
+                vterm.state = VTERM_CSI;
+                vterm.seq_len = 0;
+            } else {
+                // two byte escapes, none of them are sent by the editor
+                vterm.state = VTERM_GROUND;
+                vterm.stats.sequences++;
+                vterm.stats.unknown++;
+            }
+            return;
+        case VTERM_CSI:
+            if (c >= 0x40 && c <= 0x7E) {
+                vterm.state = VTERM_GROUND;
+                vterm_csi(c);
+            } else if (vterm.seq_len < VTERM_SEQ_MAX) {
+                vterm.seq[vterm.seq_len++] = c;
+            }
+            return;
+        default:
+            break;
+    }
+
+    if (vterm.utf8_need) {
+        if (utf8_is_continuation(c)) {
+            vterm.utf8[vterm.utf8_len++] = c;
+            if (vterm.utf8_len < vterm.utf8_need) return;
+
+            uint32_t cp;
+            if (utf8_decode(vterm.utf8, vterm.utf8_len, &cp) == 0)
+                cp = VTERM_REPLACEMENT;
+            vterm.utf8_need = 0;
+            vterm_print(cp);
+            return;
+        }
+        // cut short, the byte that interrupted it still counts
+        vterm.utf8_need = 0;
+        vterm_print(VTERM_REPLACEMENT);
+    }
+
+    if (c == '\x1b') {
+        vterm.state = VTERM_ESCAPE;
+    } else if (c < 0x20 || c == 0x7F) {
+        vterm_control(c);
+    } else if (c < 0x80) {
+        vterm_print(c);
+    } else if ((vterm.utf8_need = vterm_utf8_need(c))) {
+        vterm.utf8[0] = c;
+        vterm.utf8_len = 1;
+    } else {
+        vterm_print(VTERM_REPLACEMENT);
+    }
+}
+
+int32_t vterm_write(const char* buf, int32_t len) {
+    if (!vterm.cells) return -1;
+
+    vterm.stats.bytes += len;
+    for (int32_t i = 0; i < len; i++) vterm_byte(buf[i]);
+    return len;
+}
+
+int8_t vterm_create(int32_t rows, int32_t cols) {
+    if (rows < 2 || cols < 1) return EXIT_FAILURE;
+
+    vterm_destroy();
+    vterm.cells = malloc(sizeof(struct VTermCell) * rows * cols);
+    if (!vterm.cells) return EXIT_FAILURE;
+
+    vterm.rows = rows;
+    vterm.cols = cols;
+    vterm.cursor_shown = 1;
+    for (int32_t row = 0; row < rows; row++) vterm_blank(row, 0, cols);
+    return EXIT_SUCCESS;
+}
+
+void vterm_destroy(void) {
+    free(vterm.cells);
+    memset(&vterm, 0, sizeof(vterm));
+}
+
+const struct VTermCell* vterm_cell(int32_t row, int32_t col) {
+    if (!vterm.cells || row < 0 || row >= vterm.rows || col < 0 ||
+        col >= vterm.cols)
+        return NULL;
+    return vterm_at(row, col);
+}
+
+int8_t vterm_cursor(int32_t* row, int32_t* col) {
+    *row = vterm.cy;
+    *col = vterm.cx;
+    return vterm.cursor_shown;
+}
+
+const struct VTermStats* vterm_stats(void) { return &vterm.stats; }
+
+static int32_t vterm_utf8_encode(uint32_t cp, char* out) {
+    if (cp < 0x80) {
+        out[0] = cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = 0xC0 | (cp >> 6);
+        out[1] = 0x80 | (cp & 0x3F);
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = 0xE0 | (cp >> 12);
+        out[1] = 0x80 | ((cp >> 6) & 0x3F);
+        out[2] = 0x80 | (cp & 0x3F);
+        return 3;
+    }
+    out[0] = 0xF0 | (cp >> 18);
+    out[1] = 0x80 | ((cp >> 12) & 0x3F);
+    out[2] = 0x80 | ((cp >> 6) & 0x3F);
+    out[3] = 0x80 | (cp & 0x3F);
+    return 4;
+}
+
+int32_t vterm_row_text(int32_t row, char* buf, int32_t cap) {
+    int32_t len = 0, end = 0;
+    if (cap <= 0) return 0;
+
+    for (int32_t col = 0; row >= 0 && row < vterm.rows && col < vterm.cols;
+         col++) {
+        uint32_t cp = vterm_at(row, col)->cp;
+        if (cp == 0) continue;
+
+        char bytes[UTF8_MAX_BYTES];
+        int32_t n = vterm_utf8_encode(cp, bytes);
+        if (len + n >= cap) break;
+        memcpy(&buf[len], bytes, n);
+        len += n;
+        if (cp != ' ') end = len;
+    }
+
+    buf[end] = '\0';
+    return end;
+}
+
+int8_t vterm_dump(const char* path) {
+    FILE* fp = fopen(path, "w");
+    if (!fp) return EXIT_FAILURE;
+
+    int32_t cap = vterm.cols * UTF8_MAX_BYTES + 1;
+    char* line = malloc(cap);
+    if (!line) die("vterm dump malloc failed");
+
+    for (int32_t row = 0; row < vterm.rows; row++) {
+        vterm_row_text(row, line, cap);
+        fprintf(fp, "%s\n", line);
+    }
+
+    free(line);
+    fclose(fp);
+    return EXIT_SUCCESS;
+}
+
+static int8_t vterm_backend_create(void) {
+    return vterm.cells ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int8_t vterm_get_size(int32_t* rows, int32_t* cols) {
+    if (!vterm.cells) return EXIT_FAILURE;
+    *rows = vterm.rows;
+    *cols = vterm.cols;
+    return EXIT_SUCCESS;
+}
+
+const struct TermBackend term_vterm = {"vterm", vterm_backend_create,
+                                       vterm_destroy, vterm_get_size,
+                                       vterm_write};
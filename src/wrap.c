@@ -0,0 +1,295 @@
+#include "wrap.h"
+
+#include <stdlib.h>
+
+#include "arena.h"
+#include "config.h"
+#include "core.h"
+#include "folds.h"
+#include "gutter.h"
+#include "rows.h"
+#include "utf8.h"
+
+static int32_t wrap_text_width(const struct EditorConfig* conf) {
+    return max(gutter_text_cols(conf), 1);
+}
+
+/*
+    screen column the segment starting at pos ends at, -1 once the rest of
+    the row fits. A row is split while what is left fills the whole width,
+    so the cursor always has a free column after the last char. Breaks never
+    cut a wide character in half
+*/
+static int32_t wrap_next(struct Row* row, int32_t pos, int32_t width) {
+    if (row->rwidth - pos < width) return -1;
+
+    int32_t i = editor_row_rx_ri(row, pos);
+    int32_t col = pos, space = -1;
+    while (i < row->rsize) {
+        int32_t len = 1, w = 1;
+        uint32_t cp;
+        if ((unsigned char)row->render[i] >= 0x80 &&
+            (len = utf8_decode(&row->render[i], row->rsize - i, &cp)))
+            w = utf8_width(cp);
+        else
+            len = 1;
+
+        // a character wider than the view still has to go somewhere
+        if (col + w > pos + width && col > pos) break;
+
+        col += w;
+        i += len;
+        if (row->render[i - len] == ' ') space = col;
+    }
+    return space != -1 ? space : col;
+}
+
+// breaks[i] is the render column segment i + 1 starts at
+static int32_t wrap_row_lines(struct EditorConfig* conf, struct Row* row,
+                              int32_t width) {
+    if (row->wrap_width == width) return row->nbreaks + 1;
+
+    row->wrap_width = width;
+    row->nbreaks = 0;
+    if (row->rwidth < width) return 1;
+
+    int32_t n = 0;
+    for (int32_t pos = 0; (pos = wrap_next(row, pos, width)) != -1;) n++;
+
+    row->breaks = arena_realloc(conf->arena, row->breaks, sizeof(int32_t) * n);
+    for (int32_t pos = 0; (pos = wrap_next(row, pos, width)) != -1;)
+        row->breaks[row->nbreaks++] = pos;
+
+    return n + 1;
+}
+
+static void wrap_add(struct WrapIndex* wrap, int32_t row, int32_t delta) {
+    for (int32_t k = row + 1; k <= wrap->count; k += k & -k)
+        wrap->tree[k] += delta;
+}
+
+// visual lines taken by rows [0, row)
+static int32_t wrap_prefix(const struct WrapIndex* wrap, int32_t row) {
+    int32_t sum = 0;
+    for (int32_t k = row; k > 0; k -= k & -k) sum += wrap->tree[k];
+    return sum;
+}
+
+static void wrap_reserve(struct WrapIndex* wrap, int32_t count) {
+    if (count < wrap->cap) return;
+
+    while (wrap->cap <= count) wrap->cap = wrap->cap ? wrap->cap * 2 : 64;
+    wrap->tree = realloc(wrap->tree, sizeof(int32_t) * (wrap->cap + 1));
+    wrap->lines = realloc(wrap->lines, sizeof(int32_t) * wrap->cap);
+    if (!wrap->tree || !wrap->lines) die("wrap realloc failed");
+}
+
+// slot indexing width, another width is evicted when they are all taken
+static struct WrapIndex* wrap_slot(struct EditorWrap* wrap, int32_t width) {
+    for (int32_t i = 0; i < WRAP_WIDTHS; i++)
+        if (wrap->index[i].width == width) return &wrap->index[i];
+
+    for (int32_t i = 0; i < WRAP_WIDTHS; i++)
+        if (wrap->index[i].width == 0) return &wrap->index[i];
+
+    struct WrapIndex* slot = &wrap->index[wrap->next];
+    wrap->next = (wrap->next + 1) % WRAP_WIDTHS;
+    slot->valid = 0;
+    return slot;
+}
+
+// index for the width of the current view, rebuilt when rows moved
+static struct WrapIndex* wrap_sync(struct EditorConfig* conf) {
+    int32_t width = wrap_text_width(conf);
+    struct WrapIndex* wrap = wrap_slot(&conf->wrap, width);
+    if (wrap->valid && wrap->count == conf->numrows) return wrap;
+
+    wrap_reserve(wrap, conf->numrows);
+    wrap->count = conf->numrows;
+    wrap->width = width;
+
+    // folds are sorted, one pass over them marks every hidden row
+    const struct EditorFolds* folds = &conf->folds;
+    int32_t f = 0;
+    for (int32_t i = 0; i < wrap->count; i++) {
+        while (f < folds->count && folds->items[f].end < i) f++;
+        if (f < folds->count && folds->items[f].start < i)
+            wrap->lines[i] = 0;
+        else
+            wrap->lines[i] = wrap_row_lines(conf, &conf->rows[i], width);
+    }
+
+    // linear Fenwick build, each node pushes its sum to its parent
+    wrap->tree[0] = 0;
+    for (int32_t k = 1; k <= wrap->count; k++)
+        wrap->tree[k] = wrap->lines[k - 1];
+    for (int32_t k = 1; k <= wrap->count; k++) {
+        int32_t parent = k + (k & -k);
+        if (parent <= wrap->count) wrap->tree[parent] += wrap->tree[k];
+    }
+
+    wrap->valid = 1;
+    return wrap;
+}
+
+int8_t wrap_create(struct EditorConfig* conf) {
+    for (int32_t i = 0; i < WRAP_WIDTHS; i++) {
+        struct WrapIndex* wrap = &conf->wrap.index[i];
+        wrap->tree = NULL;
+        wrap->lines = NULL;
+        wrap->count = 0;
+        wrap->cap = 0;
+        wrap->width = 0;
+        wrap->valid = 0;
+    }
+    conf->wrap.next = 0;
+    return EXIT_SUCCESS;
+}
+
+int8_t wrap_destroy(struct EditorConfig* conf) {
+    for (int32_t i = 0; i < WRAP_WIDTHS; i++) {
+        free(conf->wrap.index[i].tree);
+        free(conf->wrap.index[i].lines);
+    }
+    return wrap_create(conf);
+}
+
+int8_t wrap_toggle(struct EditorConfig* conf) {
+    conf->flags.soft_wrap = !conf->flags.soft_wrap;
+
+    // coloff means the first segment shown while wrapping
+    conf->coloff = 0;
+    wrap_invalidate(conf);
+
+    return EXIT_SUCCESS;
+}
+
+void wrap_invalidate(struct EditorConfig* conf) {
+    for (int32_t i = 0; i < WRAP_WIDTHS; i++) conf->wrap.index[i].valid = 0;
+}
+
+int8_t wrap_update_row(struct EditorConfig* conf, struct Row* row) {
+    int32_t at = row - conf->rows;
+    for (int32_t i = 0; i < WRAP_WIDTHS; i++) {
+        struct WrapIndex* wrap = &conf->wrap.index[i];
+        if (!wrap->valid || at < 0 || at >= wrap->count) continue;
+
+        // folded rows stay at zero, they get wrapped when shown again
+        if (wrap->lines[at] == 0) continue;
+
+        int32_t lines = wrap_row_lines(conf, row, wrap->width);
+        if (lines != wrap->lines[at]) {
+            wrap_add(wrap, at, lines - wrap->lines[at]);
+            wrap->lines[at] = lines;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+int32_t wrap_row_segment(struct EditorConfig* conf, struct Row* row,
+                         int32_t rx) {
+    wrap_row_lines(conf, row, wrap_text_width(conf));
+
+    // number of breaks at or before rx
+    int32_t lo = 0, hi = row->nbreaks;
+    while (lo < hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if (row->breaks[mid] <= rx)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+int32_t wrap_segment_start(struct Row* row, int32_t segment) {
+    return segment == 0 ? 0 : row->breaks[segment - 1];
+}
+
+int32_t wrap_segment_end(struct Row* row, int32_t segment) {
+    return segment == row->nbreaks ? row->rwidth : row->breaks[segment];
+}
+
+int32_t wrap_visual_line(struct EditorConfig* conf, int32_t row, int32_t rx) {
+    const struct WrapIndex* wrap = wrap_sync(conf);
+    if (row >= conf->numrows) return wrap_prefix(wrap, conf->numrows);
+
+    return wrap_prefix(wrap, row) +
+           wrap_row_segment(conf, &conf->rows[row], rx);
+}
+
+int32_t wrap_locate(struct EditorConfig* conf, int32_t line,
+                    int32_t* segment) {
+    const struct WrapIndex* wrap = wrap_sync(conf);
+    if (line < 0) line = 0;
+
+    // last row whose prefix still fits in line, folded rows add nothing so
+    // the walk steps over them
+    int32_t step = 1;
+    while (step * 2 <= wrap->count) step *= 2;
+
+    int32_t pos = 0;
+    for (; step; step /= 2) {
+        if (pos + step <= wrap->count && wrap->tree[pos + step] <= line) {
+            pos += step;
+            line -= wrap->tree[pos];
+        }
+    }
+
+    *segment = pos < wrap->count ? line : 0;
+    return pos;
+}
+
+// char at render column rx, a tab straddling the break belongs to the
+// segment it starts in so it is skipped
+static int32_t wrap_segment_cx(struct Row* row, int32_t segment, int32_t rx) {
+    int32_t cx = editor_update_rx_cx(row, rx);
+    if (cx < row->size &&
+        editor_update_cx_rx(row, cx) < wrap_segment_start(row, segment))
+        cx++;
+    return cx;
+}
+
+int32_t wrap_screen_top(struct EditorConfig* conf) {
+    return wrap_visual_line(conf, conf->rowoff, 0) + conf->coloff;
+}
+
+int8_t wrap_cursor_to_line(struct EditorConfig* conf, int32_t line) {
+    int32_t segment;
+    conf->cy = wrap_locate(conf, line, &segment);
+    if (conf->cy >= conf->numrows) {
+        conf->cx = 0;
+        return EXIT_SUCCESS;
+    }
+
+    struct Row* row = &conf->rows[conf->cy];
+    conf->cx = wrap_segment_cx(row, segment, wrap_segment_start(row, segment));
+    return EXIT_SUCCESS;
+}
+
+int8_t wrap_move(struct EditorConfig* conf, int32_t direction) {
+    struct Row* row =
+        (conf->cy >= conf->numrows) ? NULL : &conf->rows[conf->cy];
+
+    int32_t rx = row ? editor_update_cx_rx(row, conf->cx) : 0;
+    int32_t col = row ? rx - wrap_segment_start(
+                                 row, wrap_row_segment(conf, row, rx))
+                      : 0;
+
+    int32_t segment;
+    int32_t line = wrap_visual_line(conf, conf->cy, rx) + direction;
+    if (line < 0) return EXIT_FAILURE;
+    int32_t target = wrap_locate(conf, line, &segment);
+    if (target >= conf->numrows) return EXIT_FAILURE;
+
+    // the column right after a segment already belongs to the next one
+    row = &conf->rows[target];
+    int32_t end = wrap_segment_end(row, segment);
+    if (segment < row->nbreaks) end--;
+
+    conf->cy = target;
+    conf->cx = wrap_segment_cx(
+        row, segment, min(wrap_segment_start(row, segment) + col, end));
+
+    return EXIT_SUCCESS;
+}